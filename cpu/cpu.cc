@@ -21,6 +21,7 @@
 
 #include <limits>
 
+#include "sim/profile.hh"
 #include "sim/trace.hh"
 
 namespace SimpleSSD {
@@ -301,6 +302,8 @@ CPU::CPU(ConfigReader &c) : conf(c), lastResetStat(0) {
 CPU::~CPU() {}
 
 void CPU::calculatePower(Power &power) {
+  ProfileScope scope(PROFILE_CPU);
+
   // Print stats before die
   ParseXML param;
   uint64_t simCycle = (getTick() - lastResetStat) / clockPeriod;
@@ -137,6 +137,18 @@ void AbstractDRAM::resetStatValues() {
   totalPower = 0.0;
 }
 
+void AbstractDRAM::saveState(std::ostream &out) {
+  // Command history inside DRAMPower is not saved, so energy of current
+  // window restarts from restored tick
+  pushValue(out, totalEnergy);
+  pushValue(out, totalPower);
+}
+
+void AbstractDRAM::loadState(std::istream &in) {
+  popValue(in, totalEnergy);
+  popValue(in, totalPower);
+}
+
 }  // namespace DRAM
 
 }  // namespace SimpleSSD
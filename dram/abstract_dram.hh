@@ -37,7 +37,7 @@ typedef enum : uint8_t {
   SELF_REFRESH,          //!< Self refresh
 } DRAMState;
 
-class AbstractDRAM : public StatObject {
+class AbstractDRAM : public StatObject, public StateObject {
  protected:
   ConfigReader &conf;
 
@@ -67,6 +67,9 @@ class AbstractDRAM : public StatObject {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace DRAM
@@ -19,6 +19,7 @@
 
 #include "dram/simple.hh"
 
+#include "sim/profile.hh"
 #include "util/algorithm.hh"
 
 namespace SimpleSSD {
@@ -36,6 +37,8 @@ SimpleDRAM::SimpleDRAM(ConfigReader &p)
                        pStructure->channel / 8.0 / pTiming->tCK;
 
   autoRefresh = allocate([this](uint64_t now) {
+    ProfileScope scope(PROFILE_DRAM);
+
     dramPower->doCommand(Data::MemCommand::REF, 0, now / pTiming->tCK);
 
     lastDRAMAccess = MAX(lastDRAMAccess, now + pTiming->tRFC);
@@ -47,7 +50,7 @@ SimpleDRAM::SimpleDRAM(ConfigReader &p)
 }
 
 SimpleDRAM::~SimpleDRAM() {
-  // DO NOTHING
+  deallocate(autoRefresh);
 }
 
 uint64_t SimpleDRAM::updateDelay(uint64_t latency, uint64_t &tick) {
@@ -92,6 +95,8 @@ bool SimpleDRAM::isScheduling() {
 }
 
 void SimpleDRAM::read(void *, uint64_t size, uint64_t &tick) {
+  ProfileScope scope(PROFILE_DRAM);
+
   uint64_t pageCount = (size > 0) ? (size - 1) / pStructure->pageSize + 1 : 0;
   uint64_t latency =
       (uint64_t)(pageCount * (pageFetchLatency +
@@ -123,6 +128,8 @@ void SimpleDRAM::read(void *, uint64_t size, uint64_t &tick) {
 }
 
 void SimpleDRAM::write(void *, uint64_t size, uint64_t &tick) {
+  ProfileScope scope(PROFILE_DRAM);
+
   uint64_t pageCount = (size > 0) ? (size - 1) / pStructure->pageSize + 1 : 0;
   uint64_t latency =
       (uint64_t)(pageCount * (pageFetchLatency +
@@ -201,6 +208,38 @@ void SimpleDRAM::resetStatValues() {
   writeStat = Stat();
 }
 
+void SimpleDRAM::saveState(std::ostream &out) {
+  uint64_t refreshAt = 0;
+
+  pushTag(out, "DRAM");
+
+  AbstractDRAM::saveState(out);
+
+  scheduled(autoRefresh, &refreshAt);
+
+  pushValue(out, refreshAt);
+  pushValue(out, lastDRAMAccess);
+  pushValue(out, ignoreScheduling);
+  pushValue(out, readStat);
+  pushValue(out, writeStat);
+}
+
+void SimpleDRAM::loadState(std::istream &in) {
+  uint64_t refreshAt;
+
+  popTag(in, "DRAM");
+
+  AbstractDRAM::loadState(in);
+
+  popValue(in, refreshAt);
+  popValue(in, lastDRAMAccess);
+  popValue(in, ignoreScheduling);
+  popValue(in, readStat);
+  popValue(in, writeStat);
+
+  schedule(autoRefresh, refreshAt);
+}
+
 }  // namespace DRAM
 
 }  // namespace SimpleSSD
@@ -64,6 +64,9 @@ class SimpleDRAM : public AbstractDRAM {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace DRAM
@@ -34,7 +34,7 @@ typedef struct _Status {
   uint64_t freePhysicalBlocks;
 } Status;
 
-class AbstractFTL : public StatObject {
+class AbstractFTL : public StatObject, public StateObject {
  protected:
   Parameter &param;
   PAL::PAL *pPAL;
@@ -21,161 +21,84 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
+
+#include "util/algorithm.hh"
+#include "util/memory.hh"
 
 namespace SimpleSSD {
 
 namespace FTL {
 
-Block::Block(uint32_t blockIdx, uint32_t count, uint32_t ioUnit)
-    : idx(blockIdx),
-      pageCount(count),
-      ioUnitInPage(ioUnit),
-      pValidBits(nullptr),
-      pErasedBits(nullptr),
-      pLPNs(nullptr),
-      ppLPNs(nullptr),
-      lastAccessed(0),
-      eraseCount(0) {
-  if (ioUnitInPage == 1) {
-    pValidBits = new Bitset(pageCount);
-    pErasedBits = new Bitset(pageCount);
+static inline bool testBit(const uint64_t *bits, uint64_t i) {
+  return (bits[i / 64] >> (i % 64)) & 1;
+}
 
-    pLPNs = (uint64_t *)calloc(pageCount, sizeof(uint64_t));
-  }
-  else if (ioUnitInPage > 1) {
-    Bitset copy(ioUnitInPage);
+static inline void setBit(uint64_t *bits, uint64_t i) {
+  bits[i / 64] |= 1ull << (i % 64);
+}
 
-    validBits = std::vector<Bitset>(pageCount, copy);
-    erasedBits = std::vector<Bitset>(pageCount, copy);
+static inline void resetBit(uint64_t *bits, uint64_t i) {
+  bits[i / 64] &= ~(1ull << (i % 64));
+}
 
-    ppLPNs = (uint64_t **)calloc(pageCount, sizeof(uint64_t *));
+static const uint32_t NO_BLOCK = std::numeric_limits<uint32_t>::max();
 
-    for (uint32_t i = 0; i < pageCount; i++) {
-      ppLPNs[i] = (uint64_t *)calloc(ioUnitInPage, sizeof(uint64_t));
-    }
-  }
-  else {
+Block::Block(BlockPool *pool, uint32_t blockIdx, uint32_t count,
+             uint32_t ioUnit, uint64_t *valid, uint64_t *lpn,
+             uint32_t *writePointer)
+    : pPool(pool),
+      idx(blockIdx),
+      pageCount(count),
+      ioUnitInPage(ioUnit),
+      state(BLOCK_FREE),
+      validCount(0),
+      eraseCount(0),
+      lastAccessed(0),
+      pValidBits(valid),
+      pLPNs(lpn),
+      pNextWritePageIndex(writePointer) {
+  if (ioUnitInPage == 0) {
     panic("Invalid I/O unit in page");
   }
+}
 
-  // C-style allocation
-  pNextWritePageIndex = (uint32_t *)calloc(ioUnitInPage, sizeof(uint32_t));
-
-  erase();
-  eraseCount = 0;
+bool Block::isWritten(uint32_t pageIndex, uint32_t idx) {
+  return pageIndex < pNextWritePageIndex[idx];
 }
 
-Block::Block(const Block &old)
-    : Block(old.idx, old.pageCount, old.ioUnitInPage) {
-  if (ioUnitInPage == 1) {
-    *pValidBits = *old.pValidBits;
-    *pErasedBits = *old.pErasedBits;
+// Called after state or validCount is changed
+void Block::updateVictimIndex(BLOCK_STATE oldState, uint32_t oldValid) {
+  bool wasFull = oldState == BLOCK_FULL;
+  bool isFull = state == BLOCK_FULL;
 
-    memcpy(pLPNs, old.pLPNs, pageCount * sizeof(uint64_t));
+  if (wasFull == isFull && oldValid == validCount) {
+    return;
   }
-  else {
-    validBits = old.validBits;
-    erasedBits = old.erasedBits;
 
-    for (uint32_t i = 0; i < pageCount; i++) {
-      memcpy(ppLPNs[i], old.ppLPNs[i], ioUnitInPage * sizeof(uint64_t));
-    }
+  if (wasFull) {
+    pPool->removeVictim(idx, oldValid);
   }
 
-  memcpy(pNextWritePageIndex, old.pNextWritePageIndex,
-         ioUnitInPage * sizeof(uint32_t));
-
-  eraseCount = old.eraseCount;
-}
-
-Block::Block(Block &&old) noexcept
-    : idx(std::move(old.idx)),
-      pageCount(std::move(old.pageCount)),
-      ioUnitInPage(std::move(old.ioUnitInPage)),
-      pNextWritePageIndex(std::move(old.pNextWritePageIndex)),
-      pValidBits(std::move(old.pValidBits)),
-      pErasedBits(std::move(old.pErasedBits)),
-      pLPNs(std::move(old.pLPNs)),
-      validBits(std::move(old.validBits)),
-      erasedBits(std::move(old.erasedBits)),
-      ppLPNs(std::move(old.ppLPNs)),
-      lastAccessed(std::move(old.lastAccessed)),
-      eraseCount(std::move(old.eraseCount)) {
-  // TODO Use std::exchange to set old value to null (C++14)
-  old.idx = 0;
-  old.pageCount = 0;
-  old.ioUnitInPage = 0;
-  old.pNextWritePageIndex = nullptr;
-  old.pValidBits = nullptr;
-  old.pErasedBits = nullptr;
-  old.pLPNs = nullptr;
-  old.ppLPNs = nullptr;
-  old.lastAccessed = 0;
-  old.eraseCount = 0;
-}
-
-Block::~Block() {
-  free(pNextWritePageIndex);
-  free(pLPNs);
-
-  delete pValidBits;
-  delete pErasedBits;
-
-  if (ppLPNs) {
-    for (uint32_t i = 0; i < pageCount; i++) {
-      free(ppLPNs[i]);
-    }
-
-    free(ppLPNs);
+  if (isFull) {
+    pPool->insertVictim(idx, validCount);
   }
-
-  pNextWritePageIndex = nullptr;
-  pLPNs = nullptr;
-  pValidBits = nullptr;
-  pErasedBits = nullptr;
-  ppLPNs = nullptr;
 }
 
-Block &Block::operator=(const Block &rhs) {
-  if (this != &rhs) {
-    this->~Block();
-    *this = Block(rhs);  // Call copy constructor
-  }
-
-  return *this;
+uint32_t Block::getBlockIndex() const {
+  return idx;
 }
 
-Block &Block::operator=(Block &&rhs) {
-  if (this != &rhs) {
-    this->~Block();
-
-    idx = std::move(rhs.idx);
-    pageCount = std::move(rhs.pageCount);
-    ioUnitInPage = std::move(rhs.ioUnitInPage);
-    pNextWritePageIndex = std::move(rhs.pNextWritePageIndex);
-    pValidBits = std::move(rhs.pValidBits);
-    pErasedBits = std::move(rhs.pErasedBits);
-    pLPNs = std::move(rhs.pLPNs);
-    validBits = std::move(rhs.validBits);
-    erasedBits = std::move(rhs.erasedBits);
-    ppLPNs = std::move(rhs.ppLPNs);
-    lastAccessed = std::move(rhs.lastAccessed);
-    eraseCount = std::move(rhs.eraseCount);
+BLOCK_STATE Block::getState() const {
+  return state;
+}
 
-    rhs.pNextWritePageIndex = nullptr;
-    rhs.pValidBits = nullptr;
-    rhs.pErasedBits = nullptr;
-    rhs.pLPNs = nullptr;
-    rhs.ppLPNs = nullptr;
-    rhs.lastAccessed = 0;
-    rhs.eraseCount = 0;
-  }
+void Block::setState(BLOCK_STATE s) {
+  BLOCK_STATE oldState = state;
 
-  return *this;
-}
+  state = s;
 
-uint32_t Block::getBlockIndex() const {
-  return idx;
+  updateVictimIndex(oldState, validCount);
 }
 
 uint64_t Block::getLastAccessedTime() {
@@ -190,12 +113,18 @@ uint32_t Block::getValidPageCount() {
   uint32_t ret = 0;
 
   if (ioUnitInPage == 1) {
-    ret = pValidBits->count();
+    ret = validCount;
   }
-  else {
-    for (auto &iter : validBits) {
-      if (iter.any()) {
-        ret++;
+  else if (validCount > 0) {
+    uint32_t written = getNextWritePageIndex();
+
+    for (uint32_t i = 0; i < written; i++) {
+      for (uint32_t j = 0; j < ioUnitInPage; j++) {
+        if (testBit(pValidBits, i * ioUnitInPage + j)) {
+          ret++;
+
+          break;
+        }
       }
     }
   }
@@ -204,32 +133,25 @@ uint32_t Block::getValidPageCount() {
 }
 
 uint32_t Block::getValidPageCountRaw() {
-  uint32_t ret = 0;
-
-  if (ioUnitInPage == 1) {
-    // Same as getValidPageCount()
-    ret = pValidBits->count();
-  }
-  else {
-    for (auto &iter : validBits) {
-      ret += iter.count();
-    }
-  }
-
-  return ret;
+  return validCount;
 }
 
 uint32_t Block::getDirtyPageCount() {
+  uint32_t written = getNextWritePageIndex();
   uint32_t ret = 0;
 
   if (ioUnitInPage == 1) {
-    ret = (~(*pValidBits | *pErasedBits)).count();
+    ret = written - validCount;
   }
   else {
-    for (uint32_t i = 0; i < pageCount; i++) {
+    for (uint32_t i = 0; i < written; i++) {
       // Dirty: Valid(false), Erased(false)
-      if ((~(validBits.at(i) | erasedBits.at(i))).any()) {
-        ret++;
+      for (uint32_t j = 0; j < ioUnitInPage; j++) {
+        if (isWritten(i, j) && !testBit(pValidBits, i * ioUnitInPage + j)) {
+          ret++;
+
+          break;
+        }
       }
     }
   }
@@ -255,35 +177,36 @@ uint32_t Block::getNextWritePageIndex(uint32_t idx) {
 
 bool Block::getPageInfo(uint32_t pageIndex, std::vector<uint64_t> &lpn,
                         Bitset &map) {
-  if (ioUnitInPage == 1 && map.size() == 1) {
-    map.set();
-    lpn = std::vector<uint64_t>(1, pLPNs[pageIndex]);
-  }
-  else if (map.size() == ioUnitInPage) {
-    map = validBits.at(pageIndex);
-    lpn = std::vector<uint64_t>(ppLPNs[pageIndex],
-                                ppLPNs[pageIndex] + ioUnitInPage);
-  }
-  else {
+  uint64_t unit = (uint64_t)pageIndex * ioUnitInPage;
+
+  if (map.size() != ioUnitInPage) {
     panic("I/O map size mismatch");
   }
 
+  map.reset();
+
+  for (uint32_t i = 0; i < ioUnitInPage; i++) {
+    if (testBit(pValidBits, unit + i)) {
+      map.set(i);
+    }
+  }
+
+  lpn.assign(pLPNs + unit, pLPNs + unit + ioUnitInPage);
+
   return map.any();
 }
 
-bool Block::read(uint32_t pageIndex, uint32_t idx, uint64_t tick) {
-  bool read = false;
-
-  if (ioUnitInPage == 1 && idx == 0) {
-    read = pValidBits->test(pageIndex);
-  }
-  else if (idx < ioUnitInPage) {
-    read = validBits.at(pageIndex).test(idx);
-  }
-  else {
+bool Block::isValid(uint32_t pageIndex, uint32_t idx) {
+  if (idx >= ioUnitInPage) {
     panic("I/O map size mismatch");
   }
 
+  return testBit(pValidBits, (uint64_t)pageIndex * ioUnitInPage + idx);
+}
+
+bool Block::read(uint32_t pageIndex, uint32_t idx, uint64_t tick) {
+  bool read = isValid(pageIndex, idx);
+
   if (read) {
     lastAccessed = tick;
   }
@@ -293,73 +216,445 @@ bool Block::read(uint32_t pageIndex, uint32_t idx, uint64_t tick) {
 
 bool Block::write(uint32_t pageIndex, uint64_t lpn, uint32_t idx,
                   uint64_t tick) {
-  bool write = false;
+  uint64_t unit = (uint64_t)pageIndex * ioUnitInPage + idx;
 
-  if (ioUnitInPage == 1 && idx == 0) {
-    write = pErasedBits->test(pageIndex);
+  if (idx >= ioUnitInPage || pageIndex >= pageCount) {
+    panic("I/O map size mismatch");
   }
-  else if (idx < ioUnitInPage) {
-    write = erasedBits.at(pageIndex).test(idx);
+
+  if (isWritten(pageIndex, idx)) {
+    panic("Write to non erased page");
   }
-  else {
-    panic("I/O map size mismatch");
+
+  BLOCK_STATE oldState = state;
+
+  lastAccessed = tick;
+
+  setBit(pValidBits, unit);
+  validCount++;
+
+  pLPNs[unit] = lpn;
+  pNextWritePageIndex[idx] = pageIndex + 1;
+
+  if (pageIndex + 1 == pageCount) {
+    state = BLOCK_FULL;
   }
 
-  if (write) {
-    if (pageIndex < pNextWritePageIndex[idx]) {
-      panic("Write to block should sequential");
-    }
+  updateVictimIndex(oldState, validCount - 1);
 
-    lastAccessed = tick;
+  return true;
+}
+
+/**
+ * Write first count pages of erased block at once, page i holding
+ * LPN lpn + i * stride in I/O units [0, units). Same as calling write() for
+ * each page and unit in order at tick 0.
+ */
+void Block::fill(uint32_t count, uint32_t units, uint64_t lpn,
+                 uint64_t stride) {
+  if (count > pageCount || units > ioUnitInPage) {
+    panic("Fill range out of block");
+  }
 
-    if (ioUnitInPage == 1) {
-      pErasedBits->reset(pageIndex);
-      pValidBits->set(pageIndex);
+  if (getNextWritePageIndex() != 0) {
+    panic("Fill to non erased block");
+  }
 
-      pLPNs[pageIndex] = lpn;
-    }
-    else {
-      erasedBits.at(pageIndex).reset(idx);
-      validBits.at(pageIndex).set(idx);
+  for (uint32_t i = 0; i < count; i++, lpn += stride) {
+    for (uint32_t idx = 0; idx < units; idx++) {
+      uint64_t unit = (uint64_t)i * ioUnitInPage + idx;
 
-      ppLPNs[pageIndex][idx] = lpn;
+      setBit(pValidBits, unit);
+      pLPNs[unit] = lpn;
     }
+  }
 
-    pNextWritePageIndex[idx] = pageIndex + 1;
+  for (uint32_t idx = 0; idx < units; idx++) {
+    pNextWritePageIndex[idx] = count;
   }
-  else {
-    panic("Write to non erased page");
+
+  BLOCK_STATE oldState = state;
+  uint32_t oldValid = validCount;
+
+  validCount += count * units;
+  lastAccessed = 0;
+
+  if (count > 0 && units > 0 && count == pageCount) {
+    state = BLOCK_FULL;
   }
 
-  return write;
+  updateVictimIndex(oldState, oldValid);
 }
 
 void Block::erase() {
+  memset(pValidBits, 0,
+         DIVCEIL((uint64_t)pageCount * ioUnitInPage, 64) * sizeof(uint64_t));
+  memset(pNextWritePageIndex, 0, sizeof(uint32_t) * ioUnitInPage);
+
+  BLOCK_STATE oldState = state;
+  uint32_t oldValid = validCount;
+
+  state = BLOCK_FREE;
+  validCount = 0;
+  eraseCount++;
+
+  updateVictimIndex(oldState, oldValid);
+}
+
+void Block::invalidate(uint32_t pageIndex, uint32_t idx) {
+  uint64_t unit = (uint64_t)pageIndex * ioUnitInPage + idx;
+
+  if (testBit(pValidBits, unit)) {
+    resetBit(pValidBits, unit);
+    validCount--;
+
+    updateVictimIndex(state, validCount + 1);
+  }
+}
+
+void Block::saveState(std::ostream &out) {
+  // Pages after write pointer are in erased state, so they are not saved
+  uint32_t written = getNextWritePageIndex();
+
+  pushValue(out, idx);
+  pushValue(out, state);
+  pushValue(out, lastAccessed);
+  pushValue(out, eraseCount);
+
+  out.write((const char *)pNextWritePageIndex,
+            ioUnitInPage * sizeof(uint32_t));
+
+  if (written == 0) {
+    return;
+  }
+
+  out.write((const char *)pValidBits,
+            DIVCEIL((uint64_t)written * ioUnitInPage, 64) * sizeof(uint64_t));
+
   if (ioUnitInPage == 1) {
-    pValidBits->reset();
-    pErasedBits->set();
+    out.write((const char *)pLPNs, written * sizeof(uint64_t));
   }
   else {
-    for (auto &iter : validBits) {
-      iter.reset();
+    for (uint32_t i = 0; i < written; i++) {
+      uint64_t *lpns = pLPNs + (uint64_t)i * ioUnitInPage;
+      bool same = std::all_of(lpns + 1, lpns + ioUnitInPage,
+                              [&](uint64_t lpn) { return lpn == lpns[0]; });
+
+      // Usually all I/O units in a page belong to one logical page
+      pushValue(out, same);
+
+      if (same) {
+        pushValue(out, lpns[0]);
+      }
+      else {
+        out.write((const char *)lpns, ioUnitInPage * sizeof(uint64_t));
+      }
+    }
+  }
+}
+
+// Block should have same page count and I/O unit
+void Block::loadState(std::istream &in) {
+  BLOCK_STATE oldState = state;
+  uint32_t oldValid = validCount;
+  uint32_t saved;
+  uint32_t written;
+
+  popValue(in, saved);
+
+  if (saved != idx) {
+    panic("Checkpoint corrupted: expected block %u, got %u", idx, saved);
+  }
+
+  memset(pValidBits, 0,
+         DIVCEIL((uint64_t)pageCount * ioUnitInPage, 64) * sizeof(uint64_t));
+
+  popValue(in, state);
+  popValue(in, lastAccessed);
+  popValue(in, eraseCount);
+
+  in.read((char *)pNextWritePageIndex, ioUnitInPage * sizeof(uint32_t));
+  checkStream(in);
+
+  written = getNextWritePageIndex();
+
+  if (written > pageCount) {
+    panic("Checkpoint corrupted: invalid write pointer of block %u", idx);
+  }
+
+  validCount = 0;
+
+  if (written == 0) {
+    updateVictimIndex(oldState, oldValid);
+
+    return;
+  }
+
+  in.read((char *)pValidBits,
+          DIVCEIL((uint64_t)written * ioUnitInPage, 64) * sizeof(uint64_t));
+
+  for (uint64_t i = 0; i < (uint64_t)written * ioUnitInPage; i++) {
+    if (testBit(pValidBits, i)) {
+      validCount++;
     }
-    for (auto &iter : erasedBits) {
-      iter.set();
+  }
+
+  if (ioUnitInPage == 1) {
+    in.read((char *)pLPNs, written * sizeof(uint64_t));
+  }
+  else {
+    for (uint32_t i = 0; i < written; i++) {
+      uint64_t *lpns = pLPNs + (uint64_t)i * ioUnitInPage;
+      bool same;
+
+      popValue(in, same);
+
+      if (same) {
+        popValue(in, lpns[0]);
+        std::fill(lpns + 1, lpns + ioUnitInPage, lpns[0]);
+      }
+      else {
+        in.read((char *)lpns, ioUnitInPage * sizeof(uint64_t));
+      }
     }
   }
 
-  memset(pNextWritePageIndex, 0, sizeof(uint32_t) * ioUnitInPage);
+  checkStream(in);
 
-  eraseCount++;
+  updateVictimIndex(oldState, oldValid);
 }
 
-void Block::invalidate(uint32_t pageIndex, uint32_t idx) {
-  if (ioUnitInPage == 1) {
-    pValidBits->reset(pageIndex);
+BlockPool::BlockPool(uint32_t count, uint32_t pageCount,
+                     uint32_t ioUnitInPage) {
+  uint64_t units = (uint64_t)pageCount * ioUnitInPage;
+  uint64_t words = DIVCEIL(units, 64);
+
+  validBits.resize(count * words);
+  lpns.resize(count * units);
+  nextWritePageIndex.resize((uint64_t)count * ioUnitInPage);
+
+  bucketHead.resize(units + 1);
+  bucketTail.resize(units + 1);
+  prevBlock.resize(count);
+  nextBlock.resize(count);
+  fullBlocks.reserve(count);
+  fullBlockPosition.resize(count);
+
+  clearVictimIndex();
+
+  blocks.reserve(count);
+
+  for (uint32_t i = 0; i < count; i++) {
+    blocks.emplace_back(this, i, pageCount, ioUnitInPage,
+                        validBits.data() + i * words, lpns.data() + i * units,
+                        nextWritePageIndex.data() + (uint64_t)i * ioUnitInPage);
+  }
+}
+
+void BlockPool::insertVictim(uint32_t idx, uint32_t valid) {
+  // Append to tail
+  prevBlock[idx] = bucketTail[valid];
+  nextBlock[idx] = NO_BLOCK;
+
+  if (bucketTail[valid] == NO_BLOCK) {
+    bucketHead[valid] = idx;
   }
   else {
-    validBits.at(pageIndex).reset(idx);
+    nextBlock[bucketTail[valid]] = idx;
+  }
+
+  bucketTail[valid] = idx;
+
+  minBucket = MIN(minBucket, valid);
+
+  fullBlockPosition[idx] = (uint32_t)fullBlocks.size();
+  fullBlocks.push_back(idx);
+}
+
+void BlockPool::removeVictim(uint32_t idx, uint32_t valid) {
+  if (prevBlock[idx] == NO_BLOCK) {
+    bucketHead[valid] = nextBlock[idx];
+  }
+  else {
+    nextBlock[prevBlock[idx]] = nextBlock[idx];
+  }
+
+  if (nextBlock[idx] == NO_BLOCK) {
+    bucketTail[valid] = prevBlock[idx];
+  }
+  else {
+    prevBlock[nextBlock[idx]] = prevBlock[idx];
+  }
+
+  // Move last one to the hole
+  uint32_t pos = fullBlockPosition[idx];
+  uint32_t last = fullBlocks.back();
+
+  fullBlocks[pos] = last;
+  fullBlockPosition[last] = pos;
+  fullBlocks.pop_back();
+}
+
+void BlockPool::clearVictimIndex() {
+  std::fill(bucketHead.begin(), bucketHead.end(), NO_BLOCK);
+  std::fill(bucketTail.begin(), bucketTail.end(), NO_BLOCK);
+
+  minBucket = (uint32_t)bucketHead.size();
+  fullBlocks.clear();
+}
+
+/**
+ * Append at most count full blocks with the least valid I/O units to list,
+ * in ascending order of valid count. Blocks with same valid count are in
+ * order of reaching that count.
+ */
+void BlockPool::getLeastValidBlocks(std::vector<uint32_t> &list,
+                                    uint64_t count) {
+  while (minBucket < bucketHead.size() && bucketHead[minBucket] == NO_BLOCK) {
+    minBucket++;
   }
+
+  for (uint32_t valid = minBucket; valid < bucketHead.size(); valid++) {
+    for (uint32_t idx = bucketHead[valid]; idx != NO_BLOCK;
+         idx = nextBlock[idx]) {
+      if (count == 0) {
+        return;
+      }
+
+      list.push_back(idx);
+      count--;
+    }
+  }
+}
+
+/**
+ * Append full block with the least valid I/O units of each parallel unit
+ * (block index % units) to list. Stops as soon as every unit has one.
+ */
+void BlockPool::getLeastValidBlockPerUnit(std::vector<uint32_t> &list,
+                                          uint32_t units) {
+  std::vector<bool> found(units, false);
+  uint32_t left = units;
+
+  while (minBucket < bucketHead.size() && bucketHead[minBucket] == NO_BLOCK) {
+    minBucket++;
+  }
+
+  for (uint32_t valid = minBucket; valid < bucketHead.size(); valid++) {
+    for (uint32_t idx = bucketHead[valid]; idx != NO_BLOCK;
+         idx = nextBlock[idx]) {
+      if (left == 0) {
+        return;
+      }
+
+      if (!found[idx % units]) {
+        found[idx % units] = true;
+        list.push_back(idx);
+        left--;
+      }
+    }
+  }
+}
+
+/**
+ * Append count full blocks chosen uniformly at random without replacement
+ * (or all full blocks if there are fewer) to list. Partial Fisher-Yates
+ * shuffle on fullBlocks, so it takes O(count) without extra memory.
+ */
+void BlockPool::sampleFullBlocks(std::vector<uint32_t> &list, uint64_t count,
+                                 Random &gen) {
+  uint32_t size = (uint32_t)fullBlocks.size();
+
+  count = MIN(count, size);
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t j = i + (uint32_t)gen.next(size - i);
+    uint32_t a = fullBlocks[i];
+    uint32_t b = fullBlocks[j];
+
+    fullBlocks[i] = b;
+    fullBlocks[j] = a;
+    fullBlockPosition[b] = i;
+    fullBlockPosition[a] = j;
+
+    list.push_back(b);
+  }
+}
+
+uint64_t BlockPool::getMemoryUsage() const {
+  return memoryUsage(blocks) + memoryUsage(validBits) + memoryUsage(lpns) +
+         memoryUsage(nextWritePageIndex) + memoryUsage(bucketHead) +
+         memoryUsage(bucketTail) + memoryUsage(prevBlock) +
+         memoryUsage(nextBlock) + memoryUsage(fullBlocks) +
+         memoryUsage(fullBlockPosition);
+}
+
+void BlockPool::saveState(std::ostream &out) {
+  std::vector<uint32_t> victims;
+
+  for (auto &iter : blocks) {
+    iter.saveState(out);
+  }
+
+  // Order in buckets decides ties of victim selection
+  victims.reserve(fullBlocks.size());
+  getLeastValidBlocks(victims, fullBlocks.size());
+
+  pushVector(out, victims);
+
+  // Order in fullBlocks decides random sampling
+  pushVector(out, fullBlocks);
+}
+
+void BlockPool::loadState(std::istream &in) {
+  std::vector<uint32_t> victims;
+
+  for (auto &iter : blocks) {
+    iter.loadState(in);
+  }
+
+  popVector(in, victims);
+
+  if (victims.size() != fullBlocks.size()) {
+    panic("Checkpoint corrupted: full block count mismatch");
+  }
+
+  clearVictimIndex();
+
+  for (auto &idx : victims) {
+    if (idx >= blocks.size() || blocks[idx].getState() != BLOCK_FULL) {
+      panic("Checkpoint corrupted: invalid victim block");
+    }
+
+    insertVictim(idx, blocks[idx].getValidPageCountRaw());
+  }
+
+  popVector(in, victims);
+
+  if (victims.size() != fullBlocks.size()) {
+    panic("Checkpoint corrupted: full block count mismatch");
+  }
+
+  for (auto &idx : victims) {
+    if (idx >= blocks.size()) {
+      panic("Checkpoint corrupted: invalid full block");
+    }
+
+    fullBlockPosition[idx] = NO_BLOCK;
+  }
+
+  for (uint32_t i = 0; i < victims.size(); i++) {
+    uint32_t idx = victims[i];
+
+    if (blocks[idx].getState() != BLOCK_FULL ||
+        fullBlockPosition[idx] != NO_BLOCK) {
+      panic("Checkpoint corrupted: invalid full block");
+    }
+
+    fullBlockPosition[idx] = i;
+  }
+
+  fullBlocks = std::move(victims);
 }
 
 }  // namespace FTL
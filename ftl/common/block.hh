@@ -23,42 +23,62 @@
 #include <cinttypes>
 #include <vector>
 
+#include "sim/state.hh"
 #include "util/bitset.hh"
+#include "util/random.hh"
 
 namespace SimpleSSD {
 
 namespace FTL {
 
-class Block {
+typedef enum : uint8_t {
+  BLOCK_FREE,  //!< Erased, in free block list
+  BLOCK_OPEN,  //!< Allocated for write
+  BLOCK_FULL,  //!< Write pointer reached end of block
+  BLOCK_BAD,   //!< Retired by erase count threshold
+} BLOCK_STATE;
+
+class BlockPool;
+
+/**
+ * \brief Metadata of one physical block
+ *
+ * Block does not own its storage. Valid bits, LPNs and write pointers live in
+ * pools of BlockPool, where I/O unit idx of page p is (p * ioUnitInPage + idx)
+ * in the range of the block. Erased state is not stored, as pages are written
+ * sequentially: I/O unit is erased iff page >= its write pointer.
+ */
+class Block : public StateObject {
  private:
+  BlockPool *pPool;
+
   uint32_t idx;
   uint32_t pageCount;
   uint32_t ioUnitInPage;
-  uint32_t *pNextWritePageIndex;
+  BLOCK_STATE state;
+  uint32_t validCount;  // Valid I/O units
+  uint32_t eraseCount;
+  uint64_t lastAccessed;
 
-  // Following variables are used when ioUnitInPage == 1
-  Bitset *pValidBits;
-  Bitset *pErasedBits;
+  uint64_t *pValidBits;
   uint64_t *pLPNs;
+  uint32_t *pNextWritePageIndex;
 
-  // Following variables are used when ioUnitInPage > 1
-  std::vector<Bitset> validBits;
-  std::vector<Bitset> erasedBits;
-  uint64_t **ppLPNs;
-
-  uint64_t lastAccessed;
-  uint32_t eraseCount;
+  bool isWritten(uint32_t, uint32_t);
+  void updateVictimIndex(BLOCK_STATE, uint32_t);
 
  public:
-  Block(uint32_t, uint32_t, uint32_t);
-  Block(const Block &);      // Copy constructor
-  Block(Block &&) noexcept;  // Move constructor
-  ~Block();
+  Block(BlockPool *, uint32_t, uint32_t, uint32_t, uint64_t *, uint64_t *,
+        uint32_t *);
+  Block(const Block &) = delete;
+  Block(Block &&) noexcept = default;
 
-  Block &operator=(const Block &);  // Copy assignment
-  Block &operator=(Block &&);       // Move assignment
+  Block &operator=(const Block &) = delete;
+  Block &operator=(Block &&) = default;
 
   uint32_t getBlockIndex() const;
+  BLOCK_STATE getState() const;
+  void setState(BLOCK_STATE);
   uint64_t getLastAccessedTime();
   uint32_t getEraseCount();
   uint32_t getValidPageCount();
@@ -67,10 +87,75 @@ class Block {
   uint32_t getNextWritePageIndex();
   uint32_t getNextWritePageIndex(uint32_t);
   bool getPageInfo(uint32_t, std::vector<uint64_t> &, Bitset &);
+  bool isValid(uint32_t, uint32_t);
   bool read(uint32_t, uint32_t, uint64_t);
   bool write(uint32_t, uint64_t, uint32_t, uint64_t);
+  void fill(uint32_t, uint32_t, uint64_t, uint64_t);
   void erase();
   void invalidate(uint32_t, uint32_t);
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
+};
+
+/**
+ * \brief Metadata of all physical blocks, indexed by block number
+ *
+ * Per-block arrays of all blocks are packed into a few large allocations
+ * (struct of arrays), instead of separate heap allocations per block.
+ *
+ * Full blocks are also linked into lists bucketed by valid I/O unit count
+ * (victim index). Block updates the index whenever its state or valid count
+ * changes, so blocks with the least valid pages can be found without scanning
+ * and sorting all blocks. Full blocks are also kept in a dense array for
+ * random sampling.
+ */
+class BlockPool : public StateObject {
+ private:
+  friend class Block;
+
+  std::vector<Block> blocks;
+
+  std::vector<uint64_t> validBits;
+  std::vector<uint64_t> lpns;
+  std::vector<uint32_t> nextWritePageIndex;
+
+  // Victim index, FIFO list of full blocks per valid I/O unit count
+  std::vector<uint32_t> bucketHead;
+  std::vector<uint32_t> bucketTail;
+  std::vector<uint32_t> prevBlock;
+  std::vector<uint32_t> nextBlock;
+  uint32_t minBucket;  // All buckets below are empty
+
+  // All full blocks in arbitrary order, and position of each block in it
+  std::vector<uint32_t> fullBlocks;
+  std::vector<uint32_t> fullBlockPosition;
+
+  void insertVictim(uint32_t, uint32_t);
+  void removeVictim(uint32_t, uint32_t);
+  void clearVictimIndex();
+
+ public:
+  BlockPool(uint32_t, uint32_t, uint32_t);
+  BlockPool(const BlockPool &) = delete;
+
+  BlockPool &operator=(const BlockPool &) = delete;
+
+  Block &operator[](uint32_t idx) { return blocks[idx]; }
+  uint32_t size() const { return (uint32_t)blocks.size(); }
+
+  std::vector<Block>::iterator begin() { return blocks.begin(); }
+  std::vector<Block>::iterator end() { return blocks.end(); }
+
+  uint32_t getFullBlockCount() const { return (uint32_t)fullBlocks.size(); }
+  void getLeastValidBlocks(std::vector<uint32_t> &, uint64_t);
+  void getLeastValidBlockPerUnit(std::vector<uint32_t> &, uint32_t);
+  void sampleFullBlocks(std::vector<uint32_t> &, uint64_t, Random &);
+
+  uint64_t getMemoryUsage() const;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace FTL
@@ -24,6 +24,8 @@
 #include <cassert>
 #include "block.hh"
 #include "block_fast.hh"
+#include "util/algorithm.hh"
+#include "util/memory.hh"
 
 namespace SimpleSSD {
 
@@ -152,6 +154,20 @@ uint32_t BlockFast::getBlockIndex() const {
   return idx;
 }
 
+// Heap memory owned by this block, without sizeof(BlockFast) itself
+uint64_t BlockFast::getMemoryUsage() const {
+  uint64_t bytes = allocationSize(ioUnitInPage * sizeof(uint32_t));
+
+  bytes += 2 * (allocationSize(sizeof(Bitset)) +
+                allocationSize(DIVCEIL(pageCount, 8)));
+
+  if (pLPNs) {
+    bytes += allocationSize(pageCount * sizeof(uint64_t));
+  }
+
+  return bytes;
+}
+
 uint64_t BlockFast::getLastAccessedTime() {
   return lastAccessed;
 }
@@ -335,6 +351,45 @@ void BlockFast::invalidate(uint32_t pageIndex, uint32_t idx) {
   }
 }
 
+void BlockFast::saveState(std::ostream &out) {
+  pushValue(out, lastAccessed);
+  pushValue(out, eraseCount);
+  pushValue(out, *pNextWritePageIndex);
+
+  pValidBits->saveState(out);
+  pErasedBits->saveState(out);
+
+  // Only log blocks keep LPNs
+  pushValue(out, pLPNs != nullptr);
+
+  if (pLPNs) {
+    out.write((const char *)pLPNs, pageCount * sizeof(uint64_t));
+  }
+}
+
+// Block index and page count are fixed by owner
+void BlockFast::loadState(std::istream &in) {
+  bool hasLPNs;
+
+  popValue(in, lastAccessed);
+  popValue(in, eraseCount);
+  popValue(in, *pNextWritePageIndex);
+
+  pValidBits->loadState(in);
+  pErasedBits->loadState(in);
+
+  popValue(in, hasLPNs);
+
+  if (hasLPNs != (pLPNs != nullptr)) {
+    claimLPN(hasLPNs);
+  }
+
+  if (pLPNs) {
+    in.read((char *)pLPNs, pageCount * sizeof(uint64_t));
+    checkStream(in);
+  }
+}
+
 }  // namespace FTL
 
 }  // namespace SimpleSSD
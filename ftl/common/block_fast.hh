@@ -23,13 +23,14 @@
 #include <cinttypes>
 #include <vector>
 
+#include "sim/state.hh"
 #include "util/bitset.hh"
 
 namespace SimpleSSD {
 
 namespace FTL {
 
-class BlockFast {
+class BlockFast : public StateObject {
  private:
   uint32_t idx;
   uint32_t pageCount;
@@ -54,6 +55,7 @@ class BlockFast {
   BlockFast &operator=(BlockFast &&);       // Move assignment
 
   uint32_t getBlockIndex() const;
+  uint64_t getMemoryUsage() const;
   uint64_t getLastAccessedTime();
   uint32_t getEraseCount();
   uint32_t getValidPageCount();
@@ -73,6 +75,9 @@ class BlockFast {
   bool write(uint32_t, uint64_t, uint32_t, uint64_t);
   void erase();
   void invalidate(uint32_t, uint32_t);
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace FTL
@@ -37,7 +37,14 @@ const char NAME_GC_RECLAIM_BLOCK[] = "GCReclaimBlocks";
 const char NAME_GC_RECLAIM_THRESHOLD[] = "GCReclaimThreshold";
 const char NAME_GC_EVICT_POLICY[] = "EvictPolicy";
 const char NAME_GC_D_CHOICE_PARAM[] = "DChoiceParam";
+const char NAME_BGC_ENABLE[] = "EnableBackgroundGC";
+const char NAME_BGC_IDLE_TIME[] = "BackgroundGCIdleTime";
+const char NAME_BGC_THRESHOLD[] = "BackgroundGCThreshold";
+const char NAME_BGC_RECLAIM_THRESHOLD[] = "BackgroundGCReclaimThreshold";
+const char NAME_IGC_ENABLE[] = "EnableIncrementalGC";
+const char NAME_IGC_PAGES[] = "IncrementalGCPages";
 const char NAME_USE_RANDOM_IO_TWEAK[] = "EnableRandomIOTweak";
+const char NAME_IMAGE_CACHE_PATH[] = "ImageCachePath";
 
 Config::Config() {
   mapping = PAGE_MAPPING;
@@ -52,6 +59,12 @@ Config::Config() {
   gcMode = GC_MODE_0;
   evictPolicy = POLICY_GREEDY;
   dChoiceParam = 3;
+  bgcEnable = false;
+  bgcIdleTime = 1000000000;
+  bgcThreshold = 0.1f;
+  bgcReclaimThreshold = 0.15f;
+  igcEnable = false;
+  igcPages = 4;
   randomIOTweak = true;
 }
 
@@ -94,9 +107,30 @@ bool Config::setConfig(const char *name, const char *value) {
   else if (MATCH_NAME(NAME_GC_D_CHOICE_PARAM)) {
     dChoiceParam = strtoul(value, nullptr, 10);
   }
+  else if (MATCH_NAME(NAME_BGC_ENABLE)) {
+    bgcEnable = convertBool(value);
+  }
+  else if (MATCH_NAME(NAME_BGC_IDLE_TIME)) {
+    bgcIdleTime = strtoul(value, nullptr, 10);
+  }
+  else if (MATCH_NAME(NAME_BGC_THRESHOLD)) {
+    bgcThreshold = strtof(value, nullptr);
+  }
+  else if (MATCH_NAME(NAME_BGC_RECLAIM_THRESHOLD)) {
+    bgcReclaimThreshold = strtof(value, nullptr);
+  }
+  else if (MATCH_NAME(NAME_IGC_ENABLE)) {
+    igcEnable = convertBool(value);
+  }
+  else if (MATCH_NAME(NAME_IGC_PAGES)) {
+    igcPages = strtoul(value, nullptr, 10);
+  }
   else if (MATCH_NAME(NAME_USE_RANDOM_IO_TWEAK)) {
     randomIOTweak = convertBool(value);
   }
+  else if (MATCH_NAME(NAME_IMAGE_CACHE_PATH)) {
+    imageCachePath = value;
+  }
   else {
     ret = false;
   }
@@ -113,6 +147,24 @@ void Config::update() {
     panic("Invalid GCReclaimThreshold");
   }
 
+  if (bgcEnable) {
+    if (bgcIdleTime == 0) {
+      panic("Invalid BackgroundGCIdleTime");
+    }
+
+    if (bgcThreshold < gcThreshold) {
+      panic("Invalid BackgroundGCThreshold");
+    }
+
+    if (bgcReclaimThreshold < bgcThreshold) {
+      panic("Invalid BackgroundGCReclaimThreshold");
+    }
+  }
+
+  if (igcEnable && igcPages == 0) {
+    panic("Invalid IncrementalGCPages");
+  }
+
   if (fillingRatio < 0.f || fillingRatio > 1.f) {
     panic("Invalid FillingRatio");
   }
@@ -156,6 +208,12 @@ uint64_t Config::readUint(uint32_t idx) {
     case FTL_GC_D_CHOICE_PARAM:
       ret = dChoiceParam;
       break;
+    case FTL_BGC_IDLE_TIME:
+      ret = bgcIdleTime;
+      break;
+    case FTL_IGC_PAGES:
+      ret = igcPages;
+      break;
   }
 
   return ret;
@@ -180,6 +238,24 @@ float Config::readFloat(uint32_t idx) {
     case FTL_GC_RECLAIM_THRESHOLD:
       ret = reclaimThreshold;
       break;
+    case FTL_BGC_THRESHOLD_RATIO:
+      ret = bgcThreshold;
+      break;
+    case FTL_BGC_RECLAIM_THRESHOLD:
+      ret = bgcReclaimThreshold;
+      break;
+  }
+
+  return ret;
+}
+
+std::string Config::readString(uint32_t idx) {
+  std::string ret("");
+
+  switch (idx) {
+    case FTL_IMAGE_CACHE_PATH:
+      ret = imageCachePath;
+      break;
   }
 
   return ret;
@@ -192,6 +268,12 @@ bool Config::readBoolean(uint32_t idx) {
     case FTL_USE_RANDOM_IO_TWEAK:
       ret = randomIOTweak;
       break;
+    case FTL_BGC_ENABLE:
+      ret = bgcEnable;
+      break;
+    case FTL_IGC_ENABLE:
+      ret = igcEnable;
+      break;
   }
 
   return ret;
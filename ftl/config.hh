@@ -40,7 +40,14 @@ typedef enum {
   FTL_GC_RECLAIM_THRESHOLD,
   FTL_GC_EVICT_POLICY,
   FTL_GC_D_CHOICE_PARAM,
+  FTL_BGC_ENABLE,
+  FTL_BGC_IDLE_TIME,
+  FTL_BGC_THRESHOLD_RATIO,
+  FTL_BGC_RECLAIM_THRESHOLD,
+  FTL_IGC_ENABLE,
+  FTL_IGC_PAGES,
   FTL_USE_RANDOM_IO_TWEAK,
+  FTL_IMAGE_CACHE_PATH,
 
   /* N+K Mapping configuration*/
   FTL_NKMAP_N,
@@ -84,7 +91,14 @@ class Config : public BaseConfig {
   GC_MODE gcMode;              //!< Default: FTL_GC_MODE_0
   EVICT_POLICY evictPolicy;    //!< Default: POLICY_GREEDY
   uint64_t dChoiceParam;       //!< Default: 3
+  bool bgcEnable;              //!< Default: false
+  uint64_t bgcIdleTime;        //!< Default: 1000000000 (1ms)
+  float bgcThreshold;          //!< Default: 0.1 (10%)
+  float bgcReclaimThreshold;   //!< Default: 0.15 (15%)
+  bool igcEnable;              //!< Default: false
+  uint64_t igcPages;           //!< Default: 4
   bool randomIOTweak;          //!< Default: true
+  std::string imageCachePath;  //!< Default: ""
 
  public:
   Config();
@@ -95,6 +109,7 @@ class Config : public BaseConfig {
   int64_t readInt(uint32_t) override;
   uint64_t readUint(uint32_t) override;
   float readFloat(uint32_t) override;
+  std::string readString(uint32_t) override;
   bool readBoolean(uint32_t) override;
 };
 
@@ -21,10 +21,12 @@
 
 #include <algorithm>
 #include <limits>
-#include <random>
 
+#include "sim/profile.hh"
 #include "util/algorithm.hh"
 #include "util/bitset.hh"
+#include "util/memory.hh"
+#include "util/random.hh"
 
 namespace SimpleSSD {
 
@@ -101,6 +103,8 @@ bool FastMapping::initialize() {
              nPagesToInvalidate,
              nPagesToInvalidate * 100.f / nTotalLogicalPages);
 
+  Random gen = getRandomStream(RANDOM_FTL_FILL);
+
   req.ioFlag.set();
 
   // Step 1. Filling
@@ -114,13 +118,9 @@ bool FastMapping::initialize() {
   }
   else {
     // Random
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, nTotalLogicalPages - 1);
-
     for (uint64_t i = 0; i < nPagesToWarmup; i++) {
       tick = 0;
-      req.lpn = dist(gen);
+      req.lpn = gen.next(nTotalLogicalPages);
       writeInternal(req, tick, false);
     }
   }
@@ -138,25 +138,17 @@ bool FastMapping::initialize() {
     // Random
     // We can successfully restrict range of LPN to create exact number of
     // invalid pages because we wrote in sequential mannor in step 1.
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, nPagesToWarmup - 1);
-
     for (uint64_t i = 0; i < nPagesToInvalidate; i++) {
       tick = 0;
-      req.lpn = dist(gen);
+      req.lpn = gen.next(nPagesToWarmup);
       writeInternal(req, tick, false);
     }
   }
   else {
     // Random
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, nTotalLogicalPages - 1);
-
     for (uint64_t i = 0; i < nPagesToInvalidate; i++) {
       tick = 0;
-      req.lpn = dist(gen);
+      req.lpn = gen.next(nTotalLogicalPages);
       writeInternal(req, tick, false);
     }
   }
@@ -488,6 +480,8 @@ void FastMapping::writeInternal(Request &req, uint64_t &tick, bool sendToPAL) {
 void FastMapping::mergeLogBlock(uint32_t logBlockPhyNum,
     enum BlockType blockType, std::optional<uint32_t> additionalPage, uint64_t &tick, PAL::Request &req, bool sendToPAL) {
 
+  ProfileScope scope(PROFILE_FTL_GC);
+
   std::vector<PAL::Request> readRequests;
   std::vector<std::pair<PAL::Request, uint64_t>> writeRequests; // pair: request, lpn
   std::vector<PAL::Request> eraseRequests;
@@ -798,6 +792,125 @@ void FastMapping::resetStatValues() {
   // assert(0); // not implemented yet.
 }
 
+void FastMapping::getMemoryUsage(std::vector<MemoryUsage> &list,
+                                 std::string prefix) {
+  MemoryUsage temp;
+
+  temp.name = prefix + "memory.mapping_table";
+  temp.desc = "Host memory used by block and log mapping table in byte";
+  temp.bytes = memoryUsage(logicalToPhysicalBlockMapping) +
+               memoryUsage(physicalToLogicalBlockMapping) +
+               memoryUsage(RWlogMapping);
+  list.push_back(temp);
+
+  temp.name = prefix + "memory.block_metadata";
+  temp.desc = "Host memory used by block metadata in byte";
+  temp.bytes = memoryUsage(physicalBlocks) + memoryUsage(freeBlocks) +
+               memoryUsage(RWBlocks);
+
+  // Only log blocks hold LPNs, so block sizes differ
+  for (auto &iter : physicalBlocks) {
+    temp.bytes += iter.getMemoryUsage();
+  }
+
+  list.push_back(temp);
+}
+
+void FastMapping::saveState(std::ostream &out) {
+  pushTag(out, "FTLF");
+
+  pushValue(out, param.totalPhysicalBlocks);
+  pushValue(out, param.totalLogicalBlocks);
+  pushValue(out, param.pagesInBlock);
+
+  pushVector(out, logicalToPhysicalBlockMapping);
+  pushVector(out, physicalToLogicalBlockMapping);
+
+  for (auto &iter : physicalBlocks) {
+    iter.saveState(out);
+  }
+
+  pushValue(out, (uint64_t)freeBlocks.size());
+
+  for (auto &iter : freeBlocks) {
+    pushValue(out, iter);
+  }
+
+  pushValue(out, (uint64_t)RWlogMapping.size());
+
+  for (auto &iter : RWlogMapping) {
+    pushValue(out, iter.first);
+    pushValue(out, iter.second.first);
+    pushValue(out, iter.second.second);
+  }
+
+  pushValue(out, SWBlock);
+  pushValue(out, (uint64_t)RWBlocks.size());
+
+  for (auto &iter : RWBlocks) {
+    pushValue(out, iter);
+  }
+
+  pushValue(out, stat);
+}
+
+void FastMapping::loadState(std::istream &in) {
+  uint64_t size;
+  uint64_t lpn;
+  uint32_t pbn;
+  std::pair<uint32_t, uint32_t> ppn;
+
+  popTag(in, "FTLF");
+
+  checkValue(in, param.totalPhysicalBlocks, "FTL physical blocks");
+  checkValue(in, param.totalLogicalBlocks, "FTL logical blocks");
+  checkValue(in, param.pagesInBlock, "FTL pages in block");
+
+  popVector(in, logicalToPhysicalBlockMapping);
+  popVector(in, physicalToLogicalBlockMapping);
+
+  if (logicalToPhysicalBlockMapping.size() != param.totalLogicalBlocks ||
+      physicalToLogicalBlockMapping.size() != param.totalPhysicalBlocks) {
+    panic("Checkpoint corrupted: block mapping size mismatch");
+  }
+
+  for (auto &iter : physicalBlocks) {
+    iter.loadState(in);
+  }
+
+  freeBlocks.clear();
+  popValue(in, size);
+
+  for (uint64_t i = 0; i < size; i++) {
+    popValue(in, pbn);
+    freeBlocks.push_back(pbn);
+  }
+
+  RWlogMapping.clear();
+  popValue(in, size);
+  RWlogMapping.reserve(size);
+
+  for (uint64_t i = 0; i < size; i++) {
+    popValue(in, lpn);
+    popValue(in, ppn.first);
+    popValue(in, ppn.second);
+
+    RWlogMapping.emplace(lpn, ppn);
+  }
+
+  popValue(in, SWBlock);
+
+  RWBlocks.clear();
+  popValue(in, size);
+
+  for (uint64_t i = 0; i < size; i++) {
+    popValue(in, pbn);
+    RWBlocks.push_back(pbn);
+  }
+
+  popValue(in, stat);
+}
+
 }  // namespace FTL
 
 }  // namespace SimpleSSD
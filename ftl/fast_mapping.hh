@@ -164,6 +164,10 @@ class FastMapping : public AbstractFTL {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace FTL
@@ -19,14 +19,23 @@
 
 #include "ftl/ftl.hh"
 
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
 #include "ftl/page_mapping.hh"
 #include "ftl/fast_mapping.hh"
+#include "sim/profile.hh"
+#include "util/mapped_file.hh"
 
 namespace SimpleSSD {
 
 namespace FTL {
 
 FTL::FTL(ConfigReader &c, DRAM::AbstractDRAM *d) : conf(c), pDRAM(d) {
+  // Includes filling (or loading image) at initialization
+  ProfileScope scope(PROFILE_FTL);
   PAL::Parameter *palparam;
 
   pPAL = new PAL::PAL(conf);
@@ -61,7 +70,28 @@ FTL::FTL(ConfigReader &c, DRAM::AbstractDRAM *d) : conf(c), pDRAM(d) {
   debugprint(LOG_FTL, "Logical page size %u", param.pageSize);
 
   // Initialize pFTL
-  pFTL->initialize();
+  std::string cachePath = conf.readString(CONFIG_FTL, FTL_IMAGE_CACHE_PATH);
+
+  if (cachePath.length() > 0) {
+    std::string key = getImageKey();
+    uint64_t hash = 0xCBF29CE484222325ull;  // FNV-1a
+    char name[32];
+
+    for (auto c : key) {
+      hash = (hash ^ (uint8_t)c) * 0x100000001B3ull;
+    }
+
+    snprintf(name, 32, "/ftl-%016" PRIx64 ".img", hash);
+    cachePath += name;
+
+    if (!loadImage(cachePath, key)) {
+      pFTL->initialize();
+      saveImage(cachePath, key);
+    }
+  }
+  else {
+    pFTL->initialize();
+  }
 }
 
 FTL::~FTL() {
@@ -69,7 +99,89 @@ FTL::~FTL() {
   delete pFTL;
 }
 
+/**
+ * Everything initialize() depends on. Random filling modes draw from
+ * RandomSeed, so each seed has its own image.
+ */
+std::string FTL::getImageKey() {
+  std::ostringstream key;
+
+  pushValue(key, *pPAL->getInfo());
+  pushValue(key, param.totalPhysicalBlocks);
+  pushValue(key, param.totalLogicalBlocks);
+  pushValue(key, param.pagesInBlock);
+  pushValue(key, param.pageSize);
+  pushValue(key, param.ioUnitInPage);
+  pushValue(key, param.pageCountToMaxPerf);
+  pushValue(key, conf.readInt(CONFIG_FTL, FTL_MAPPING_MODE));
+  pushValue(key, conf.readUint(CONFIG_FTL, FTL_FILLING_MODE));
+  pushValue(key, conf.readFloat(CONFIG_FTL, FTL_FILL_RATIO));
+  pushValue(key, conf.readFloat(CONFIG_FTL, FTL_INVALID_PAGE_RATIO));
+  pushValue(key, conf.readFloat(CONFIG_FTL, FTL_GC_THRESHOLD_RATIO));
+  pushValue(key, conf.readBoolean(CONFIG_FTL, FTL_USE_RANDOM_IO_TWEAK));
+  pushValue(key, conf.readUint(CONFIG_SIM, SIM_RANDOM_SEED));
+
+  return key.str();
+}
+
+bool FTL::loadImage(std::string &path, std::string &key) {
+  MappedFile file;
+  std::istream in(&file);
+  std::string savedKey;
+  uint64_t tick;
+
+  if (!file.open(path)) {
+    return false;
+  }
+
+  if (!readCheckpointHeader(in, tick)) {
+    warn("Ignoring invalid FTL image %s", path.c_str());
+
+    return false;
+  }
+
+  popString(in, savedKey);
+
+  if (savedKey != key) {
+    // Hash collision
+    return false;
+  }
+
+  pFTL->loadState(in);
+
+  debugprint(LOG_FTL, "Initialized from image %s", path.c_str());
+
+  return true;
+}
+
+void FTL::saveImage(std::string &path, std::string &key) {
+  // Write to temporary file first, so other simulations sharing cache
+  // directory never see partially written image
+  std::string temp = path + "." + std::to_string(std::random_device()()) +
+                     ".tmp";
+  std::ofstream out(temp, std::ios::binary);
+
+  if (!out.is_open()) {
+    warn("Failed to create FTL image %s", path.c_str());
+
+    return;
+  }
+
+  writeCheckpointHeader(out, 0);
+  pushString(out, key);
+  pFTL->saveState(out);
+
+  out.close();
+
+  // Another simulation may have saved same image meanwhile
+  if (out.fail() || rename(temp.c_str(), path.c_str()) != 0) {
+    remove(temp.c_str());
+  }
+}
+
 void FTL::read(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL);
+
   debugprint(LOG_FTL, "READ  | LPN %" PRIu64, req.lpn);
 
   pFTL->read(req, tick);
@@ -78,6 +190,8 @@ void FTL::read(Request &req, uint64_t &tick) {
 }
 
 void FTL::write(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL);
+
   debugprint(LOG_FTL, "WRITE | LPN %" PRIu64, req.lpn);
 
   pFTL->write(req, tick);
@@ -86,6 +200,8 @@ void FTL::write(Request &req, uint64_t &tick) {
 }
 
 void FTL::trim(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL);
+
   debugprint(LOG_FTL, "TRIM  | LPN %" PRIu64, req.lpn);
 
   pFTL->trim(req, tick);
@@ -94,6 +210,8 @@ void FTL::trim(Request &req, uint64_t &tick) {
 }
 
 void FTL::format(LPNRange &range, uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL);
+
   pFTL->format(range, tick);
 
   tick += applyLatency(CPU::FTL, CPU::FORMAT);
@@ -122,6 +240,21 @@ void FTL::resetStatValues() {
   pPAL->resetStatValues();
 }
 
+void FTL::getMemoryUsage(std::vector<MemoryUsage> &list, std::string prefix) {
+  pFTL->getMemoryUsage(list, prefix + "ftl.");
+  pPAL->getMemoryUsage(list, prefix);
+}
+
+void FTL::saveState(std::ostream &out) {
+  pFTL->saveState(out);
+  pPAL->saveState(out);
+}
+
+void FTL::loadState(std::istream &in) {
+  pFTL->loadState(in);
+  pPAL->loadState(in);
+}
+
 }  // namespace FTL
 
 }  // namespace SimpleSSD
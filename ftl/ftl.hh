@@ -39,7 +39,7 @@ typedef struct {
   uint32_t pageCountToMaxPerf;  //!< # pages to fully utilize internal parallism
 } Parameter;
 
-class FTL : public StatObject {
+class FTL : public StatObject, public StateObject {
  private:
   Parameter param;
   PAL::PAL *pPAL;
@@ -48,6 +48,10 @@ class FTL : public StatObject {
   AbstractFTL *pFTL;
   DRAM::AbstractDRAM *pDRAM;
 
+  std::string getImageKey();
+  bool loadImage(std::string &, std::string &);
+  void saveImage(std::string &, std::string &);
+
  public:
   FTL(ConfigReader &, DRAM::AbstractDRAM *);
   ~FTL();
@@ -64,6 +68,10 @@ class FTL : public StatObject {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace FTL
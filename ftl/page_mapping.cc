@@ -20,33 +20,54 @@
 #include "ftl/page_mapping.hh"
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <limits>
-#include <random>
+#include <queue>
 
+#include "sim/profile.hh"
+#include "sim/request_trace.hh"
 #include "util/algorithm.hh"
 #include "util/bitset.hh"
+#include "util/memory.hh"
 
 namespace SimpleSSD {
 
 namespace FTL {
 
+// Mapping table entry: block index in upper, page index in lower 32 bits
+static const uint64_t UNMAPPED = std::numeric_limits<uint64_t>::max();
+
+static inline uint64_t packMapping(uint32_t blockIdx, uint32_t pageIdx) {
+  return ((uint64_t)blockIdx << 32) | pageIdx;
+}
+
+static inline uint32_t mappingBlock(uint64_t mapping) {
+  return (uint32_t)(mapping >> 32);
+}
+
+static inline uint32_t mappingPage(uint64_t mapping) {
+  return (uint32_t)mapping;
+}
+
 PageMapping::PageMapping(ConfigReader &c, Parameter &p, PAL::PAL *l,
                          DRAM::AbstractDRAM *d)
     : AbstractFTL(p, l, d),
       pPAL(l),
       conf(c),
+      blocks(param.totalPhysicalBlocks, param.pagesInBlock,
+             param.ioUnitInPage),
+      freeBlocks(param.pageCountToMaxPerf),
+      freeBlockSequence(0),
+      nFreeBlocks(0),
       lastFreeBlock(param.pageCountToMaxPerf),
       lastFreeBlockIOMap(param.ioUnitInPage),
-      bReclaimMore(false) {
-  blocks.reserve(param.totalPhysicalBlocks);
-  table.reserve(param.totalLogicalBlocks * param.pagesInBlock);
-
+      bReclaimMore(false),
+      rng(getRandomStream(RANDOM_FTL_GC)) {
   for (uint32_t i = 0; i < param.totalPhysicalBlocks; i++) {
-    freeBlocks.emplace_back(Block(i, param.pagesInBlock, param.ioUnitInPage));
+    releaseFreeBlock(i);
   }
 
-  nFreeBlocks = param.totalPhysicalBlocks;
-
   status.totalLogicalPages = param.totalLogicalBlocks * param.pagesInBlock;
 
   // Allocate free blocks
@@ -60,9 +81,117 @@ PageMapping::PageMapping(ConfigReader &c, Parameter &p, PAL::PAL *l,
 
   bRandomTweak = conf.readBoolean(CONFIG_FTL, FTL_USE_RANDOM_IO_TWEAK);
   bitsetSize = bRandomTweak ? param.ioUnitInPage : 1;
+
+  table.resize(status.totalLogicalPages * bitsetSize, UNMAPPED);
+  nMappedPages = 0;
+
+  gcMode = (GC_MODE)conf.readInt(CONFIG_FTL, FTL_GC_MODE);
+  gcPolicy = (EVICT_POLICY)conf.readInt(CONFIG_FTL, FTL_GC_EVICT_POLICY);
+  dChoiceParam = conf.readUint(CONFIG_FTL, FTL_GC_D_CHOICE_PARAM);
+  gcThreshold = conf.readFloat(CONFIG_FTL, FTL_GC_THRESHOLD_RATIO);
+  gcReclaimThreshold = conf.readFloat(CONFIG_FTL, FTL_GC_RECLAIM_THRESHOLD);
+  eraseThreshold = conf.readUint(CONFIG_FTL, FTL_BAD_BLOCK_THRESHOLD);
+
+  bgcEnable = conf.readBoolean(CONFIG_FTL, FTL_BGC_ENABLE);
+  bgcRunning = false;
+  bgcIdleTime = conf.readUint(CONFIG_FTL, FTL_BGC_IDLE_TIME);
+  bgcThreshold = conf.readFloat(CONFIG_FTL, FTL_BGC_THRESHOLD_RATIO);
+  bgcReclaimThreshold = conf.readFloat(CONFIG_FTL, FTL_BGC_RECLAIM_THRESHOLD);
+  lastRequestAt = 0;
+  bgcEvent = allocate([this](uint64_t now) { backgroundGC(now); });
+
+  igcEnable = conf.readBoolean(CONFIG_FTL, FTL_IGC_ENABLE);
+  igcPages = conf.readUint(CONFIG_FTL, FTL_IGC_PAGES);
+  gcVictimIndex = 0;
+  gcPageIndex = 0;
+  igcChecked = false;
 }
 
-PageMapping::~PageMapping() {}
+PageMapping::~PageMapping() {
+  deallocate(bgcEvent);
+}
+
+/**
+ * Sequential filling of clean FTL. getLastFreeBlock() moves to next parallel
+ * unit on every full page write, so k-th write goes to unit (first + k) % P.
+ * Location of each LPN is computed directly instead of calling
+ * writeInternal() per page. Blocks are allocated in same order as
+ * writeInternal() does, so resulting state is identical.
+ */
+void PageMapping::fillSequential(uint64_t nPages) {
+  uint32_t units = param.pageCountToMaxPerf;
+  uint64_t pages = param.pagesInBlock;
+  std::vector<std::vector<uint32_t>> unitBlocks(units);
+  std::vector<uint64_t> count(units, 0);
+  uint32_t first;
+  bool allocated = true;
+
+  if (nPages == 0) {
+    return;
+  }
+
+  if (nMappedPages > 0) {
+    panic("Sequential filling requires clean FTL");
+  }
+
+  // First write, same as getLastFreeBlock() with all I/O units
+  if (!bRandomTweak || lastFreeBlockIOMap.any()) {
+    lastFreeBlockIndex = (lastFreeBlockIndex + 1) % units;
+  }
+
+  lastFreeBlockIOMap.set();
+  first = lastFreeBlockIndex;
+
+  // j-th unit in write order is (first + j) % units
+  for (uint32_t j = 0; j < units && j < nPages; j++) {
+    count.at(j) = (nPages - 1 - j) / units + 1;
+    unitBlocks.at(j).push_back(lastFreeBlock.at((first + j) % units));
+  }
+
+  // New block is taken at first write after current block becomes full
+  for (uint64_t m = 1; allocated; m++) {
+    allocated = false;
+
+    for (uint32_t j = 0; j < units; j++) {
+      if (count.at(j) > m * pages) {
+        unitBlocks.at(j).push_back(getFreeBlock((first + j) % units));
+        allocated = true;
+        bReclaimMore = true;
+      }
+    }
+  }
+
+  // Fill blocks
+  for (uint32_t j = 0; j < units; j++) {
+    auto &list = unitBlocks.at(j);
+
+    for (uint64_t b = 0; b < list.size(); b++) {
+      blocks[list.at(b)].fill(MIN(pages, count.at(j) - b * pages), bitsetSize,
+                              j + b * pages * units, units);
+    }
+
+    if (list.size() > 0) {
+      lastFreeBlock.at((first + j) % units) = list.back();
+    }
+  }
+
+  lastFreeBlockIndex = (first + nPages - 1) % units;
+
+  // Mapping table, in LPN order
+  for (uint64_t lpn = 0; lpn < nPages; lpn++) {
+    uint64_t w = lpn / units;
+    uint64_t mapping = packMapping(unitBlocks.at(lpn % units).at(w / pages),
+                                   (uint32_t)(w % pages));
+
+    std::fill_n(table.begin() + lpn * bitsetSize, bitsetSize, mapping);
+  }
+
+  nMappedPages = nPages;
+
+  if (freeBlockRatio() < gcThreshold) {
+    panic("ftl: GC triggered while in initialization");
+  }
+}
 
 bool PageMapping::initialize() {
   uint64_t nPagesToWarmup;
@@ -105,26 +234,20 @@ bool PageMapping::initialize() {
              nPagesToInvalidate,
              nPagesToInvalidate * 100.f / nTotalLogicalPages);
 
+  Random gen = getRandomStream(RANDOM_FTL_FILL);
+
   req.ioFlag.set();
 
   // Step 1. Filling
   if (mode == FILLING_MODE_0 || mode == FILLING_MODE_1) {
     // Sequential
-    for (uint64_t i = 0; i < nPagesToWarmup; i++) {
-      tick = 0;
-      req.lpn = i;
-      writeInternal(req, tick, false);
-    }
+    fillSequential(nPagesToWarmup);
   }
   else {
     // Random
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, nTotalLogicalPages - 1);
-
     for (uint64_t i = 0; i < nPagesToWarmup; i++) {
       tick = 0;
-      req.lpn = dist(gen);
+      req.lpn = gen.next(nTotalLogicalPages);
       writeInternal(req, tick, false);
     }
   }
@@ -142,25 +265,17 @@ bool PageMapping::initialize() {
     // Random
     // We can successfully restrict range of LPN to create exact number of
     // invalid pages because we wrote in sequential mannor in step 1.
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, nPagesToWarmup - 1);
-
     for (uint64_t i = 0; i < nPagesToInvalidate; i++) {
       tick = 0;
-      req.lpn = dist(gen);
+      req.lpn = gen.next(nPagesToWarmup);
       writeInternal(req, tick, false);
     }
   }
   else {
     // Random
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, nTotalLogicalPages - 1);
-
     for (uint64_t i = 0; i < nPagesToInvalidate; i++) {
       tick = 0;
-      req.lpn = dist(gen);
+      req.lpn = gen.next(nTotalLogicalPages);
       writeInternal(req, tick, false);
     }
   }
@@ -199,6 +314,8 @@ void PageMapping::read(Request &req, uint64_t &tick) {
   }
 
   tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::READ);
+
+  updateIdleTimer(tick);
 }
 
 void PageMapping::write(Request &req, uint64_t &tick) {
@@ -217,6 +334,8 @@ void PageMapping::write(Request &req, uint64_t &tick) {
   }
 
   tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::WRITE);
+
+  updateIdleTimer(tick);
 }
 
 void PageMapping::trim(Request &req, uint64_t &tick) {
@@ -230,6 +349,8 @@ void PageMapping::trim(Request &req, uint64_t &tick) {
              req.lpn, begin, tick, tick - begin);
 
   tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::TRIM);
+
+  updateIdleTimer(tick);
 }
 
 void PageMapping::format(LPNRange &range, uint64_t &tick) {
@@ -238,30 +359,41 @@ void PageMapping::format(LPNRange &range, uint64_t &tick) {
 
   req.ioFlag.set();
 
-  for (auto iter = table.begin(); iter != table.end();) {
-    if (iter->first >= range.slpn && iter->first < range.slpn + range.nlp) {
-      auto &mappingList = iter->second;
+  // Victims of GC in progress may hold pages in range
+  if (gcVictims.size() > 0) {
+    doIncrementalGC(std::numeric_limits<uint64_t>::max(), tick);
+  }
 
-      // Do trim
-      for (uint32_t idx = 0; idx < bitsetSize; idx++) {
-        auto &mapping = mappingList.at(idx);
-        auto block = blocks.find(mapping.first);
+  for (uint64_t lpn = range.slpn; lpn < range.slpn + range.nlp; lpn++) {
+    if (!isMapped(lpn)) {
+      continue;
+    }
 
-        if (block == blocks.end()) {
-          panic("Block is not in use");
-        }
+    uint64_t *mappingList = table.data() + lpn * bitsetSize;
 
-        block->second.invalidate(mapping.second, idx);
+    // Do trim
+    for (uint32_t idx = 0; idx < bitsetSize; idx++) {
+      uint64_t &mapping = mappingList[idx];
 
-        // Collect block indices
-        list.push_back(mapping.first);
+      if (mapping == UNMAPPED) {
+        continue;
       }
 
-      iter = table.erase(iter);
-    }
-    else {
-      iter++;
+      Block &block = blocks[mappingBlock(mapping)];
+
+      if (block.getState() == BLOCK_FREE) {
+        panic("Block is not in use");
+      }
+
+      block.invalidate(mappingPage(mapping), idx);
+
+      // Collect block indices
+      list.push_back(mappingBlock(mapping));
+
+      mapping = UNMAPPED;
     }
+
+    nMappedPages--;
   }
 
   // Get blocks to erase
@@ -279,13 +411,13 @@ Status *PageMapping::getStatus(uint64_t lpnBegin, uint64_t lpnEnd) {
   status.freePhysicalBlocks = nFreeBlocks;
 
   if (lpnBegin == 0 && lpnEnd >= status.totalLogicalPages) {
-    status.mappedLogicalPages = table.size();
+    status.mappedLogicalPages = nMappedPages;
   }
   else {
     status.mappedLogicalPages = 0;
 
     for (uint64_t lpn = lpnBegin; lpn < lpnEnd; lpn++) {
-      if (table.count(lpn) > 0) {
+      if (isMapped(lpn)) {
         status.mappedLogicalPages++;
       }
     }
@@ -298,10 +430,41 @@ float PageMapping::freeBlockRatio() {
   return (float)nFreeBlocks / param.totalPhysicalBlocks;
 }
 
+bool PageMapping::isMapped(uint64_t lpn) {
+  if (lpn >= status.totalLogicalPages) {
+    return false;
+  }
+
+  for (uint32_t idx = 0; idx < bitsetSize; idx++) {
+    if (table[lpn * bitsetSize + idx] != UNMAPPED) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 uint32_t PageMapping::convertBlockIdx(uint32_t blockIdx) {
   return blockIdx % param.pageCountToMaxPerf;
 }
 
+// std heap functions build max-heap, so order by greater to pop least worn
+bool PageMapping::freeBlockGreater(const FreeBlock &a, const FreeBlock &b) {
+  return a.eraseCount > b.eraseCount ||
+         (a.eraseCount == b.eraseCount && a.sequence > b.sequence);
+}
+
+// Block must be erased
+void PageMapping::releaseFreeBlock(uint32_t blockIndex) {
+  auto &heap = freeBlocks.at(convertBlockIdx(blockIndex));
+
+  heap.push_back(
+      {blocks[blockIndex].getEraseCount(), blockIndex, freeBlockSequence++});
+  std::push_heap(heap.begin(), heap.end(), freeBlockGreater);
+
+  nFreeBlocks++;
+}
+
 uint32_t PageMapping::getFreeBlock(uint32_t idx) {
   uint32_t blockIndex = 0;
 
@@ -310,33 +473,31 @@ uint32_t PageMapping::getFreeBlock(uint32_t idx) {
   }
 
   if (nFreeBlocks > 0) {
-    // Search block which is blockIdx % param.pageCountToMaxPerf == idx
-    auto iter = freeBlocks.begin();
+    // Least worn block which is blockIdx % param.pageCountToMaxPerf == idx
+    auto *heap = &freeBlocks.at(idx);
 
-    for (; iter != freeBlocks.end(); iter++) {
-      blockIndex = iter->getBlockIndex();
-
-      if (blockIndex % param.pageCountToMaxPerf == idx) {
-        break;
+    // Sanity check
+    if (heap->empty()) {
+      // Just use least worn one of all parallel units
+      for (auto &iter : freeBlocks) {
+        if (!iter.empty() &&
+            (heap->empty() || freeBlockGreater(heap->front(), iter.front()))) {
+          heap = &iter;
+        }
       }
     }
 
-    // Sanity check
-    if (iter == freeBlocks.end()) {
-      // Just use first one
-      iter = freeBlocks.begin();
-      blockIndex = iter->getBlockIndex();
-    }
+    blockIndex = heap->front().blockIndex;
 
-    // Insert found block to block list
-    if (blocks.find(blockIndex) != blocks.end()) {
+    if (blocks[blockIndex].getState() != BLOCK_FREE) {
       panic("Corrupted");
     }
 
-    blocks.emplace(blockIndex, std::move(*iter));
+    blocks[blockIndex].setState(BLOCK_OPEN);
 
-    // Remove found block from free block list
-    freeBlocks.erase(iter);
+    // Remove found block from free block pool
+    std::pop_heap(heap->begin(), heap->end(), freeBlockGreater);
+    heap->pop_back();
     nFreeBlocks--;
   }
   else {
@@ -361,15 +522,15 @@ uint32_t PageMapping::getLastFreeBlock(Bitset &iomap) {
     lastFreeBlockIOMap |= iomap;
   }
 
-  auto freeBlock = blocks.find(lastFreeBlock.at(lastFreeBlockIndex));
+  Block &freeBlock = blocks[lastFreeBlock.at(lastFreeBlockIndex)];
 
   // Sanity check
-  if (freeBlock == blocks.end()) {
+  if (freeBlock.getState() == BLOCK_FREE) {
     panic("Corrupted");
   }
 
   // If current free block is full, get next block
-  if (freeBlock->second.getNextWritePageIndex() == param.pagesInBlock) {
+  if (freeBlock.getNextWritePageIndex() == param.pagesInBlock) {
     lastFreeBlock.at(lastFreeBlockIndex) = getFreeBlock(lastFreeBlockIndex);
 
     bReclaimMore = true;
@@ -387,29 +548,17 @@ void PageMapping::calculateVictimWeight(
   weight.reserve(blocks.size());
 
   switch (policy) {
-    case POLICY_GREEDY:
-    case POLICY_RANDOM:
-    case POLICY_DCHOICE:
-      for (auto &iter : blocks) {
-        if (iter.second.getNextWritePageIndex() != param.pagesInBlock) {
-          continue;
-        }
-
-        weight.push_back({iter.first, iter.second.getValidPageCountRaw()});
-      }
-
-      break;
     case POLICY_COST_BENEFIT:
       for (auto &iter : blocks) {
-        if (iter.second.getNextWritePageIndex() != param.pagesInBlock) {
+        if (iter.getState() != BLOCK_FULL) {
           continue;
         }
 
-        temp = (float)(iter.second.getValidPageCountRaw()) / param.pagesInBlock;
+        temp = (float)(iter.getValidPageCountRaw()) / param.pagesInBlock;
 
         weight.push_back(
-            {iter.first,
-             temp / ((1 - temp) * (tick - iter.second.getLastAccessedTime()))});
+            {iter.getBlockIndex(),
+             temp / ((1 - temp) * (tick - iter.getLastAccessedTime()))});
       }
 
       break;
@@ -420,24 +569,14 @@ void PageMapping::calculateVictimWeight(
 
 void PageMapping::selectVictimBlock(std::vector<uint32_t> &list,
                                     uint64_t &tick) {
-  static const GC_MODE mode = (GC_MODE)conf.readInt(CONFIG_FTL, FTL_GC_MODE);
-  static const EVICT_POLICY policy =
-      (EVICT_POLICY)conf.readInt(CONFIG_FTL, FTL_GC_EVICT_POLICY);
-  static uint32_t dChoiceParam =
-      conf.readUint(CONFIG_FTL, FTL_GC_D_CHOICE_PARAM);
   uint64_t nBlocks = conf.readUint(CONFIG_FTL, FTL_GC_RECLAIM_BLOCK);
-  std::vector<std::pair<uint32_t, float>> weight;
-
-  list.clear();
 
   // Calculate number of blocks to reclaim
-  if (mode == GC_MODE_0) {
+  if (gcMode == GC_MODE_0) {
     // DO NOTHING
   }
-  else if (mode == GC_MODE_1) {
-    static const float t = conf.readFloat(CONFIG_FTL, FTL_GC_RECLAIM_THRESHOLD);
-
-    nBlocks = param.totalPhysicalBlocks * t - nFreeBlocks;
+  else if (gcMode == GC_MODE_1) {
+    nBlocks = param.totalPhysicalBlocks * gcReclaimThreshold - nFreeBlocks;
   }
   else {
     panic("Invalid GC mode");
@@ -450,172 +589,467 @@ void PageMapping::selectVictimBlock(std::vector<uint32_t> &list,
     bReclaimMore = false;
   }
 
-  // Calculate weights of all blocks
-  calculateVictimWeight(weight, policy, tick);
+  selectVictimBlock(list, nBlocks, tick);
+}
+
+void PageMapping::selectVictimBlock(std::vector<uint32_t> &list,
+                                    uint64_t nBlocks, uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL_GC);
 
-  if (policy == POLICY_RANDOM || policy == POLICY_DCHOICE) {
+  std::vector<std::pair<uint32_t, float>> weight;
+
+  list.clear();
+
+  if (gcPolicy == POLICY_GREEDY) {
+    // Full blocks are already sorted by valid page count
+    blocks.getLeastValidBlocks(list, nBlocks);
+  }
+  else if (gcPolicy == POLICY_RANDOM || gcPolicy == POLICY_DCHOICE) {
     uint64_t randomRange =
-        policy == POLICY_RANDOM ? nBlocks : dChoiceParam * nBlocks;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint64_t> dist(0, weight.size() - 1);
-    std::vector<std::pair<uint32_t, float>> selected;
-
-    while (selected.size() < randomRange) {
-      uint64_t idx = dist(gen);
-
-      if (weight.at(idx).first < std::numeric_limits<uint32_t>::max()) {
-        selected.push_back(weight.at(idx));
-        weight.at(idx).first = std::numeric_limits<uint32_t>::max();
-      }
-    }
+        gcPolicy == POLICY_RANDOM ? nBlocks : dChoiceParam * nBlocks;
+
+    // Sample candidates directly from full blocks
+    blocks.sampleFullBlocks(list, randomRange, rng);
+
+    // Select victims from the candidates with the least valid pages
+    nBlocks = MIN(nBlocks, list.size());
 
-    weight = std::move(selected);
+    std::partial_sort(list.begin(), list.begin() + nBlocks, list.end(),
+                      [this](uint32_t a, uint32_t b) -> bool {
+                        return blocks[a].getValidPageCountRaw() <
+                               blocks[b].getValidPageCountRaw();
+                      });
+
+    list.resize(nBlocks);
   }
+  else {
+    // Calculate weights of all blocks
+    calculateVictimWeight(weight, gcPolicy, tick);
 
-  // Sort weights
-  std::sort(
-      weight.begin(), weight.end(),
-      [](std::pair<uint32_t, float> a, std::pair<uint32_t, float> b) -> bool {
-        return a.second < b.second;
-      });
+    // Select victims from the blocks with the lowest weight
+    nBlocks = MIN(nBlocks, weight.size());
 
-  // Select victims from the blocks with the lowest weight
-  nBlocks = MIN(nBlocks, weight.size());
+    std::partial_sort(
+        weight.begin(), weight.begin() + nBlocks, weight.end(),
+        [](std::pair<uint32_t, float> a, std::pair<uint32_t, float> b)
+            -> bool { return a.second < b.second; });
 
-  for (uint64_t i = 0; i < nBlocks; i++) {
-    list.push_back(weight.at(i).first);
+    for (uint64_t i = 0; i < nBlocks; i++) {
+      list.push_back(weight.at(i).first);
+    }
   }
 
   tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::SELECT_VICTIM_BLOCK);
 }
 
-void PageMapping::doGarbageCollection(std::vector<uint32_t> &blocksToReclaim,
-                                      uint64_t &tick) {
+/**
+ * Copy valid pages of victim block, starting from pageIndex, until limit
+ * (super)page copies are collected. pageIndex and limit are updated to resume
+ * later. Returns true when no valid page is left in the block.
+ */
+bool PageMapping::collectValidPages(uint32_t blockIdx, uint32_t &pageIndex,
+                                    uint64_t &limit, GCRequests &gc,
+                                    uint64_t &tick) {
   PAL::Request req(param.ioUnitInPage);
-  std::vector<PAL::Request> readRequests;
-  std::vector<PAL::Request> writeRequests;
-  std::vector<PAL::Request> eraseRequests;
   std::vector<uint64_t> lpns;
   Bitset bit(param.ioUnitInPage);
-  uint64_t beginAt;
-  uint64_t readFinishedAt = tick;
-  uint64_t writeFinishedAt = tick;
-  uint64_t eraseFinishedAt = tick;
+  Block &block = blocks[blockIdx];
 
-  if (blocksToReclaim.size() == 0) {
-    return;
+  if (block.getState() != BLOCK_FULL) {
+    panic("Invalid block");
   }
 
-  // For all blocks to reclaim, collecting request structure only
-  for (auto &iter : blocksToReclaim) {
-    auto block = blocks.find(iter);
+  for (; pageIndex < param.pagesInBlock && limit > 0; pageIndex++) {
+    // Valid?
+    if (!block.getPageInfo(pageIndex, lpns, bit)) {
+      continue;
+    }
 
-    if (block == blocks.end()) {
-      panic("Invalid block");
+    if (!bRandomTweak) {
+      bit.set();
     }
 
-    // Copy valid pages to free block
-    for (uint32_t pageIndex = 0; pageIndex < param.pagesInBlock; pageIndex++) {
-      // Valid?
-      if (block->second.getPageInfo(pageIndex, lpns, bit)) {
-        if (!bRandomTweak) {
-          bit.set();
+    // Retrive free block
+    uint32_t newBlockIdx = getLastFreeBlock(bit);
+    Block &freeBlock = blocks[newBlockIdx];
+
+    // Issue Read
+    req.blockIndex = blockIdx;
+    req.pageIndex = pageIndex;
+    req.ioFlag = bit;
+
+    gc.reads.push_back(req);
+
+    // Update mapping table
+    for (uint32_t idx = 0; idx < bitsetSize; idx++) {
+      if (bit.test(idx)) {
+        // Invalidate
+        block.invalidate(pageIndex, idx);
+
+        if (!isMapped(lpns.at(idx))) {
+          panic("Invalid mapping table entry");
         }
 
-        // Retrive free block
-        auto freeBlock = blocks.find(getLastFreeBlock(bit));
+        uint64_t *mappingList = table.data() + lpns.at(idx) * bitsetSize;
 
-        // Issue Read
-        req.blockIndex = block->first;
-        req.pageIndex = pageIndex;
-        req.ioFlag = bit;
+        pDRAM->read(mappingList, 8 * param.ioUnitInPage, tick);
 
-        readRequests.push_back(req);
+        uint32_t newPageIdx = freeBlock.getNextWritePageIndex(idx);
 
-        // Update mapping table
-        uint32_t newBlockIdx = freeBlock->first;
+        mappingList[idx] = packMapping(newBlockIdx, newPageIdx);
 
-        for (uint32_t idx = 0; idx < bitsetSize; idx++) {
-          if (bit.test(idx)) {
-            // Invalidate
-            block->second.invalidate(pageIndex, idx);
+        freeBlock.write(newPageIdx, lpns.at(idx), idx, tick);
 
-            auto mappingList = table.find(lpns.at(idx));
+        // Issue Write
+        req.blockIndex = newBlockIdx;
+        req.pageIndex = newPageIdx;
 
-            if (mappingList == table.end()) {
-              panic("Invalid mapping table entry");
-            }
+        if (bRandomTweak) {
+          req.ioFlag.reset();
+          req.ioFlag.set(idx);
+        }
+        else {
+          req.ioFlag.set();
+        }
 
-            pDRAM->read(&(*mappingList), 8 * param.ioUnitInPage, tick);
+        gc.writes.push_back(req);
+        gc.writeSource.push_back((uint32_t)gc.reads.size() - 1);
 
-            auto &mapping = mappingList->second.at(idx);
+        stat.validPageCopies++;
+      }
+    }
 
-            uint32_t newPageIdx = freeBlock->second.getNextWritePageIndex(idx);
+    stat.validSuperPageCopies++;
+    limit--;
+  }
 
-            mapping.first = newBlockIdx;
-            mapping.second = newPageIdx;
+  return block.getValidPageCountRaw() == 0;
+}
 
-            freeBlock->second.write(newPageIdx, lpns.at(idx), idx, beginAt);
+// Erase victim after valid pages collected since firstRead are read
+void PageMapping::collectErase(uint32_t blockIdx, uint32_t firstRead,
+                               GCRequests &gc) {
+  PAL::Request req(param.ioUnitInPage);
 
-            // Issue Write
-            req.blockIndex = newBlockIdx;
-            req.pageIndex = newPageIdx;
+  req.blockIndex = blockIdx;
+  req.pageIndex = 0;
+  req.ioFlag.set();
 
-            if (bRandomTweak) {
-              req.ioFlag.reset();
-              req.ioFlag.set(idx);
-            }
-            else {
-              req.ioFlag.set();
-            }
+  gc.erases.push_back(req);
+  gc.eraseWait.push_back({firstRead, (uint32_t)gc.reads.size()});
+}
 
-            writeRequests.push_back(req);
+/**
+ * Do actual I/O here, as a pipeline instead of read/write/erase phases.
+ * Each copy is programmed as soon as its own read finishes, but not before
+ * previous program to same parallel unit completes, to keep program order in
+ * block. Each victim is erased as soon as its last valid page is read. So PAL
+ * overlaps GC work on different channels/dies.
+ * Reads are issued first, then programs and erases together in order of
+ * start tick. This handles PAL2 limitation (SIGSEGV, infinite loop, or
+ * so-on)
+ */
+void PageMapping::issueGCRequests(GCRequests &gc, uint64_t &tick) {
+  // Start tick, and parallel unit of program or units + index of erase
+  typedef std::pair<uint64_t, uint32_t> Pending;
+
+  uint32_t units = param.pageCountToMaxPerf;
+  std::vector<uint64_t> readFinishedAt(gc.reads.size());
+  std::vector<std::vector<uint32_t>> unitWrites(units);
+  std::vector<uint32_t> unitHead(units, 0);
+  std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>>
+      queue;
+  uint64_t beginAt;
+  uint64_t finishedAt = tick;
 
-            stat.validPageCopies++;
-          }
-        }
+  for (uint32_t i = 0; i < gc.reads.size(); i++) {
+    beginAt = tick;
 
-        stat.validSuperPageCopies++;
+    pPAL->read(gc.reads.at(i), beginAt);
+
+    readFinishedAt.at(i) = beginAt;
+  }
+
+  // Programs of each unit in collected (page) order
+  for (uint32_t i = 0; i < gc.writes.size(); i++) {
+    unitWrites.at(convertBlockIdx(gc.writes.at(i).blockIndex)).push_back(i);
+  }
+
+  for (uint32_t i = 0; i < units; i++) {
+    if (unitWrites.at(i).size() > 0) {
+      queue.push(
+          {readFinishedAt.at(gc.writeSource.at(unitWrites.at(i).front())), i});
+    }
+  }
+
+  for (uint32_t i = 0; i < gc.erases.size(); i++) {
+    auto &wait = gc.eraseWait.at(i);
+
+    beginAt = tick;
+
+    for (uint32_t j = wait.first; j < wait.second; j++) {
+      beginAt = MAX(beginAt, readFinishedAt.at(j));
+    }
+
+    queue.push({beginAt, units + i});
+  }
+
+  // Next program of a unit becomes ready when previous one completes, which
+  // is never earlier than current one, so requests go to PAL in tick order
+  while (!queue.empty()) {
+    Pending next = queue.top();
+
+    queue.pop();
+
+    beginAt = next.first;
+
+    if (next.second < units) {
+      auto &list = unitWrites.at(next.second);
+      uint32_t &head = unitHead.at(next.second);
+
+      pPAL->write(gc.writes.at(list.at(head)), beginAt);
+
+      if (++head < list.size()) {
+        queue.push(
+            {MAX(beginAt, readFinishedAt.at(gc.writeSource.at(list.at(head)))),
+             next.second});
       }
     }
+    else {
+      eraseInternal(gc.erases.at(next.second - units), beginAt);
+    }
 
-    // Erase block
-    req.blockIndex = block->first;
-    req.pageIndex = 0;
-    req.ioFlag.set();
+    finishedAt = MAX(finishedAt, beginAt);
+  }
 
-    eraseRequests.push_back(req);
+  tick = finishedAt;
+}
+
+/**
+ * At most one victim per parallel unit, so each channel/die only erases one
+ * block at a time. Full blocks are ranked by evict policy, and the first one
+ * of each unit with invalid pages is taken. Copying fully valid block only
+ * consumes free blocks.
+ */
+void PageMapping::selectVictimBlockPerUnit(std::vector<uint32_t> &list,
+                                           uint64_t &tick) {
+  std::vector<uint32_t> candidates;
+  std::vector<bool> found(param.pageCountToMaxPerf, false);
+
+  list.clear();
+
+  if (gcPolicy == POLICY_GREEDY) {
+    ProfileScope scope(PROFILE_FTL_GC);
+
+    blocks.getLeastValidBlockPerUnit(candidates, param.pageCountToMaxPerf);
+
+    tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::SELECT_VICTIM_BLOCK);
+  }
+  else {
+    selectVictimBlock(candidates, blocks.getFullBlockCount(), tick);
   }
 
-  // Do actual I/O here
-  // This handles PAL2 limitation (SIGSEGV, infinite loop, or so-on)
-  for (auto &iter : readRequests) {
-    beginAt = tick;
+  for (auto &iter : candidates) {
+    uint32_t unit = convertBlockIdx(iter);
+
+    if (!found.at(unit) && blocks[iter].getDirtyPageCount() > 0) {
+      found.at(unit) = true;
+      list.push_back(iter);
+    }
+  }
+}
+
+void PageMapping::doGarbageCollection(std::vector<uint32_t> &blocksToReclaim,
+                                      uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL_GC);
 
-    pPAL->read(iter, beginAt);
+  GCRequests gc;
 
-    readFinishedAt = MAX(readFinishedAt, beginAt);
+  if (blocksToReclaim.size() == 0) {
+    return;
   }
 
-  for (auto &iter : writeRequests) {
-    beginAt = readFinishedAt;
+  // For all blocks to reclaim, collecting request structure only
+  for (auto &iter : blocksToReclaim) {
+    uint32_t pageIndex = 0;
+    uint32_t firstRead = (uint32_t)gc.reads.size();
+    uint64_t limit = param.pagesInBlock;
 
-    pPAL->write(iter, beginAt);
+    // Copy valid pages to free block
+    collectValidPages(iter, pageIndex, limit, gc, tick);
 
-    writeFinishedAt = MAX(writeFinishedAt, beginAt);
+    // Erase block
+    collectErase(iter, firstRead, gc);
   }
 
-  for (auto &iter : eraseRequests) {
-    beginAt = readFinishedAt;
+  issueGCRequests(gc, tick);
 
-    eraseInternal(iter, beginAt);
+  tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::DO_GARBAGE_COLLECTION);
+}
 
-    eraseFinishedAt = MAX(eraseFinishedAt, beginAt);
+// Valid (super)pages left to copy in GC in progress
+uint64_t PageMapping::getGCRemainingPages() {
+  uint64_t remaining = 0;
+
+  for (uint32_t i = gcVictimIndex; i < gcVictims.size(); i++) {
+    remaining += blocks[gcVictims.at(i)].getValidPageCount();
+  }
+
+  return remaining;
+}
+
+/**
+ * Pages to copy per host write in incremental GC. igcPages at gcThreshold,
+ * growing inversely with free block ratio. When the free blocks left (except
+ * one active block per parallel unit) cannot hold all remaining copies,
+ * returns the remaining copies so GC completes before free blocks run out.
+ */
+uint64_t PageMapping::calculateGCPace() {
+  uint64_t remaining = getGCRemainingPages();
+  uint64_t spare = 0;
+  uint64_t pace;
+
+  if (nFreeBlocks > param.pageCountToMaxPerf) {
+    spare = (uint64_t)(nFreeBlocks - param.pageCountToMaxPerf) *
+            param.pagesInBlock;
+  }
+
+  if (remaining >= spare || nFreeBlocks == 0) {
+    return MAX(remaining, 1);
+  }
+
+  pace = (uint64_t)ceilf(igcPages * gcThreshold / freeBlockRatio());
+
+  return MAX(pace, igcPages);
+}
+
+/**
+ * Advance GC in progress by at most pages (super)page copies. Victims are
+ * erased as soon as their last valid page is copied, so a host write only
+ * waits behind a bounded amount of GC I/O.
+ */
+uint32_t PageMapping::doIncrementalGC(uint64_t pages, uint64_t &tick) {
+  ProfileScope scope(PROFILE_FTL_GC);
+
+  GCRequests gc;
+
+  while (gcVictimIndex < gcVictims.size() && pages > 0) {
+    uint32_t blockIdx = gcVictims.at(gcVictimIndex);
+    uint32_t firstRead = (uint32_t)gc.reads.size();
+
+    if (!collectValidPages(blockIdx, gcPageIndex, pages, gc, tick)) {
+      break;
+    }
+
+    // Erase block
+    collectErase(blockIdx, firstRead, gc);
+
+    gcVictimIndex++;
+    gcPageIndex = 0;
+  }
+
+  issueGCRequests(gc, tick);
+
+  if (gcVictimIndex == gcVictims.size()) {
+    gcVictims.clear();
+    gcVictimIndex = 0;
   }
 
-  tick = MAX(writeFinishedAt, eraseFinishedAt);
   tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::DO_GARBAGE_COLLECTION);
+
+  return (uint32_t)gc.erases.size();
+}
+
+// Only one idle check is pending at a time, backgroundGC() postpones it when
+// another request has arrived since it was scheduled
+void PageMapping::updateIdleTimer(uint64_t tick) {
+  if (!bgcEnable) {
+    return;
+  }
+
+  lastRequestAt = MAX(lastRequestAt, tick);
+
+  if (!scheduled(bgcEvent)) {
+    schedule(bgcEvent, lastRequestAt + bgcIdleTime);
+  }
+}
+
+/**
+ * One round of background GC. Starts when free block ratio is below
+ * bgcThreshold, then continues round by round until bgcReclaimThreshold, as
+ * long as no request arrives. Each round reclaims at most one block per
+ * parallel unit to bound the work a new request can be queued behind.
+ */
+void PageMapping::backgroundGC(uint64_t now) {
+  uint64_t idleAt = lastRequestAt + bgcIdleTime;
+
+  if (now < idleAt) {
+    schedule(bgcEvent, idleAt);
+
+    return;
+  }
+
+  // Finish incremental GC in progress first
+  if (gcVictims.size() > 0) {
+    uint64_t beginAt = now;
+    uint64_t traced = traceRequest(0);
+
+    debugprint(LOG_FTL_PAGE_MAPPING,
+               "GC   | Background | Finish incremental GC");
+
+    uint32_t erased =
+        doIncrementalGC(std::numeric_limits<uint64_t>::max(), beginAt);
+
+    traceRequest(traced);
+
+    bgcRunning = true;
+    stat.bgcCount++;
+    stat.bgcReclaimedBlocks += erased;
+
+    schedule(bgcEvent, beginAt);
+
+    return;
+  }
+
+  float ratio = freeBlockRatio();
+
+  if ((!bgcRunning && ratio >= bgcThreshold) || ratio >= bgcReclaimThreshold) {
+    // Next request will schedule idle check again
+    bgcRunning = false;
+
+    return;
+  }
+
+  std::vector<uint32_t> list;
+  uint64_t beginAt = now;
+  uint64_t traced = traceRequest(0);
+
+  selectVictimBlockPerUnit(list, beginAt);
+
+  if (list.size() == 0) {
+    bgcRunning = false;
+    traceRequest(traced);
+
+    return;
+  }
+
+  debugprint(LOG_FTL_PAGE_MAPPING,
+             "GC   | Background | %u blocks will be reclaimed", list.size());
+
+  doGarbageCollection(list, beginAt);
+
+  debugprint(LOG_FTL_PAGE_MAPPING,
+             "GC   | Done | %" PRIu64 " - %" PRIu64 " (%" PRIu64 ")", now,
+             beginAt, beginAt - now);
+
+  traceRequest(traced);
+
+  bgcRunning = true;
+  stat.bgcCount++;
+  stat.bgcReclaimedBlocks += list.size();
+
+  // Next round after this one, if still idle
+  schedule(bgcEvent, beginAt);
 }
 
 void PageMapping::readInternal(Request &req, uint64_t &tick) {
@@ -623,24 +1057,27 @@ void PageMapping::readInternal(Request &req, uint64_t &tick) {
   uint64_t beginAt;
   uint64_t finishedAt = tick;
 
-  auto mappingList = table.find(req.lpn);
+  if (isMapped(req.lpn)) {
+    uint64_t *mappingList = table.data() + req.lpn * bitsetSize;
+
+    beginAt = tick;
 
-  if (mappingList != table.end()) {
     if (bRandomTweak) {
-      pDRAM->read(&(*mappingList), 8 * req.ioFlag.count(), tick);
+      pDRAM->read(mappingList, 8 * req.ioFlag.count(), tick);
     }
     else {
-      pDRAM->read(&(*mappingList), 8, tick);
+      pDRAM->read(mappingList, 8, tick);
     }
 
+    traceSpan(TRACE_FTL_MAPPING, req.reqSubID, beginAt, tick);
+
     for (uint32_t idx = 0; idx < bitsetSize; idx++) {
       if (req.ioFlag.test(idx) || !bRandomTweak) {
-        auto &mapping = mappingList->second.at(idx);
+        uint64_t mapping = mappingList[idx];
 
-        if (mapping.first < param.totalPhysicalBlocks &&
-            mapping.second < param.pagesInBlock) {
-          palRequest.blockIndex = mapping.first;
-          palRequest.pageIndex = mapping.second;
+        if (mapping != UNMAPPED) {
+          palRequest.blockIndex = mappingBlock(mapping);
+          palRequest.pageIndex = mappingPage(mapping);
 
           if (bRandomTweak) {
             palRequest.ioFlag.reset();
@@ -650,15 +1087,15 @@ void PageMapping::readInternal(Request &req, uint64_t &tick) {
             palRequest.ioFlag.set();
           }
 
-          auto block = blocks.find(palRequest.blockIndex);
+          Block &block = blocks[palRequest.blockIndex];
 
-          if (block == blocks.end()) {
+          if (block.getState() == BLOCK_FREE) {
             panic("Block is not in use");
           }
 
           beginAt = tick;
 
-          block->second.read(palRequest.pageIndex, idx, beginAt);
+          block.read(palRequest.pageIndex, idx, beginAt);
           pPAL->read(palRequest, beginAt);
 
           finishedAt = MAX(finishedAt, beginAt);
@@ -673,57 +1110,49 @@ void PageMapping::readInternal(Request &req, uint64_t &tick) {
 
 void PageMapping::writeInternal(Request &req, uint64_t &tick, bool sendToPAL) {
   PAL::Request palRequest(req);
-  std::unordered_map<uint32_t, Block>::iterator block;
-  auto mappingList = table.find(req.lpn);
+  uint64_t *mappingList;
   uint64_t beginAt;
   uint64_t finishedAt = tick;
   bool readBeforeWrite = false;
 
-  if (mappingList != table.end()) {
+  if (req.lpn >= status.totalLogicalPages) {
+    panic("LPN %" PRIu64 " out of range", req.lpn);
+  }
+
+  mappingList = table.data() + req.lpn * bitsetSize;
+
+  if (isMapped(req.lpn)) {
     for (uint32_t idx = 0; idx < bitsetSize; idx++) {
       if (req.ioFlag.test(idx) || !bRandomTweak) {
-        auto &mapping = mappingList->second.at(idx);
-
-        if (mapping.first < param.totalPhysicalBlocks &&
-            mapping.second < param.pagesInBlock) {
-          block = blocks.find(mapping.first);
+        uint64_t mapping = mappingList[idx];
 
+        if (mapping != UNMAPPED) {
           // Invalidate current page
-          block->second.invalidate(mapping.second, idx);
+          blocks[mappingBlock(mapping)].invalidate(mappingPage(mapping), idx);
         }
       }
     }
   }
   else {
-    // Create empty mapping
-    auto ret = table.emplace(
-        req.lpn,
-        std::vector<std::pair<uint32_t, uint32_t>>(
-            bitsetSize, {param.totalPhysicalBlocks, param.pagesInBlock}));
-
-    if (!ret.second) {
-      panic("Failed to insert new mapping");
-    }
-
-    mappingList = ret.first;
+    nMappedPages++;
   }
 
   // Write data to free block
-  block = blocks.find(getLastFreeBlock(req.ioFlag));
-
-  if (block == blocks.end()) {
-    panic("No such block");
-  }
+  Block &block = blocks[getLastFreeBlock(req.ioFlag)];
 
   if (sendToPAL) {
+    beginAt = tick;
+
     if (bRandomTweak) {
-      pDRAM->read(&(*mappingList), 8 * req.ioFlag.count(), tick);
-      pDRAM->write(&(*mappingList), 8 * req.ioFlag.count(), tick);
+      pDRAM->read(mappingList, 8 * req.ioFlag.count(), tick);
+      pDRAM->write(mappingList, 8 * req.ioFlag.count(), tick);
     }
     else {
-      pDRAM->read(&(*mappingList), 8, tick);
-      pDRAM->write(&(*mappingList), 8, tick);
+      pDRAM->read(mappingList, 8, tick);
+      pDRAM->write(mappingList, 8, tick);
     }
+
+    traceSpan(TRACE_FTL_MAPPING, req.reqSubID, beginAt, tick);
   }
 
   if (!bRandomTweak && !req.ioFlag.all()) {
@@ -733,19 +1162,19 @@ void PageMapping::writeInternal(Request &req, uint64_t &tick, bool sendToPAL) {
 
   for (uint32_t idx = 0; idx < bitsetSize; idx++) {
     if (req.ioFlag.test(idx) || !bRandomTweak) {
-      uint32_t pageIndex = block->second.getNextWritePageIndex(idx);
-      auto &mapping = mappingList->second.at(idx);
+      uint32_t pageIndex = block.getNextWritePageIndex(idx);
+      uint64_t &mapping = mappingList[idx];
 
       beginAt = tick;
 
-      block->second.write(pageIndex, req.lpn, idx, beginAt);
+      block.write(pageIndex, req.lpn, idx, beginAt);
 
       // Read old data if needed (Only executed when bRandomTweak = false)
       // Maybe some other init procedures want to perform 'partial-write'
       // So check sendToPAL variable
-      if (readBeforeWrite && sendToPAL) {
-        palRequest.blockIndex = mapping.first;
-        palRequest.pageIndex = mapping.second;
+      if (readBeforeWrite && sendToPAL && mapping != UNMAPPED) {
+        palRequest.blockIndex = mappingBlock(mapping);
+        palRequest.pageIndex = mappingPage(mapping);
 
         // We don't need to read old data
         palRequest.ioFlag = req.ioFlag;
@@ -755,11 +1184,10 @@ void PageMapping::writeInternal(Request &req, uint64_t &tick, bool sendToPAL) {
       }
 
       // update mapping to table
-      mapping.first = block->first;
-      mapping.second = pageIndex;
+      mapping = packMapping(block.getBlockIndex(), pageIndex);
 
       if (sendToPAL) {
-        palRequest.blockIndex = block->first;
+        palRequest.blockIndex = block.getBlockIndex();
         palRequest.pageIndex = pageIndex;
 
         if (bRandomTweak) {
@@ -785,110 +1213,146 @@ void PageMapping::writeInternal(Request &req, uint64_t &tick, bool sendToPAL) {
 
   // GC if needed
   // I assumed that init procedure never invokes GC
-  static float gcThreshold = conf.readFloat(CONFIG_FTL, FTL_GC_THRESHOLD_RATIO);
-
-  if (freeBlockRatio() < gcThreshold) {
+  if (gcVictims.size() == 0 && freeBlockRatio() < gcThreshold) {
     if (!sendToPAL) {
       panic("ftl: GC triggered while in initialization");
     }
 
     std::vector<uint32_t> list;
     uint64_t beginAt = tick;
+    uint64_t traced = traceRequest(0);  // GC runs in background
 
     selectVictimBlock(list, beginAt);
 
-    debugprint(LOG_FTL_PAGE_MAPPING,
-               "GC   | On-demand | %u blocks will be reclaimed", list.size());
+    if (igcEnable) {
+      // Only pick victims here, pages are copied over following writes
+      debugprint(LOG_FTL_PAGE_MAPPING,
+                 "GC   | Incremental | %u blocks will be reclaimed",
+                 list.size());
 
-    doGarbageCollection(list, beginAt);
+      gcVictims = list;
+      gcVictimIndex = 0;
+      gcPageIndex = 0;
 
-    debugprint(LOG_FTL_PAGE_MAPPING,
-               "GC   | Done | %" PRIu64 " - %" PRIu64 " (%" PRIu64 ")", tick,
-               beginAt, beginAt - tick);
+      // First GC starts right below threshold, so whether it can be spread
+      // over writes only depends on configuration
+      if (!igcChecked) {
+        uint64_t remaining = getGCRemainingPages();
+
+        igcChecked = true;
+
+        if (remaining > igcPages && calculateGCPace() >= remaining) {
+          warn("ftl: Incremental GC has no free blocks to spread page copies. "
+               "Increase GCThreshold.");
+        }
+      }
+
+      traceRequest(traced);
+    }
+    else {
+      debugprint(LOG_FTL_PAGE_MAPPING,
+                 "GC   | On-demand | %u blocks will be reclaimed",
+                 list.size());
+
+      doGarbageCollection(list, beginAt);
+
+      debugprint(LOG_FTL_PAGE_MAPPING,
+                 "GC   | Done | %" PRIu64 " - %" PRIu64 " (%" PRIu64 ")",
+                 tick, beginAt, beginAt - tick);
+
+      traceRequest(traced);
+      traceSpan(TRACE_FTL_GC, req.reqSubID, tick, beginAt);
+
+      stat.reclaimedBlocks += list.size();
+    }
 
     stat.gcCount++;
-    stat.reclaimedBlocks += list.size();
+  }
+
+  if (gcVictims.size() > 0) {
+    // Continue GC in progress, bounded by pace
+    uint64_t beginAt = tick;
+    uint64_t pages = calculateGCPace();
+    uint64_t traced = traceRequest(0);
+
+    uint32_t erased = doIncrementalGC(pages, beginAt);
+
+    debugprint(LOG_FTL_PAGE_MAPPING,
+               "GC   | Step | %" PRIu64 " pages | %" PRIu64 " - %" PRIu64
+               " (%" PRIu64 ")",
+               pages, tick, beginAt, beginAt - tick);
+
+    traceRequest(traced);
+    traceSpan(TRACE_FTL_GC, req.reqSubID, tick, beginAt);
+
+    stat.igcSteps++;
+    stat.reclaimedBlocks += erased;
   }
 }
 
 void PageMapping::trimInternal(Request &req, uint64_t &tick) {
-  auto mappingList = table.find(req.lpn);
+  if (isMapped(req.lpn)) {
+    uint64_t *mappingList = table.data() + req.lpn * bitsetSize;
 
-  if (mappingList != table.end()) {
     if (bRandomTweak) {
-      pDRAM->read(&(*mappingList), 8 * req.ioFlag.count(), tick);
+      pDRAM->read(mappingList, 8 * req.ioFlag.count(), tick);
     }
     else {
-      pDRAM->read(&(*mappingList), 8, tick);
+      pDRAM->read(mappingList, 8, tick);
     }
 
     // Do trim
     for (uint32_t idx = 0; idx < bitsetSize; idx++) {
-      auto &mapping = mappingList->second.at(idx);
-      auto block = blocks.find(mapping.first);
+      uint64_t &mapping = mappingList[idx];
+
+      if (mapping == UNMAPPED) {
+        continue;
+      }
+
+      Block &block = blocks[mappingBlock(mapping)];
 
-      if (block == blocks.end()) {
+      if (block.getState() == BLOCK_FREE) {
         panic("Block is not in use");
       }
 
-      block->second.invalidate(mapping.second, idx);
+      block.invalidate(mappingPage(mapping), idx);
+
+      // Remove mapping
+      mapping = UNMAPPED;
     }
 
-    // Remove mapping
-    table.erase(mappingList);
+    nMappedPages--;
 
     tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::TRIM_INTERNAL);
   }
 }
 
 void PageMapping::eraseInternal(PAL::Request &req, uint64_t &tick) {
-  static uint64_t threshold =
-      conf.readUint(CONFIG_FTL, FTL_BAD_BLOCK_THRESHOLD);
-  auto block = blocks.find(req.blockIndex);
+  Block &block = blocks[req.blockIndex];
 
   // Sanity checks
-  if (block == blocks.end()) {
+  if (block.getState() == BLOCK_FREE || block.getState() == BLOCK_BAD) {
     panic("No such block");
   }
 
-  if (block->second.getValidPageCount() != 0) {
+  if (block.getValidPageCount() != 0) {
     panic("There are valid pages in victim block");
   }
 
   // Erase block
-  block->second.erase();
+  block.erase();
 
   pPAL->erase(req, tick);
 
   // Check erase count
-  uint32_t erasedCount = block->second.getEraseCount();
+  uint32_t erasedCount = block.getEraseCount();
 
-  if (erasedCount < threshold) {
-    // Reverse search
-    auto iter = freeBlocks.end();
-
-    while (true) {
-      iter--;
-
-      if (iter->getEraseCount() <= erasedCount) {
-        // emplace: insert before pos
-        iter++;
-
-        break;
-      }
-
-      if (iter == freeBlocks.begin()) {
-        break;
-      }
-    }
-
-    // Insert block to free block list
-    freeBlocks.emplace(iter, std::move(block->second));
-    nFreeBlocks++;
+  if (erasedCount < eraseThreshold) {
+    releaseFreeBlock(req.blockIndex);
+  }
+  else {
+    block.setState(BLOCK_BAD);
   }
-
-  // Remove block from block list
-  blocks.erase(block);
 
   tick += applyLatency(CPU::FTL__PAGE_MAPPING, CPU::ERASE_INTERNAL);
 }
@@ -900,20 +1364,11 @@ float PageMapping::calculateWearLeveling() {
   uint64_t eraseCnt;
 
   for (auto &iter : blocks) {
-    eraseCnt = iter.second.getEraseCount();
-    totalEraseCnt += eraseCnt;
-    sumOfSquaredEraseCnt += eraseCnt * eraseCnt;
-  }
-
-  // freeBlocks is sorted
-  // Calculate from backward, stop when eraseCnt is zero
-  for (auto riter = freeBlocks.rbegin(); riter != freeBlocks.rend(); riter++) {
-    eraseCnt = riter->getEraseCount();
-
-    if (eraseCnt == 0) {
-      break;
+    if (iter.getState() == BLOCK_BAD) {
+      continue;
     }
 
+    eraseCnt = iter.getEraseCount();
     totalEraseCnt += eraseCnt;
     sumOfSquaredEraseCnt += eraseCnt * eraseCnt;
   }
@@ -931,8 +1386,8 @@ void PageMapping::calculateTotalPages(uint64_t &valid, uint64_t &invalid) {
   invalid = 0;
 
   for (auto &iter : blocks) {
-    valid += iter.second.getValidPageCount();
-    invalid += iter.second.getDirtyPageCount();
+    valid += iter.getValidPageCount();
+    invalid += iter.getDirtyPageCount();
   }
 }
 
@@ -955,6 +1410,18 @@ void PageMapping::getStatList(std::vector<Stats> &list, std::string prefix) {
   temp.desc = "Total copied valid pages during GC";
   list.push_back(temp);
 
+  temp.name = prefix + "page_mapping.bgc.count";
+  temp.desc = "Total background GC rounds";
+  list.push_back(temp);
+
+  temp.name = prefix + "page_mapping.bgc.reclaimed_blocks";
+  temp.desc = "Total reclaimed blocks in background GC";
+  list.push_back(temp);
+
+  temp.name = prefix + "page_mapping.gc.incremental_steps";
+  temp.desc = "Total incremental GC steps";
+  list.push_back(temp);
+
   // For the exact definition, see following paper:
   // Li, Yongkun, Patrick PC Lee, and John Lui.
   // "Stochastic modeling of large-scale solid-state storage systems: analysis,
@@ -969,6 +1436,9 @@ void PageMapping::getStatValues(std::vector<double> &values) {
   values.push_back(stat.reclaimedBlocks);
   values.push_back(stat.validSuperPageCopies);
   values.push_back(stat.validPageCopies);
+  values.push_back(stat.bgcCount);
+  values.push_back(stat.bgcReclaimedBlocks);
+  values.push_back(stat.igcSteps);
   values.push_back(calculateWearLeveling());
 }
 
@@ -976,6 +1446,162 @@ void PageMapping::resetStatValues() {
   memset(&stat, 0, sizeof(stat));
 }
 
+void PageMapping::getMemoryUsage(std::vector<MemoryUsage> &list,
+                                 std::string prefix) {
+  MemoryUsage temp;
+
+  temp.name = prefix + "memory.mapping_table";
+  temp.desc = "Host memory used by page mapping table in byte";
+  temp.bytes = memoryUsage(table);
+  list.push_back(temp);
+
+  temp.name = prefix + "memory.block_metadata";
+  temp.desc = "Host memory used by block metadata in byte";
+  temp.bytes = blocks.getMemoryUsage() + memoryUsage(freeBlocks) +
+               memoryUsage(lastFreeBlock) + memoryUsage(gcVictims) +
+               allocationSize(DIVCEIL(param.pageCountToMaxPerf, 8));
+
+  for (auto &iter : freeBlocks) {
+    temp.bytes += memoryUsage(iter);
+  }
+
+  list.push_back(temp);
+}
+
+void PageMapping::saveState(std::ostream &out) {
+  pushTag(out, "FTLP");
+
+  pushValue(out, param.totalPhysicalBlocks);
+  pushValue(out, param.totalLogicalBlocks);
+  pushValue(out, param.pagesInBlock);
+  pushValue(out, (uint64_t)param.ioUnitInPage);
+
+  // All blocks in index order, then free block heaps as is
+  blocks.saveState(out);
+
+  pushValue(out, freeBlockSequence);
+
+  for (auto &iter : freeBlocks) {
+    pushVector(out, iter);
+  }
+
+  pushVector(out, lastFreeBlock);
+  lastFreeBlockIOMap.saveState(out);
+  pushValue(out, lastFreeBlockIndex);
+  pushValue(out, bReclaimMore);
+  pushValue(out, rng);
+
+  uint64_t bgcAt = 0;
+  bool bgcScheduled = scheduled(bgcEvent, &bgcAt);
+
+  pushValue(out, bgcRunning);
+  pushValue(out, lastRequestAt);
+  pushValue(out, bgcScheduled);
+  pushValue(out, bgcAt);
+  pushVector(out, gcVictims);
+  pushValue(out, gcVictimIndex);
+  pushValue(out, gcPageIndex);
+  pushValue(out, stat);
+}
+
+void PageMapping::loadState(std::istream &in) {
+  popTag(in, "FTLP");
+
+  checkValue(in, param.totalPhysicalBlocks, "FTL physical blocks");
+  checkValue(in, param.totalLogicalBlocks, "FTL logical blocks");
+  checkValue(in, param.pagesInBlock, "FTL pages in block");
+  checkValue(in, param.ioUnitInPage, "FTL I/O unit in page");
+
+  // Blocks
+  blocks.loadState(in);
+
+  popValue(in, freeBlockSequence);
+
+  nFreeBlocks = 0;
+
+  for (uint32_t i = 0; i < param.pageCountToMaxPerf; i++) {
+    popVector(in, freeBlocks.at(i));
+
+    for (auto &iter : freeBlocks.at(i)) {
+      if (iter.blockIndex >= blocks.size() ||
+          convertBlockIdx(iter.blockIndex) != i ||
+          blocks[iter.blockIndex].getState() != BLOCK_FREE) {
+        panic("Checkpoint corrupted: invalid free block");
+      }
+    }
+
+    nFreeBlocks += (uint32_t)freeBlocks.at(i).size();
+  }
+
+  popVector(in, lastFreeBlock);
+  lastFreeBlockIOMap.loadState(in);
+  popValue(in, lastFreeBlockIndex);
+  popValue(in, bReclaimMore);
+  popValue(in, rng);
+
+  uint64_t bgcAt;
+  bool bgcScheduled;
+
+  popValue(in, bgcRunning);
+  popValue(in, lastRequestAt);
+  popValue(in, bgcScheduled);
+  popValue(in, bgcAt);
+  popVector(in, gcVictims);
+  popValue(in, gcVictimIndex);
+  popValue(in, gcPageIndex);
+  popValue(in, stat);
+
+  if (bgcScheduled) {
+    schedule(bgcEvent, bgcAt);
+  }
+  else {
+    deschedule(bgcEvent);
+  }
+
+  if (lastFreeBlock.size() != param.pageCountToMaxPerf) {
+    panic("Checkpoint corrupted: active block count mismatch");
+  }
+
+  for (uint32_t i = gcVictimIndex; i < gcVictims.size(); i++) {
+    if (gcVictims.at(i) >= blocks.size() ||
+        blocks[gcVictims.at(i)].getState() != BLOCK_FULL) {
+      panic("Checkpoint corrupted: invalid GC victim");
+    }
+  }
+
+  rebuildTable();
+}
+
+// Mapping table is not saved, as each valid I/O unit in blocks holds its LPN
+void PageMapping::rebuildTable() {
+  std::vector<uint64_t> lpns;
+  Bitset map(param.ioUnitInPage);
+
+  std::fill(table.begin(), table.end(), UNMAPPED);
+  nMappedPages = 0;
+
+  for (auto &block : blocks) {
+    uint32_t written = block.getNextWritePageIndex();
+
+    for (uint32_t page = 0; page < written; page++) {
+      if (!block.getPageInfo(page, lpns, map)) {
+        continue;
+      }
+
+      for (uint32_t idx = 0; idx < bitsetSize; idx++) {
+        if (block.isValid(page, idx)) {
+          if (!isMapped(lpns.at(idx))) {
+            nMappedPages++;
+          }
+
+          table[lpns.at(idx) * bitsetSize + idx] =
+              packMapping(block.getBlockIndex(), page);
+        }
+      }
+    }
+  }
+}
+
 }  // namespace FTL
 
 }  // namespace SimpleSSD
@@ -21,13 +21,14 @@
 #define __FTL_PAGE_MAPPING__
 
 #include <cinttypes>
-#include <unordered_map>
 #include <vector>
 
 #include "ftl/abstract_ftl.hh"
 #include "ftl/common/block.hh"
 #include "ftl/ftl.hh"
 #include "pal/pal.hh"
+#include "sim/simulator.hh"
+#include "util/random.hh"
 
 namespace SimpleSSD {
 
@@ -35,15 +36,34 @@ namespace FTL {
 
 class PageMapping : public AbstractFTL {
  private:
+  typedef struct {
+    uint32_t eraseCount;
+    uint32_t blockIndex;
+    uint64_t sequence;  // Release order, FIFO among same erase count
+  } FreeBlock;
+
+  // GC I/O collected before issued to PAL
+  typedef struct {
+    std::vector<PAL::Request> reads;
+    std::vector<PAL::Request> writes;
+    std::vector<uint32_t> writeSource;  // Index of read each write copies
+    std::vector<PAL::Request> erases;
+    // Range of reads each erase waits for, [first, second)
+    std::vector<std::pair<uint32_t, uint32_t>> eraseWait;
+  } GCRequests;
+
   PAL::PAL *pPAL;
 
   ConfigReader &conf;
 
-  std::unordered_map<uint64_t, std::vector<std::pair<uint32_t, uint32_t>>>
-      table;
-  std::unordered_map<uint32_t, Block> blocks;
-  std::list<Block> freeBlocks;
-  uint32_t nFreeBlocks;  // For some libraries which std::list::size() is O(n)
+  // Physical address of each I/O unit, indexed by lpn * bitsetSize + idx
+  std::vector<uint64_t> table;
+  uint64_t nMappedPages;  // Logical pages with at least one mapped I/O unit
+  BlockPool blocks;
+  // Free blocks of each parallel unit, min-heap of (eraseCount, sequence)
+  std::vector<std::vector<FreeBlock>> freeBlocks;
+  uint64_t freeBlockSequence;
+  uint32_t nFreeBlocks;
   std::vector<uint32_t> lastFreeBlock;
   Bitset lastFreeBlockIOMap;
   uint32_t lastFreeBlockIndex;
@@ -52,21 +72,63 @@ class PageMapping : public AbstractFTL {
   bool bRandomTweak;
   uint32_t bitsetSize;
 
+  GC_MODE gcMode;
+  EVICT_POLICY gcPolicy;
+  uint32_t dChoiceParam;
+  Random rng;  // For random and d-choice victim sampling
+  float gcThreshold;
+  float gcReclaimThreshold;
+  uint64_t eraseThreshold;
+
+  // Background GC, runs while no request has arrived for bgcIdleTime
+  bool bgcEnable;
+  bool bgcRunning;  // Between the two thresholds, keep reclaiming when idle
+  uint64_t bgcIdleTime;
+  float bgcThreshold;
+  float bgcReclaimThreshold;
+  uint64_t lastRequestAt;
+  Event bgcEvent;
+
+  // Incremental GC, copies igcPages valid pages per host write
+  bool igcEnable;
+  uint64_t igcPages;
+  std::vector<uint32_t> gcVictims;  // Victims of GC in progress
+  uint32_t gcVictimIndex;           // Victim being copied
+  uint32_t gcPageIndex;             // Next page to copy in the victim
+  bool igcChecked;                  // Configuration checked at first GC
+
   struct {
     uint64_t gcCount;
     uint64_t reclaimedBlocks;
     uint64_t validSuperPageCopies;
     uint64_t validPageCopies;
+    uint64_t bgcCount;
+    uint64_t bgcReclaimedBlocks;
+    uint64_t igcSteps;
   } stat;
 
   float freeBlockRatio();
+  bool isMapped(uint64_t);
   uint32_t convertBlockIdx(uint32_t);
+  static bool freeBlockGreater(const FreeBlock &, const FreeBlock &);
+  void releaseFreeBlock(uint32_t);
   uint32_t getFreeBlock(uint32_t);
   uint32_t getLastFreeBlock(Bitset &);
   void calculateVictimWeight(std::vector<std::pair<uint32_t, float>> &,
                              const EVICT_POLICY, uint64_t);
   void selectVictimBlock(std::vector<uint32_t> &, uint64_t &);
+  void selectVictimBlock(std::vector<uint32_t> &, uint64_t, uint64_t &);
+  void selectVictimBlockPerUnit(std::vector<uint32_t> &, uint64_t &);
+  bool collectValidPages(uint32_t, uint32_t &, uint64_t &, GCRequests &,
+                         uint64_t &);
+  void collectErase(uint32_t, uint32_t, GCRequests &);
+  void issueGCRequests(GCRequests &, uint64_t &);
   void doGarbageCollection(std::vector<uint32_t> &, uint64_t &);
+  uint64_t getGCRemainingPages();
+  uint64_t calculateGCPace();
+  uint32_t doIncrementalGC(uint64_t, uint64_t &);
+  void updateIdleTimer(uint64_t);
+  void backgroundGC(uint64_t);
 
   float calculateWearLeveling();
   void calculateTotalPages(uint64_t &, uint64_t &);
@@ -76,6 +138,9 @@ class PageMapping : public AbstractFTL {
   void trimInternal(Request &, uint64_t &);
   void eraseInternal(PAL::Request &, uint64_t &);
 
+  void fillSequential(uint64_t);
+  void rebuildTable();
+
  public:
   PageMapping(ConfigReader &, Parameter &, PAL::PAL *, DRAM::AbstractDRAM *);
   ~PageMapping();
@@ -93,6 +158,10 @@ class PageMapping : public AbstractFTL {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace FTL
@@ -19,12 +19,21 @@
 
 #include "hil/hil.hh"
 
+#include <sstream>
+
+#include "sim/profile.hh"
+#include "sim/request_trace.hh"
 #include "util/algorithm.hh"
 
 namespace SimpleSSD {
 
 namespace HIL {
 
+const char *requestTypeName[REQUEST_FORMAT] = {"read", "write", "flush",
+                                               "trim"};
+
+const double latencyPercentiles[] = {50., 90., 99., 99.9, 99.99};
+
 HIL::HIL(ConfigReader &c) : conf(c), reqCount(0), lastScheduled(0) {
   pICL = new ICL::ICL(conf);
 
@@ -38,12 +47,19 @@ HIL::~HIL() {
 }
 
 void HIL::read(Request &req) {
+  ProfileScope scope(PROFILE_HIL);
+
   DMAFunction doRead = [this](uint64_t beginAt, void *context) {
+    ProfileScope scope(PROFILE_HIL);
+
     auto pReq = (Request *)context;
     uint64_t tick = beginAt;
 
     pReq->reqID = ++reqCount;
 
+    traceRequest(pReq->reqID);
+    traceSpan(TRACE_CPU_QUEUE, 0, pReq->arrivedAt, beginAt);
+
     debugprint(LOG_HIL,
                "READ  | REQ %7u | LCA %" PRIu64 " + %" PRIu64 " | BYTE %" PRIu64
                " + %" PRIu64,
@@ -58,6 +74,8 @@ void HIL::read(Request &req) {
     updateBusyTime(0, beginAt, tick);
     updateBusyTime(2, beginAt, tick);
 
+    traceSpan(TRACE_HIL_READ, 0, pReq->arrivedAt, tick);
+
     pReq->finishedAt = tick;
     completionQueue.push(*pReq);
 
@@ -66,16 +84,28 @@ void HIL::read(Request &req) {
     delete pReq;
   };
 
-  execute(CPU::HIL, CPU::READ, doRead, new Request(req));
+  Request *pReq = new Request(req);
+
+  pReq->type = REQUEST_READ;
+  pReq->arrivedAt = getTick();
+
+  execute(CPU::HIL, CPU::READ, doRead, pReq);
 }
 
 void HIL::write(Request &req) {
+  ProfileScope scope(PROFILE_HIL);
+
   DMAFunction doWrite = [this](uint64_t beginAt, void *context) {
+    ProfileScope scope(PROFILE_HIL);
+
     auto pReq = (Request *)context;
     uint64_t tick = beginAt;
 
     pReq->reqID = ++reqCount;
 
+    traceRequest(pReq->reqID);
+    traceSpan(TRACE_CPU_QUEUE, 0, pReq->arrivedAt, beginAt);
+
     debugprint(LOG_HIL,
                "WRITE | REQ %7u | LCA %" PRIu64 " + %" PRIu64 " | BYTE %" PRIu64
                " + %" PRIu64,
@@ -90,6 +120,8 @@ void HIL::write(Request &req) {
     updateBusyTime(1, beginAt, tick);
     updateBusyTime(2, beginAt, tick);
 
+    traceSpan(TRACE_HIL_WRITE, 0, pReq->arrivedAt, tick);
+
     pReq->finishedAt = tick;
     completionQueue.push(*pReq);
 
@@ -98,20 +130,34 @@ void HIL::write(Request &req) {
     delete pReq;
   };
 
-  execute(CPU::HIL, CPU::WRITE, doWrite, new Request(req));
+  Request *pReq = new Request(req);
+
+  pReq->type = REQUEST_WRITE;
+  pReq->arrivedAt = getTick();
+
+  execute(CPU::HIL, CPU::WRITE, doWrite, pReq);
 }
 
 void HIL::flush(Request &req) {
+  ProfileScope scope(PROFILE_HIL);
+
   DMAFunction doFlush = [this](uint64_t tick, void *context) {
+    ProfileScope scope(PROFILE_HIL);
+
     auto pReq = (Request *)context;
 
     pReq->reqID = ++reqCount;
 
+    traceRequest(pReq->reqID);
+    traceSpan(TRACE_CPU_QUEUE, 0, pReq->arrivedAt, tick);
+
     debugprint(LOG_HIL, "FLUSH | REQ %7u | LCA %" PRIu64 " + %" PRIu64,
                pReq->reqID, pReq->range.slpn, pReq->range.nlp);
 
     pICL->flush(pReq->range, tick);
 
+    traceSpan(TRACE_HIL_FLUSH, 0, pReq->arrivedAt, tick);
+
     pReq->finishedAt = tick;
     completionQueue.push(*pReq);
 
@@ -120,20 +166,34 @@ void HIL::flush(Request &req) {
     delete pReq;
   };
 
-  execute(CPU::HIL, CPU::FLUSH, doFlush, new Request(req));
+  Request *pReq = new Request(req);
+
+  pReq->type = REQUEST_FLUSH;
+  pReq->arrivedAt = getTick();
+
+  execute(CPU::HIL, CPU::FLUSH, doFlush, pReq);
 }
 
 void HIL::trim(Request &req) {
+  ProfileScope scope(PROFILE_HIL);
+
   DMAFunction doFlush = [this](uint64_t tick, void *context) {
+    ProfileScope scope(PROFILE_HIL);
+
     auto pReq = (Request *)context;
 
     pReq->reqID = ++reqCount;
 
+    traceRequest(pReq->reqID);
+    traceSpan(TRACE_CPU_QUEUE, 0, pReq->arrivedAt, tick);
+
     debugprint(LOG_HIL, "TRIM  | REQ %7u | LCA %" PRIu64 " + %" PRIu64,
                pReq->reqID, pReq->range.slpn, pReq->range.nlp);
 
     pICL->trim(pReq->range, tick);
 
+    traceSpan(TRACE_HIL_TRIM, 0, pReq->arrivedAt, tick);
+
     pReq->finishedAt = tick;
     completionQueue.push(*pReq);
 
@@ -142,11 +202,20 @@ void HIL::trim(Request &req) {
     delete pReq;
   };
 
-  execute(CPU::HIL, CPU::FLUSH, doFlush, new Request(req));
+  Request *pReq = new Request(req);
+
+  pReq->type = REQUEST_TRIM;
+  pReq->arrivedAt = getTick();
+
+  execute(CPU::HIL, CPU::FLUSH, doFlush, pReq);
 }
 
 void HIL::format(Request &req, bool erase) {
+  ProfileScope scope(PROFILE_HIL);
+
   DMAFunction doFlush = [this, erase](uint64_t tick, void *context) {
+    ProfileScope scope(PROFILE_HIL);
+
     auto pReq = (Request *)context;
 
     debugprint(LOG_HIL, "FORMAT| LCA %" PRIu64 " + %" PRIu64, pReq->reqID,
@@ -167,7 +236,12 @@ void HIL::format(Request &req, bool erase) {
     delete pReq;
   };
 
-  execute(CPU::HIL, CPU::FLUSH, doFlush, new Request(req));
+  Request *pReq = new Request(req);
+
+  pReq->type = REQUEST_FORMAT;
+  pReq->arrivedAt = getTick();
+
+  execute(CPU::HIL, CPU::FLUSH, doFlush, pReq);
 }
 
 void HIL::getLPNInfo(uint64_t &totalLogicalPages, uint32_t &logicalPageSize) {
@@ -195,7 +269,8 @@ void HIL::updateBusyTime(int idx, uint64_t begin, uint64_t end) {
 
 void HIL::updateCompletion() {
   if (completionQueue.size() > 0) {
-    if (lastScheduled != completionQueue.top().finishedAt) {
+    if (lastScheduled != completionQueue.top().finishedAt ||
+        !scheduled(completionEvent)) {
       lastScheduled = completionQueue.top().finishedAt;
       schedule(completionEvent, lastScheduled);
     }
@@ -203,15 +278,25 @@ void HIL::updateCompletion() {
 }
 
 void HIL::completion() {
+  ProfileScope scope(PROFILE_HIL);
+
   uint64_t tick = getTick();
 
   while (completionQueue.size() > 0) {
-    auto &req = completionQueue.top();
-
-    if (req.finishedAt <= tick) {
-      req.function(tick, req.context);
+    if (completionQueue.top().finishedAt <= tick) {
+      // Callback may submit new request, which modifies completionQueue
+      Request req = completionQueue.top();
 
       completionQueue.pop();
+
+      if (req.type < REQUEST_FORMAT) {
+        latency[req.type].add(tick - req.arrivedAt);
+      }
+
+      // Callback belongs to host
+      ProfileScope host(PROFILE_OTHER);
+
+      req.function(tick, req.context);
     }
     else {
       break;
@@ -260,7 +345,37 @@ void HIL::getStatList(std::vector<Stats> &list, std::string prefix) {
   temp.desc = "Total device busy time";
   list.push_back(temp);
 
+  for (int i = 0; i < REQUEST_FORMAT; i++) {
+    std::string name = prefix + requestTypeName[i] + ".latency.";
+    std::string type = requestTypeName[i];
+
+    for (auto p : latencyPercentiles) {
+      std::ostringstream percentile;
+
+      percentile << p;
+
+      temp.name = name + "p" + percentile.str();
+      temp.desc = percentile.str() + "th percentile latency of " + type +
+                  " requests";
+      list.push_back(temp);
+    }
+
+    temp.name = name + "max";
+    temp.desc = "Maximum latency of " + type + " requests";
+    list.push_back(temp);
+  }
+
   pICL->getStatList(list, prefix);
+
+  std::vector<MemoryUsage> memory;
+
+  getMemoryUsage(memory, prefix);
+
+  for (auto &iter : memory) {
+    temp.name = iter.name;
+    temp.desc = iter.desc;
+    list.push_back(temp);
+  }
 }
 
 void HIL::getStatValues(std::vector<double> &values) {
@@ -274,15 +389,87 @@ void HIL::getStatValues(std::vector<double> &values) {
   values.push_back(stat.iosize[0] + stat.iosize[1]);
   values.push_back(stat.busy[2]);
 
+  for (int i = 0; i < REQUEST_FORMAT; i++) {
+    for (auto p : latencyPercentiles) {
+      values.push_back(latency[i].getPercentile(p));
+    }
+
+    values.push_back(latency[i].getMax());
+  }
+
   pICL->getStatValues(values);
+
+  std::vector<MemoryUsage> memory;
+
+  getMemoryUsage(memory, "");
+
+  for (auto &iter : memory) {
+    values.push_back(iter.bytes);
+  }
 }
 
 void HIL::resetStatValues() {
   memset(&stat, 0, sizeof(stat));
 
+  for (auto &iter : latency) {
+    iter.reset();
+  }
+
   pICL->resetStatValues();
 }
 
+void HIL::getMemoryUsage(std::vector<MemoryUsage> &list, std::string prefix) {
+  pICL->getMemoryUsage(list, prefix);
+}
+
+/**
+ * Print full latency histogram of each request type, in same format as
+ * IOStatistics::printHistogram
+ */
+void HIL::printHistogram(std::ostream &os, std::string prefix) {
+  for (int i = 0; i < REQUEST_FORMAT; i++) {
+    if (latency[i].getCount() == 0) {
+      continue;
+    }
+
+    os << "# " << prefix << requestTypeName[i]
+       << " latency(us): lower upper count cumulative" << std::endl;
+    latency[i].print(os, 1000000.);
+  }
+}
+
+void HIL::saveState(std::ostream &out) {
+  if (completionQueue.size() > 0) {
+    panic("Checkpoint cannot be taken while request is in flight");
+  }
+
+  pushTag(out, "HIL ");
+
+  pushValue(out, reqCount);
+  pushValue(out, lastScheduled);
+  pushValue(out, stat);
+
+  for (auto &iter : latency) {
+    iter.saveState(out);
+  }
+
+  pICL->saveState(out);
+}
+
+void HIL::loadState(std::istream &in) {
+  popTag(in, "HIL ");
+
+  popValue(in, reqCount);
+  popValue(in, lastScheduled);
+  popValue(in, stat);
+
+  for (auto &iter : latency) {
+    iter.loadState(in);
+  }
+
+  pICL->loadState(in);
+}
+
 }  // namespace HIL
 
 }  // namespace SimpleSSD
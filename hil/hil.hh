@@ -24,13 +24,14 @@
 
 #include "icl/icl.hh"
 #include "sim/dma_interface.hh"
+#include "util/histogram.hh"
 #include "util/simplessd.hh"
 
 namespace SimpleSSD {
 
 namespace HIL {
 
-class HIL : public StatObject {
+class HIL : public StatObject, public StateObject {
  private:
   ConfigReader &conf;
   ICL::ICL *pICL;
@@ -48,6 +49,9 @@ class HIL : public StatObject {
     uint64_t lastBusyAt[3];
   } stat;
 
+  // Arrival to completion of read, write, flush and trim
+  Histogram latency[REQUEST_FORMAT];
+
   void updateBusyTime(int, uint64_t, uint64_t);
   void updateCompletion();
   void completion();
@@ -69,6 +73,11 @@ class HIL : public StatObject {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+  void printHistogram(std::ostream &, std::string = "");
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace HIL
@@ -31,7 +31,7 @@ namespace NVMe {
 
 class Controller;
 
-class AbstractSubsystem : public StatObject {
+class AbstractSubsystem : public StatObject, public StateObject {
  protected:
   Controller *pParent;
 
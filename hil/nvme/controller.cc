@@ -116,6 +116,8 @@ Controller::Controller(Interface *intrface, ConfigReader &c)
   requestCounter = 0;
   maxRequest = conf.readUint(CONFIG_NVME, NVME_MAX_REQUEST_COUNT);
   workInterval = conf.readUint(CONFIG_NVME, NVME_WORK_INTERVAL);
+  wrrHigh = conf.readUint(CONFIG_NVME, NVME_WRR_HIGH);
+  wrrMedium = conf.readUint(CONFIG_NVME, NVME_WRR_MEDIUM);
   requestInterval = workInterval / maxRequest;
 
   // Which subsystem should we use
@@ -1375,8 +1377,6 @@ bool Controller::getCoalescing(uint16_t iv) {
 }
 
 void Controller::collectSQueue(DMAFunction &func, void *context) {
-  static uint16_t wrrHigh = conf.readUint(CONFIG_NVME, NVME_WRR_HIGH);
-  static uint16_t wrrMedium = conf.readUint(CONFIG_NVME, NVME_WRR_MEDIUM);
   DMAContext *pContext = new DMAContext(func, context);
 
   static DMAFunction doQueue = [](uint64_t now, void *context) {
@@ -1833,6 +1833,170 @@ void Controller::resetStatValues() {
   pSubsystem->resetStatValues();
 }
 
+void Controller::saveState(std::ostream &out) {
+  uint64_t workAt = 0;
+
+  if (lSQFIFO.size() > 0 || lCQFIFO.size() > 0) {
+    panic("Checkpoint cannot be taken while command is in flight");
+  }
+
+  pushTag(out, "NVMe");
+
+  pushValue(out, (uint64_t)cqsize);
+  pushValue(out, (uint64_t)sqsize);
+
+  pushValue(out, registers);
+  pushValue(out, sqstride);
+  pushValue(out, cqstride);
+  pushValue(out, adminQueueInited);
+  pushValue(out, arbitration);
+  pushValue(out, interruptMask);
+  pushValue(out, cfgdata.memoryPageSize);
+  pushValue(out, cfgdata.memoryPageSizeOrder);
+  pushValue(out, shutdownReserved);
+
+  pushValue(out, aggregationTime);
+  pushValue(out, aggregationThreshold);
+  pushValue(out, (uint64_t)aggregationMap.size());
+
+  for (auto &iter : aggregationMap) {
+    pushValue(out, iter.first);
+    pushValue(out, iter.second);
+  }
+
+  // Queues are saved with their creation parameters and resolved PRP lists,
+  // so host memory is not accessed on restore
+  for (uint32_t i = 0; i < cqsize; i++) {
+    CQueue *pQueue = ppCQueue[i];
+
+    pushValue(out, pQueue != nullptr);
+
+    if (pQueue) {
+      pushValue(out, pQueue->getInterruptVector());
+      pushValue(out, pQueue->interruptEnabled());
+      pushValue(out, pQueue->getSize());
+
+      pQueue->saveState(out);
+    }
+  }
+
+  for (uint32_t i = 0; i < sqsize; i++) {
+    SQueue *pQueue = ppSQueue[i];
+
+    pushValue(out, pQueue != nullptr);
+
+    if (pQueue) {
+      pushValue(out, pQueue->getCQID());
+      pushValue(out, pQueue->getPriority());
+      pushValue(out, pQueue->getSize());
+
+      pQueue->saveState(out);
+    }
+  }
+
+  scheduled(workEvent, &workAt);
+
+  pushValue(out, workAt);
+  pushValue(out, lastWorkAt);
+
+  pSubsystem->saveState(out);
+}
+
+void Controller::loadState(std::istream &in) {
+  static DMAFunction empty = [](uint64_t, void *) {};
+  uint64_t size;
+  uint64_t workAt;
+  uint16_t key;
+  AggregationInfo info;
+  bool exist;
+
+  popTag(in, "NVMe");
+
+  checkValue(in, cqsize, "NVMe completion queue count");
+  checkValue(in, sqsize, "NVMe submission queue count");
+
+  popValue(in, registers);
+  popValue(in, sqstride);
+  popValue(in, cqstride);
+  popValue(in, adminQueueInited);
+  popValue(in, arbitration);
+  popValue(in, interruptMask);
+  popValue(in, cfgdata.memoryPageSize);
+  popValue(in, cfgdata.memoryPageSizeOrder);
+  popValue(in, shutdownReserved);
+
+  popValue(in, aggregationTime);
+  popValue(in, aggregationThreshold);
+  popValue(in, size);
+
+  aggregationMap.clear();
+
+  for (uint64_t i = 0; i < size; i++) {
+    popValue(in, key);
+    popValue(in, info);
+
+    aggregationMap.emplace(key, info);
+  }
+
+  for (uint32_t i = 0; i < cqsize; i++) {
+    uint16_t iv;
+    bool ien;
+    uint16_t entries;
+
+    if (ppCQueue[i]) {
+      delete ppCQueue[i];
+      ppCQueue[i] = nullptr;
+    }
+
+    popValue(in, exist);
+
+    if (exist) {
+      popValue(in, iv);
+      popValue(in, ien);
+      popValue(in, entries);
+
+      ppCQueue[i] = new CQueue(iv, ien, i, entries);
+      ppCQueue[i]->setBase(new PRPList(cfgdata, empty, nullptr), cqstride);
+      ppCQueue[i]->loadState(in);
+    }
+  }
+
+  for (uint32_t i = 0; i < sqsize; i++) {
+    uint16_t cqid;
+    uint8_t priority;
+    uint16_t entries;
+
+    if (ppSQueue[i]) {
+      delete ppSQueue[i];
+      ppSQueue[i] = nullptr;
+    }
+
+    popValue(in, exist);
+
+    if (exist) {
+      popValue(in, cqid);
+      popValue(in, priority);
+      popValue(in, entries);
+
+      ppSQueue[i] = new SQueue(cqid, priority, i, entries);
+      ppSQueue[i]->setBase(new PRPList(cfgdata, empty, nullptr), sqstride);
+      ppSQueue[i]->loadState(in);
+    }
+  }
+
+  popValue(in, workAt);
+  popValue(in, lastWorkAt);
+
+  if (workAt > 0) {
+    schedule(workEvent, workAt);
+  }
+  else {
+    deschedule(workEvent);
+  }
+
+  pSubsystem->loadState(in);
+}
+
 }  // namespace NVMe
 
 }  // namespace HIL
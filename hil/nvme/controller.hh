@@ -69,7 +69,7 @@ typedef struct {
   bool pending;
 } AggregationInfo;
 
-class Controller : public StatObject {
+class Controller : public StatObject, public StateObject {
  private:
   Interface *pParent;             //!< NVMe::Interface passed from constructor
   AbstractSubsystem *pSubsystem;  //!< NVMe::Subsystem allocate in constructor
@@ -84,6 +84,8 @@ class Controller : public StatObject {
   uint64_t cqstride;         //!< Calculated CQ stride
   uint8_t adminQueueInited;  //!< Flag for initialization of Admin CQ/SQ
   uint16_t arbitration;      //!< Selected Arbitration Mechanism
+  uint16_t wrrHigh;          //!< Weight of high priority queue in WRR
+  uint16_t wrrMedium;        //!< Weight of medium priority queue in WRR
   uint32_t interruptMask;    //!< Variable to store current interrupt mask
 
   uint32_t cqsize;
@@ -150,6 +152,9 @@ class Controller : public StatObject {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace NVMe
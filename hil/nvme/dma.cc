@@ -122,8 +122,23 @@ PRPList::PRPList(ConfigData &cfg, DMAFunction &f, void *c, uint64_t base,
   }
 }
 
+PRPList::PRPList(ConfigData &cfg, DMAFunction &f, void *c)
+    : DMAInterface(cfg, f, c), totalSize(0), pagesize(cfg.memoryPageSize) {}
+
 PRPList::~PRPList() {}
 
+void PRPList::saveState(std::ostream &out) {
+  pushValue(out, totalSize);
+  pushValue(out, pagesize);
+  pushVector(out, prpList);
+}
+
+void PRPList::loadState(std::istream &in) {
+  popValue(in, totalSize);
+  popValue(in, pagesize);
+  popVector(in, prpList);
+}
+
 void PRPList::getPRPListFromPRP(uint64_t base, uint64_t size) {
   static DMAFunction doRead = [](uint64_t now, void *context) {
     DMAInitContext *pContext = (DMAInitContext *)context;
@@ -45,7 +45,7 @@ typedef struct {
   uint16_t maxQueueEntry;
 } ConfigData;
 
-class DMAInterface {
+class DMAInterface : public StateObject {
  protected:
   SimpleSSD::DMAInterface *pInterface;
   DMAFunction initFunction;
@@ -94,12 +94,16 @@ class PRPList : public DMAInterface {
  public:
   PRPList(ConfigData &, DMAFunction &, void *, uint64_t, uint64_t, uint64_t);
   PRPList(ConfigData &, DMAFunction &, void *, uint64_t, uint64_t, bool);
+  PRPList(ConfigData &, DMAFunction &, void *);  //!< Empty, for loadState
   ~PRPList();
 
   void read(uint64_t, uint64_t, uint8_t *, DMAFunction &,
             void * = nullptr) override;
   void write(uint64_t, uint64_t, uint8_t *, DMAFunction &,
              void * = nullptr) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 union SGLDescriptor {
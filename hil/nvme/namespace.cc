@@ -157,6 +157,10 @@ Namespace::Information *Namespace::getInfo() {
   return &info;
 }
 
+uint64_t Namespace::getMemoryUsage() {
+  return pDisk ? pDisk->getMemoryUsage() : 0;
+}
+
 bool Namespace::isAttached() {
   return attached;
 }
@@ -172,6 +176,21 @@ void Namespace::format(uint64_t tick) {
   }
 }
 
+void Namespace::saveState(std::ostream &out) {
+  // Contents of disk image are not part of checkpoint
+  pushValue(out, attached);
+  pushValue(out, allocated);
+  pushValue(out, health);
+  pushValue(out, formatFinishedAt);
+}
+
+void Namespace::loadState(std::istream &in) {
+  popValue(in, attached);
+  popValue(in, allocated);
+  popValue(in, health);
+  popValue(in, formatFinishedAt);
+}
+
 void Namespace::getLogPage(SQEntryWrapper &req, RequestFunction &func) {
   CQEntryWrapper resp(req);
   uint16_t numdl = (req.entry.dword10 & 0xFFFF0000) >> 16;
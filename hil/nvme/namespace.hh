@@ -78,7 +78,7 @@ class CompareContext : public IOContext {
       : IOContext(f, r), hostContent(nullptr) {}
 };
 
-class Namespace {
+class Namespace : public StateObject {
  public:
   typedef struct _Information {
     uint64_t size;                         //!< NSZE
@@ -131,8 +131,12 @@ class Namespace {
   uint32_t getNSID();
   Information *getInfo();
   bool isAttached();
+  uint64_t getMemoryUsage();
 
   void format(uint64_t);
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace NVMe
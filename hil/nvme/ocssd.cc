@@ -60,7 +60,7 @@ OpenChannelSSD12::~OpenChannelSSD12() {
 }
 
 void OpenChannelSSD12::init() {
-  bool useMP = conf.readBoolean(CONFIG_PAL, PAL::NAND_USE_MULTI_PLANE_OP);
+  useMultiplaneOP = conf.readBoolean(CONFIG_PAL, PAL::NAND_USE_MULTI_PLANE_OP);
 
   param.channel = conf.readUint(CONFIG_PAL, PAL::PAL_CHANNEL);
   param.package = conf.readUint(CONFIG_PAL, PAL::PAL_PACKAGE);
@@ -73,7 +73,7 @@ void OpenChannelSSD12::init() {
   param.superPageSize = param.pageSize;
 
   // Super block includes plane
-  if (useMP) {
+  if (useMultiplaneOP) {
     param.superPageSize *= param.plane;
   }
 
@@ -82,7 +82,8 @@ void OpenChannelSSD12::init() {
              "Channel |   Way   |   Die   |  Plane  |  Block  |   Page  ");
   debugprint(LOG_PAL, "%7u | %7u | %7u | %7u | %7u | %7u", param.channel,
              param.package, param.die, param.plane, param.block, param.page);
-  debugprint(LOG_PAL, "Multi-plane mode %s", useMP ? "enabled" : "disabled");
+  debugprint(LOG_PAL, "Multi-plane mode %s",
+             useMultiplaneOP ? "enabled" : "disabled");
   debugprint(LOG_PAL, "Page size %u -> %u", param.pageSize,
              param.superPageSize);
   debugprint(
@@ -97,7 +98,7 @@ void OpenChannelSSD12::init() {
   structure.parallelUnit = param.package;
   structure.parallelUnit *= param.die;
   structure.chunk = param.block;
-  structure.chunk *= useMP ? 1 : param.plane;
+  structure.chunk *= useMultiplaneOP ? 1 : param.plane;
   structure.chunkSize = param.page * param.superPageSize / LBA_SIZE;
   structure.writeSize = param.superPageSize / LBA_SIZE;
 
@@ -310,12 +311,9 @@ bool OpenChannelSSD12::parsePPA(uint64_t ppa, ::CPDPBP &addr) {
 }
 
 void OpenChannelSSD12::convertUnit(::CPDPBP &addr) {
-  static bool useMP =
-      conf.readBoolean(CONFIG_PAL, PAL::NAND_USE_MULTI_PLANE_OP);
-
   addr.Die = addr.Package % param.die;
   addr.Package = addr.Package / param.die;
-  if (useMP) {
+  if (useMultiplaneOP) {
     addr.Plane = 0;
   }
   else {
@@ -1149,6 +1147,16 @@ void OpenChannelSSD12::getStatList(std::vector<Stats> &list,
   list.push_back(temp);
 
   pPALOLD->getStatList(list, prefix + "pal.");
+
+  std::vector<MemoryUsage> memory;
+
+  getMemoryUsage(memory, prefix);
+
+  for (auto &iter : memory) {
+    temp.name = iter.name;
+    temp.desc = iter.desc;
+    list.push_back(temp);
+  }
 }
 
 void OpenChannelSSD12::getStatValues(std::vector<double> &values) {
@@ -1158,6 +1166,14 @@ void OpenChannelSSD12::getStatValues(std::vector<double> &values) {
   values.push_back(writeCount);
 
   pPALOLD->getStatValues(values);
+
+  std::vector<MemoryUsage> memory;
+
+  getMemoryUsage(memory, "");
+
+  for (auto &iter : memory) {
+    values.push_back(iter.bytes);
+  }
 }
 
 void OpenChannelSSD12::resetStatValues() {
@@ -1169,6 +1185,26 @@ void OpenChannelSSD12::resetStatValues() {
   pPALOLD->resetStatValues();
 }
 
+void OpenChannelSSD12::getMemoryUsage(std::vector<MemoryUsage> &list,
+                                      std::string prefix) {
+  MemoryUsage temp;
+
+  pPALOLD->getMemoryUsage(list, prefix + "pal.");
+
+  temp.name = prefix + "memory.disk_image";
+  temp.desc = "Host memory used by disk image in byte";
+  temp.bytes = pDisk->getMemoryUsage();
+  list.push_back(temp);
+}
+
+void OpenChannelSSD12::saveState(std::ostream &) {
+  panic("Checkpoint is not supported in Open-Channel SSD");
+}
+
+void OpenChannelSSD12::loadState(std::istream &) {
+  panic("Checkpoint is not supported in Open-Channel SSD");
+}
+
 OpenChannelSSD20::OpenChannelSSD20(Controller *c, ConfigData &cfg)
     : OpenChannelSSD12(c, cfg),
       pDescriptor(nullptr),
@@ -1181,7 +1217,7 @@ OpenChannelSSD20::~OpenChannelSSD20() {
 }
 
 void OpenChannelSSD20::init() {
-  bool useMP = conf.readBoolean(CONFIG_PAL, PAL::NAND_USE_MULTI_PLANE_OP);
+  useMultiplaneOP = conf.readBoolean(CONFIG_PAL, PAL::NAND_USE_MULTI_PLANE_OP);
 
   param.channel = conf.readUint(CONFIG_PAL, PAL::PAL_CHANNEL);
   param.package = conf.readUint(CONFIG_PAL, PAL::PAL_PACKAGE);
@@ -1194,7 +1230,7 @@ void OpenChannelSSD20::init() {
   param.superPageSize = param.pageSize;
 
   // Super block includes plane
-  if (useMP) {
+  if (useMultiplaneOP) {
     param.superPageSize *= param.plane;
   }
 
@@ -1203,7 +1239,8 @@ void OpenChannelSSD20::init() {
              "Channel |   Way   |   Die   |  Plane  |  Block  |   Page  ");
   debugprint(LOG_PAL, "%7u | %7u | %7u | %7u | %7u | %7u", param.channel,
              param.package, param.die, param.plane, param.block, param.page);
-  debugprint(LOG_PAL, "Multi-plane mode %s", useMP ? "enabled" : "disabled");
+  debugprint(LOG_PAL, "Multi-plane mode %s",
+             useMultiplaneOP ? "enabled" : "disabled");
   debugprint(LOG_PAL, "Page size %u -> %u", param.pageSize,
              param.superPageSize);
   debugprint(
@@ -1218,7 +1255,7 @@ void OpenChannelSSD20::init() {
   structure.parallelUnit = param.package;
   structure.parallelUnit *= param.die;
   structure.chunk = param.block;
-  structure.chunk *= useMP ? 1 : param.plane;
+  structure.chunk *= useMultiplaneOP ? 1 : param.plane;
   structure.chunkSize = param.page * param.superPageSize / LBA_SIZE;
   structure.writeSize = param.superPageSize / LBA_SIZE;
 
@@ -1430,9 +1467,6 @@ void OpenChannelSSD20::convertUnit(std::vector<uint64_t> &lbaList,
                                    std::vector<::CPDPBP> &list,
                                    std::vector<ChunkUpdateEntry> &chunk,
                                    bool block, bool mode) {
-  static bool useMP =
-      conf.readBoolean(CONFIG_PAL, PAL::NAND_USE_MULTI_PLANE_OP);
-
   list.clear();
   chunk.clear();
 
@@ -1450,7 +1484,7 @@ void OpenChannelSSD20::convertUnit(std::vector<uint64_t> &lbaList,
     temp.Package = p / param.die;
     temp.Die = p % param.die;
 
-    if (useMP) {
+    if (useMultiplaneOP) {
       temp.Plane = 0;
       temp.Block = c;
     }
@@ -2504,6 +2538,16 @@ void OpenChannelSSD20::getStatList(std::vector<Stats> &list,
   list.push_back(temp);
 
   pPALOLD->getStatList(list, prefix + "pal.");
+
+  std::vector<MemoryUsage> memory;
+
+  getMemoryUsage(memory, prefix);
+
+  for (auto &iter : memory) {
+    temp.name = iter.name;
+    temp.desc = iter.desc;
+    list.push_back(temp);
+  }
 }
 
 void OpenChannelSSD20::getStatValues(std::vector<double> &values) {
@@ -2516,6 +2560,14 @@ void OpenChannelSSD20::getStatValues(std::vector<double> &values) {
   values.push_back(vectorWriteCount);
 
   pPALOLD->getStatValues(values);
+
+  std::vector<MemoryUsage> memory;
+
+  getMemoryUsage(memory, "");
+
+  for (auto &iter : memory) {
+    values.push_back(iter.bytes);
+  }
 }
 
 void OpenChannelSSD20::resetStatValues() {
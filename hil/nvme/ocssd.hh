@@ -109,6 +109,7 @@ class OpenChannelSSD12 : public Subsystem {
 
   Geometry structure;
   Mask ppaMask;
+  bool useMultiplaneOP;
 
   uint64_t lastScheduled;
   Event completionEvent;
@@ -151,6 +152,10 @@ class OpenChannelSSD12 : public Subsystem {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 class OpenChannelSSD20 : public OpenChannelSSD12 {
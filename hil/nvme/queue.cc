@@ -103,6 +103,34 @@ void Queue::setBase(DMAInterface *p, uint64_t s) {
   stride = s;
 }
 
+void Queue::saveState(std::ostream &out) {
+  pushValue(out, head);
+  pushValue(out, tail);
+  pushValue(out, stride);
+  pushValue(out, base != nullptr);
+
+  if (base) {
+    base->saveState(out);
+  }
+}
+
+void Queue::loadState(std::istream &in) {
+  bool hasBase;
+
+  popValue(in, head);
+  popValue(in, tail);
+  popValue(in, stride);
+  popValue(in, hasBase);
+
+  if (hasBase) {
+    if (!base) {
+      panic("Queue base address should be set before loadState");
+    }
+
+    base->loadState(in);
+  }
+}
+
 CQueue::CQueue(uint16_t iv, bool en, uint16_t qid, uint16_t size)
     : Queue(qid, size), ien(en), phase(true), interruptVector(iv) {}
 
@@ -151,6 +179,18 @@ uint16_t CQueue::getInterruptVector() {
   return interruptVector;
 }
 
+void CQueue::saveState(std::ostream &out) {
+  Queue::saveState(out);
+
+  pushValue(out, phase);
+}
+
+void CQueue::loadState(std::istream &in) {
+  Queue::loadState(in);
+
+  popValue(in, phase);
+}
+
 SQueue::SQueue(uint16_t cqid, uint8_t pri, uint16_t qid, uint16_t size)
     : Queue(qid, size), cqID(cqid), priority(pri) {}
 
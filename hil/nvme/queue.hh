@@ -100,7 +100,7 @@ typedef struct _CQEntryWrapper {
   void makeStatus(bool, bool, STATUS_CODE_TYPE, int);
 } CQEntryWrapper;
 
-class Queue {
+class Queue : public StateObject {
  protected:
   uint16_t id;
 
@@ -122,6 +122,9 @@ class Queue {
   uint16_t getTail();
   uint16_t getSize();
   void setBase(DMAInterface *, uint64_t);
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 class CQueue : public Queue {
@@ -138,6 +141,9 @@ class CQueue : public Queue {
   void setHead(uint16_t);
   bool interruptEnabled();
   uint16_t getInterruptVector();
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 class SQueue : public Queue {
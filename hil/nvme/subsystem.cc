@@ -839,8 +839,8 @@ bool Subsystem::abort(SQEntryWrapper &req, RequestFunction &func) {
 
 bool Subsystem::setFeatures(SQEntryWrapper &req, RequestFunction &func) {
   bool err = false;
-  static uint32_t cqsize = conf.readUint(CONFIG_NVME, NVME_MAX_IO_CQUEUE);
-  static uint32_t sqsize = conf.readUint(CONFIG_NVME, NVME_MAX_IO_SQUEUE);
+  uint32_t cqsize = (uint32_t)conf.readUint(CONFIG_NVME, NVME_MAX_IO_CQUEUE);
+  uint32_t sqsize = (uint32_t)conf.readUint(CONFIG_NVME, NVME_MAX_IO_SQUEUE);
 
   CQEntryWrapper resp(req);
   uint16_t fid = req.entry.dword10 & 0x00FF;
@@ -950,10 +950,12 @@ bool Subsystem::asyncEventReq(SQEntryWrapper &, RequestFunction &) {
 bool Subsystem::namespaceManagement(SQEntryWrapper &req,
                                     RequestFunction &func) {
   struct NamespaceManagementContext : public RequestContext {
+    Subsystem *pThis;
     uint32_t nsid;
 
-    NamespaceManagementContext(RequestFunction &f, CQEntryWrapper &r)
-        : RequestContext(f, r), nsid(NSID_NONE) {}
+    NamespaceManagementContext(Subsystem *p, RequestFunction &f,
+                               CQEntryWrapper &r)
+        : RequestContext(f, r), pThis(p), nsid(NSID_NONE) {}
   };
 
   bool err = false;
@@ -964,7 +966,7 @@ bool Subsystem::namespaceManagement(SQEntryWrapper &req,
   debugprint(LOG_HIL_NVME, "ADMIN   | Namespace Management | OP %d | NSID %d",
              sel, req.entry.namespaceID);
 
-  static DMAFunction dmaDone = [this](uint64_t, void *context) {
+  static DMAFunction dmaDone = [](uint64_t, void *context) {
     Namespace::Information info;
     NamespaceManagementContext *pContext =
         (NamespaceManagementContext *)context;
@@ -991,7 +993,7 @@ bool Subsystem::namespaceManagement(SQEntryWrapper &req,
 
     info.lbaSize = lbaSize[info.lbaFormatIndex];
 
-    bool ret = createNamespace(pContext->nsid, &info);
+    bool ret = pContext->pThis->createNamespace(pContext->nsid, &info);
 
     if (ret) {
       pContext->resp.entry.dword0 = pContext->nsid;
@@ -1044,7 +1046,7 @@ bool Subsystem::namespaceManagement(SQEntryWrapper &req,
         err = true;
 
         NamespaceManagementContext *pContext =
-            new NamespaceManagementContext(func, resp);
+            new NamespaceManagementContext(this, func, resp);
 
         pContext->buffer = (uint8_t *)calloc(0x1000, sizeof(uint8_t));
         pContext->nsid = nsid;
@@ -1079,6 +1081,14 @@ bool Subsystem::namespaceManagement(SQEntryWrapper &req,
 
 bool Subsystem::namespaceAttachment(SQEntryWrapper &req,
                                     RequestFunction &func) {
+  struct NamespaceAttachmentContext : public IOContext {
+    Subsystem *pThis;
+
+    NamespaceAttachmentContext(Subsystem *p, RequestFunction &f,
+                               CQEntryWrapper &r)
+        : IOContext(f, r), pThis(p) {}
+  };
+
   CQEntryWrapper resp(req);
 
   uint8_t sel = req.entry.dword10 & 0x0F;
@@ -1087,9 +1097,10 @@ bool Subsystem::namespaceAttachment(SQEntryWrapper &req,
   debugprint(LOG_HIL_NVME, "ADMIN   | Namespace Attachment | OP %d | NSID %d",
              req.entry.dword10 & 0x0F, req.entry.namespaceID);
 
-  static DMAFunction dmaDone = [this](uint64_t, void *context) {
+  static DMAFunction dmaDone = [](uint64_t, void *context) {
     bool err = false;
-    IOContext *pContext = (IOContext *)context;
+    NamespaceAttachmentContext *pContext =
+        (NamespaceAttachmentContext *)context;
     uint16_t *ctrlList = (uint16_t *)pContext->buffer;
     std::vector<uint16_t> list;
 
@@ -1120,7 +1131,7 @@ bool Subsystem::namespaceAttachment(SQEntryWrapper &req,
       if (sel == 0x00) {  // Attach
         bool exist = false;
 
-        for (auto &iter : lNamespaces) {
+        for (auto &iter : pContext->pThis->lNamespaces) {
           if (iter->getNSID() == nsid) {
             exist = true;
 
@@ -1143,7 +1154,7 @@ bool Subsystem::namespaceAttachment(SQEntryWrapper &req,
         }
       }
       else if (sel == 0x01) {  // Detach
-        for (auto &iter : lNamespaces) {
+        for (auto &iter : pContext->pThis->lNamespaces) {
           if (iter->getNSID() == nsid) {
             if (iter->isAttached()) {
               iter->attach(false);
@@ -1176,7 +1187,8 @@ bool Subsystem::namespaceAttachment(SQEntryWrapper &req,
     pContext->dma->read(0, 0x1000, pContext->buffer, dmaDone, context);
   };
 
-  IOContext *pContext = new IOContext(func, resp);
+  NamespaceAttachmentContext *pContext =
+      new NamespaceAttachmentContext(this, func, resp);
 
   pContext->buffer = (uint8_t *)calloc(0x1000, 1);
   pContext->slba = sel;
@@ -1299,12 +1311,24 @@ void Subsystem::getStatList(std::vector<Stats> &list, std::string prefix) {
   list.push_back(temp);
 
   pHIL->getStatList(list, prefix);
+
+  temp.name = prefix + "memory.disk_image";
+  temp.desc = "Host memory used by disk image of all namespaces in byte";
+  list.push_back(temp);
 }
 
 void Subsystem::getStatValues(std::vector<double> &values) {
   values.push_back(commandCount);
 
   pHIL->getStatValues(values);
+
+  uint64_t disk = 0;
+
+  for (auto &iter : lNamespaces) {
+    disk += iter->getMemoryUsage();
+  }
+
+  values.push_back(disk);
 }
 
 void Subsystem::resetStatValues() {
@@ -1313,6 +1337,79 @@ void Subsystem::resetStatValues() {
   pHIL->resetStatValues();
 }
 
+void Subsystem::getMemoryUsage(std::vector<MemoryUsage> &list,
+                               std::string prefix) {
+  MemoryUsage temp;
+
+  pHIL->getMemoryUsage(list, prefix);
+
+  temp.name = prefix + "memory.disk_image";
+  temp.desc = "Host memory used by disk image of all namespaces in byte";
+  temp.bytes = 0;
+
+  for (auto &iter : lNamespaces) {
+    temp.bytes += iter->getMemoryUsage();
+  }
+
+  list.push_back(temp);
+}
+
+void Subsystem::saveState(std::ostream &out) {
+  pushTag(out, "NVMS");
+
+  pushValue(out, queueAllocated);
+  pushValue(out, globalHealth);
+  pushValue(out, commandCount);
+
+  pushValue(out, (uint64_t)lNamespaces.size());
+
+  for (auto &iter : lNamespaces) {
+    pushValue(out, iter->getNSID());
+    pushValue(out, *iter->getInfo());
+
+    iter->saveState(out);
+  }
+
+  pHIL->saveState(out);
+}
+
+void Subsystem::loadState(std::istream &in) {
+  uint64_t size;
+  uint32_t nsid;
+  Namespace::Information info;
+
+  popTag(in, "NVMS");
+
+  popValue(in, queueAllocated);
+  popValue(in, globalHealth);
+  popValue(in, commandCount);
+
+  // Namespaces are recreated at saved LPN range, instead of createNamespace
+  for (auto &iter : lNamespaces) {
+    delete iter;
+  }
+
+  lNamespaces.clear();
+  allocatedLogicalPages = 0;
+
+  popValue(in, size);
+
+  for (uint64_t i = 0; i < size; i++) {
+    Namespace *pNS = new Namespace(this, cfgdata);
+
+    popValue(in, nsid);
+    popValue(in, info);
+
+    pNS->setData(nsid, &info);
+    pNS->loadState(in);
+
+    allocatedLogicalPages += info.range.nlp;
+    lNamespaces.push_back(pNS);
+  }
+
+  pHIL->loadState(in);
+}
+
 }  // namespace NVMe
 
 }  // namespace HIL
@@ -104,6 +104,8 @@ class Device : public StatObject {
   uint32_t logicalPageSize;
   uint32_t lbaSize;
 
+  uint16_t identifyData[256];  //!< Buffer for IDENTIFY DEVICE
+
   ConfigReader &conf;
 
   // Handlers
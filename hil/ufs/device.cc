@@ -125,6 +125,8 @@ Device::Device(DMAInterface *d, ConfigReader &c)
       lunBoot(true, WLUN_BOOT, c),
       lunRPMB(true, WLUN_RPMB, c),
       lun(false, 0x00, c) {
+  lbaSize = conf.readUint(CONFIG_UFS, UFS_LBA_SIZE);
+
   // Initialize Strings
   sprintf((char *)strManufacturer, "CAMELab");
   sprintf((char *)strProductName, "SimpleSSD UFS Device");
@@ -398,7 +400,6 @@ void Device::processCommand(UTP_TRANSFER_CMD cmd, UPIUCommand *req,
                             UPIUResponse *resp, uint8_t *prdt,
                             uint32_t prdtLength, DMAFunction &func,
                             void *context) {
-  static uint64_t lbaSize = conf.readUint(CONFIG_UFS, UFS_LBA_SIZE);
   bool immediate = true;
   uint8_t *buffer = nullptr;
   uint64_t length = 0;
@@ -876,7 +877,6 @@ void Device::prdtWrite(uint8_t *prdt, uint32_t prdtLength, uint32_t length,
 }
 
 void Device::convertUnit(uint64_t slba, uint64_t nlblk, Request &req) {
-  static uint64_t lbaSize = conf.readUint(CONFIG_UFS, UFS_LBA_SIZE);
   uint32_t lbaratio = logicalPageSize / lbaSize;
   uint64_t slpn;
   uint64_t nlp;
@@ -52,6 +52,7 @@ class Device : public StatObject {
 
   uint64_t totalLogicalPages;
   uint32_t logicalPageSize;
+  uint64_t lbaSize;
 
   ConfigReader &conf;
 
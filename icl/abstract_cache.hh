@@ -39,7 +39,7 @@ typedef struct _Line {
   _Line(uint64_t, bool);
 } Line;
 
-class AbstractCache : public StatObject {
+class AbstractCache : public StatObject, public StateObject {
  protected:
   ConfigReader &conf;
   FTL::FTL *pFTL;
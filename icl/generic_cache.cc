@@ -23,7 +23,9 @@
 #include <cstddef>
 #include <limits>
 
+#include "sim/request_trace.hh"
 #include "util/algorithm.hh"
+#include "util/memory.hh"
 
 namespace SimpleSSD {
 
@@ -35,16 +37,19 @@ GenericCache::GenericCache(ConfigReader &c, FTL::FTL *f, DRAM::AbstractDRAM *d)
       parallelIO(f->getInfo()->pageCountToMaxPerf),
       lineCountInSuperPage(f->getInfo()->ioUnitInPage),
       lineCountInMaxIO(parallelIO * lineCountInSuperPage),
+      setSize(0),
       waySize(conf.readUint(CONFIG_ICL, ICL_WAY_SIZE)),
       prefetchIOCount(conf.readUint(CONFIG_ICL, ICL_PREFETCH_COUNT)),
       prefetchIORatio(conf.readFloat(CONFIG_ICL, ICL_PREFETCH_RATIO)),
       useReadCaching(conf.readBoolean(CONFIG_ICL, ICL_USE_READ_CACHE)),
       useWriteCaching(conf.readBoolean(CONFIG_ICL, ICL_USE_WRITE_CACHE)),
       useReadPrefetch(conf.readBoolean(CONFIG_ICL, ICL_USE_READ_PREFETCH)),
-      gen(rd()),
-      dist(std::uniform_int_distribution<uint32_t>(0, waySize - 1)) {
+      rng(getRandomStream(RANDOM_ICL_CACHE)) {
   uint64_t cacheSize = conf.readUint(CONFIG_ICL, ICL_CACHE_SIZE);
+  uint64_t core = conf.readUint(CONFIG_CPU, CPU::CPU_CORE_ICL);
 
+  cacheLatency =
+      (core == 0) ? 0 : conf.readUint(CONFIG_ICL, ICL_CACHE_LATENCY) / core;
   lineSize = superPageSize / lineCountInSuperPage;
 
   if (lineSize != superPageSize) {
@@ -57,6 +62,8 @@ GenericCache::GenericCache(ConfigReader &c, FTL::FTL *f, DRAM::AbstractDRAM *d)
     lineCountInMaxIO = parallelIO;
   }
 
+  memset(&stat, 0, sizeof(stat));
+
   if (!useReadCaching && !useWriteCaching) {
     return;
   }
@@ -102,11 +109,11 @@ GenericCache::GenericCache(ConfigReader &c, FTL::FTL *f, DRAM::AbstractDRAM *d)
   switch (policy) {
     case POLICY_RANDOM:
       evictFunction = [this](uint32_t, uint64_t &) -> uint32_t {
-        return dist(gen);
+        return (uint32_t)rng.next(waySize);
       };
       compareFunction = [this](Line *a, Line *b) -> Line * {
         if (a && b) {
-          return dist(gen) > waySize / 2 ? a : b;
+          return rng.next(waySize) > waySize / 2 ? a : b;
         }
         else if (a || b) {
           return a ? a : b;
@@ -194,8 +201,6 @@ GenericCache::GenericCache(ConfigReader &c, FTL::FTL *f, DRAM::AbstractDRAM *d)
 
       break;
   }
-
-  memset(&stat, 0, sizeof(stat));
 }
 
 GenericCache::~GenericCache() {
@@ -213,10 +218,7 @@ GenericCache::~GenericCache() {
 }
 
 uint64_t GenericCache::getCacheLatency() {
-  static uint64_t latency = conf.readUint(CONFIG_ICL, ICL_CACHE_LATENCY);
-  static uint64_t core = conf.readUint(CONFIG_CPU, CPU::CPU_CORE_ICL);
-
-  return (core == 0) ? 0 : latency / core;
+  return cacheLatency;
 }
 
 uint32_t GenericCache::calcSetIndex(uint64_t lca) {
@@ -306,6 +308,7 @@ void GenericCache::evictCache(uint64_t tick, bool flush) {
   FTL::Request reqInternal(lineCountInSuperPage);
   uint64_t beginAt;
   uint64_t finishedAt = tick;
+  uint64_t traced = traceRequest(0);  // Eviction runs in background
 
   debugprint(LOG_ICL_GENERIC_CACHE, "----- | Begin eviction");
 
@@ -342,11 +345,14 @@ void GenericCache::evictCache(uint64_t tick, bool flush) {
   debugprint(LOG_ICL_GENERIC_CACHE,
              "----- | End eviction | %" PRIu64 " - %" PRIu64 " (%" PRIu64 ")",
              tick, finishedAt, finishedAt - tick);
+
+  traceRequest(traced);
 }
 
 // True when hit
 bool GenericCache::read(Request &req, uint64_t &tick) {
   bool ret = false;
+  uint64_t begin = tick;
 
   debugprint(LOG_ICL_GENERIC_CACHE,
              "READ  | REQ %7u-%-4u | LCA %" PRIu64 " | SIZE %" PRIu64,
@@ -535,6 +541,8 @@ bool GenericCache::read(Request &req, uint64_t &tick) {
     pFTL->read(reqInternal, tick);
   }
 
+  traceSpan(ret ? TRACE_ICL_HIT : TRACE_ICL_MISS, req.reqSubID, begin, tick);
+
   stat.request[0]++;
 
   if (ret) {
@@ -547,6 +555,7 @@ bool GenericCache::read(Request &req, uint64_t &tick) {
 // True when cold-miss/hit
 bool GenericCache::write(Request &req, uint64_t &tick) {
   bool ret = false;
+  uint64_t begin = tick;
   uint64_t flash = tick;
   bool dirty = false;
 
@@ -742,6 +751,8 @@ bool GenericCache::write(Request &req, uint64_t &tick) {
     pDRAM->setScheduling(true);
   }
 
+  traceSpan(ret ? TRACE_ICL_HIT : TRACE_ICL_MISS, req.reqSubID, begin, tick);
+
   stat.request[1]++;
 
   if (ret) {
@@ -872,6 +883,60 @@ void GenericCache::resetStatValues() {
   memset(&stat, 0, sizeof(stat));
 }
 
+void GenericCache::getMemoryUsage(std::vector<MemoryUsage> &list,
+                                  std::string prefix) {
+  MemoryUsage temp;
+
+  temp.name = prefix + "memory.cache_lines";
+  temp.desc = "Host memory used by cache line metadata in byte";
+  temp.bytes =
+      memoryUsage(cacheData) +
+      cacheData.size() * allocationSize(waySize * sizeof(Line)) +
+      memoryUsage(evictData) +
+      evictData.size() * allocationSize(parallelIO * sizeof(Line *));
+  list.push_back(temp);
+}
+
+void GenericCache::saveState(std::ostream &out) {
+  pushTag(out, "ICLG");
+
+  pushValue(out, (uint64_t)setSize);
+  pushValue(out, (uint64_t)waySize);
+  pushValue(out, (uint64_t)lineSize);
+
+  for (uint32_t i = 0; i < setSize; i++) {
+    out.write((const char *)cacheData[i], waySize * sizeof(Line));
+  }
+
+  pushValue(out, readDetect);
+  pushValue(out, prefetchTrigger);
+  pushValue(out, lastPrefetched);
+  pushValue(out, stat);
+
+  // Random eviction policy
+  pushValue(out, rng);
+}
+
+void GenericCache::loadState(std::istream &in) {
+  popTag(in, "ICLG");
+
+  checkValue(in, setSize, "Cache set count");
+  checkValue(in, waySize, "Cache way count");
+  checkValue(in, lineSize, "Cache line size");
+
+  for (uint32_t i = 0; i < setSize; i++) {
+    in.read((char *)cacheData[i], waySize * sizeof(Line));
+    checkStream(in);
+  }
+
+  popValue(in, readDetect);
+  popValue(in, prefetchTrigger);
+  popValue(in, lastPrefetched);
+  popValue(in, stat);
+
+  popValue(in, rng);
+}
+
 }  // namespace ICL
 
 }  // namespace SimpleSSD
@@ -21,10 +21,10 @@
 #define __ICL_GENERIC_CACHE__
 
 #include <functional>
-#include <random>
 #include <vector>
 
 #include "icl/abstract_cache.hh"
+#include "util/random.hh"
 
 namespace SimpleSSD {
 
@@ -47,6 +47,8 @@ class GenericCache : public AbstractCache {
   const bool useWriteCaching;
   const bool useReadPrefetch;
 
+  uint64_t cacheLatency;
+
   bool bSuperPage;
 
   struct SequentialDetect {
@@ -68,9 +70,7 @@ class GenericCache : public AbstractCache {
   EVICT_POLICY policy;
   std::function<uint32_t(uint32_t, uint64_t &)> evictFunction;
   std::function<Line *(Line *, Line *)> compareFunction;
-  std::random_device rd;
-  std::mt19937 gen;
-  std::uniform_int_distribution<uint32_t> dist;
+  Random rng;  // For random eviction policy
 
   std::vector<Line *> cacheData;
   std::vector<Line **> evictData;
@@ -106,6 +106,10 @@ class GenericCache : public AbstractCache {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace ICL
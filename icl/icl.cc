@@ -21,6 +21,7 @@
 
 #include "dram/simple.hh"
 #include "icl/generic_cache.hh"
+#include "sim/profile.hh"
 #include "util/algorithm.hh"
 #include "util/def.hh"
 
@@ -64,6 +65,8 @@ ICL::~ICL() {
 }
 
 void ICL::read(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_ICL);
+
   uint64_t beginAt;
   uint64_t finishedAt = tick;
   uint64_t reqRemain = req.length;
@@ -96,6 +99,8 @@ void ICL::read(Request &req, uint64_t &tick) {
 }
 
 void ICL::write(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_ICL);
+
   uint64_t beginAt;
   uint64_t finishedAt = tick;
   uint64_t reqRemain = req.length;
@@ -128,6 +133,8 @@ void ICL::write(Request &req, uint64_t &tick) {
 }
 
 void ICL::flush(LPNRange &range, uint64_t &tick) {
+  ProfileScope scope(PROFILE_ICL);
+
   uint64_t beginAt = tick;
 
   pCache->flush(range, tick);
@@ -141,6 +148,8 @@ void ICL::flush(LPNRange &range, uint64_t &tick) {
 }
 
 void ICL::trim(LPNRange &range, uint64_t &tick) {
+  ProfileScope scope(PROFILE_ICL);
+
   uint64_t beginAt = tick;
 
   pCache->trim(range, tick);
@@ -154,6 +163,8 @@ void ICL::trim(LPNRange &range, uint64_t &tick) {
 }
 
 void ICL::format(LPNRange &range, uint64_t &tick) {
+  ProfileScope scope(PROFILE_ICL);
+
   uint64_t beginAt = tick;
 
   pCache->format(range, tick);
@@ -195,6 +206,23 @@ void ICL::resetStatValues() {
   pFTL->resetStatValues();
 }
 
+void ICL::getMemoryUsage(std::vector<MemoryUsage> &list, std::string prefix) {
+  pCache->getMemoryUsage(list, prefix + "icl.");
+  pFTL->getMemoryUsage(list, prefix);
+}
+
+void ICL::saveState(std::ostream &out) {
+  pCache->saveState(out);
+  pDRAM->saveState(out);
+  pFTL->saveState(out);
+}
+
+void ICL::loadState(std::istream &in) {
+  pCache->loadState(in);
+  pDRAM->loadState(in);
+  pFTL->loadState(in);
+}
+
 }  // namespace ICL
 
 }  // namespace SimpleSSD
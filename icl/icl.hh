@@ -29,7 +29,7 @@ namespace SimpleSSD {
 
 namespace ICL {
 
-class ICL : public StatObject {
+class ICL : public StatObject, public StateObject {
  private:
   FTL::FTL *pFTL;
   DRAM::AbstractDRAM *pDRAM;
@@ -57,6 +57,10 @@ class ICL : public StatObject {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace ICL
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "igl/block_io.hh"
+
+#include <iomanip>
+
+#include "util/algorithm.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+const char *ioTypeName[IO_NUM] = {"read", "write", "flush", "trim"};
+
+typedef struct _IOContext {
+  DMAFunction function;
+  void *context;
+
+  _IOContext(DMAFunction &f, void *c) : function(f), context(c) {}
+} IOContext;
+
+BlockIO::BlockIO(HIL::HIL *p) : pHIL(p), outstanding(0) {
+  pHIL->getLPNInfo(totalLogicalPages, logicalPageSize);
+
+  completion = [this](uint64_t tick, void *context) {
+    auto pContext = (IOContext *)context;
+
+    outstanding--;
+
+    pContext->function(tick, pContext->context);
+
+    delete pContext;
+  };
+}
+
+BlockIO::~BlockIO() {}
+
+void BlockIO::submit(IO_TYPE type, uint64_t offset, uint64_t length,
+                     DMAFunction &func, void *context) {
+  HIL::Request req(completion, new IOContext(func, context));
+
+  if (type == IO_FLUSH) {
+    req.range.slpn = 0;
+    req.range.nlp = totalLogicalPages;
+    req.offset = 0;
+    req.length = totalLogicalPages * logicalPageSize;
+  }
+  else {
+    if (length == 0 || offset + length > getCapacity()) {
+      panic("I/O out of range: offset %" PRIu64 " + %" PRIu64, offset,
+            length);
+    }
+
+    req.range.slpn = offset / logicalPageSize;
+    req.offset = offset % logicalPageSize;
+    req.range.nlp =
+        (req.offset + length + logicalPageSize - 1) / logicalPageSize;
+    req.length = length;
+  }
+
+  outstanding++;
+
+  switch (type) {
+    case IO_READ:
+      pHIL->read(req);
+      break;
+    case IO_WRITE:
+      pHIL->write(req);
+      break;
+    case IO_FLUSH:
+      pHIL->flush(req);
+      break;
+    case IO_TRIM:
+      pHIL->trim(req);
+      break;
+    default:
+      panic("Invalid I/O type %u", type);
+      break;
+  }
+}
+
+uint64_t BlockIO::getCapacity() {
+  return totalLogicalPages * logicalPageSize;
+}
+
+uint32_t BlockIO::getLogicalPageSize() {
+  return logicalPageSize;
+}
+
+uint64_t BlockIO::getOutstanding() {
+  return outstanding;
+}
+
+void BlockIO::getStatList(std::vector<Stats> &list, std::string prefix) {
+  pHIL->getStatList(list, prefix + "hil.");
+  getCPUStatList(list, prefix + "cpu.");
+}
+
+void BlockIO::getStatValues(std::vector<double> &values) {
+  pHIL->getStatValues(values);
+  getCPUStatValues(values);
+}
+
+void BlockIO::printStats(std::ostream &os) {
+  std::vector<Stats> list;
+  std::vector<double> values;
+
+  getStatList(list, "");
+  getStatValues(values);
+
+  for (uint64_t i = 0; i < list.size() && i < values.size(); i++) {
+    os << std::left << std::setw(50) << list[i].name << " " << std::setw(20)
+       << values[i] << " # " << list[i].desc << std::endl;
+  }
+}
+
+void BlockIO::printMemoryUsage(std::ostream &os) {
+  std::vector<MemoryUsage> list;
+  uint64_t total = 0;
+
+  pHIL->getMemoryUsage(list, "");
+
+  for (auto &iter : list) {
+    total += iter.bytes;
+  }
+
+  os << "Host memory usage (estimated): " << std::fixed << std::setprecision(3)
+     << total / 1048576. << " MiB" << std::endl;
+  os << "  " << std::left << std::setw(32) << "structure" << std::right
+     << std::setw(16) << "bytes" << std::setw(12) << "MiB" << std::setw(8)
+     << "share" << std::endl;
+
+  for (auto &iter : list) {
+    os << "  " << std::left << std::setw(32) << iter.name << std::right
+       << std::setw(16) << iter.bytes << std::setw(12) << std::setprecision(3)
+       << iter.bytes / 1048576. << std::setw(7) << std::setprecision(1)
+       << (total ? iter.bytes * 100. / total : 0.) << "%" << std::endl;
+  }
+
+  os.unsetf(std::ios::floatfield);
+  os << std::setprecision(6);
+}
+
+IOStatistics::IOStatistics() {
+  reset();
+}
+
+void IOStatistics::add(IO_TYPE type, uint64_t size, uint64_t arrivedAt,
+                       uint64_t finishedAt) {
+  bytes[type] += size;
+  latency[type].add(finishedAt - arrivedAt);
+
+  firstArrival = MIN(firstArrival, arrivedAt);
+  lastCompletion = MAX(lastCompletion, finishedAt);
+}
+
+void IOStatistics::merge(const IOStatistics &rhs) {
+  for (int i = 0; i < IO_NUM; i++) {
+    bytes[i] += rhs.bytes[i];
+    latency[i].merge(rhs.latency[i]);
+  }
+
+  firstArrival = MIN(firstArrival, rhs.firstArrival);
+  lastCompletion = MAX(lastCompletion, rhs.lastCompletion);
+}
+
+uint64_t IOStatistics::getCount() {
+  uint64_t count = 0;
+
+  for (int i = 0; i < IO_NUM; i++) {
+    count += latency[i].getCount();
+  }
+
+  return count;
+}
+
+double IOStatistics::getElapsed() {
+  double elapsed = 0.;
+
+  if (lastCompletion > firstArrival) {
+    // Tick is in pico-second
+    elapsed = (lastCompletion - firstArrival) / 1000000000000.;
+  }
+
+  return elapsed;
+}
+
+void IOStatistics::getStatList(std::vector<Stats> &list, std::string prefix) {
+  Stats temp;
+
+  temp.name = prefix + "elapsed";
+  temp.desc = "Time from first arrival to last completion (s)";
+  list.push_back(temp);
+
+  for (int i = 0; i < IO_NUM; i++) {
+    std::string name = prefix + ioTypeName[i] + ".";
+    std::string type = ioTypeName[i];
+
+    temp.name = name + "count";
+    temp.desc = "Number of " + type + " requests";
+    list.push_back(temp);
+
+    temp.name = name + "iops";
+    temp.desc = "Throughput of " + type + " requests (IOPS)";
+    list.push_back(temp);
+
+    temp.name = name + "bandwidth";
+    temp.desc = "Bandwidth of " + type + " requests (MiB/s)";
+    list.push_back(temp);
+
+    temp.name = name + "latency.avg";
+    temp.desc = "Average latency of " + type + " requests (us)";
+    list.push_back(temp);
+
+    temp.name = name + "latency.max";
+    temp.desc = "Maximum latency of " + type + " requests (us)";
+    list.push_back(temp);
+
+    temp.name = name + "latency.p50";
+    temp.desc = "Median latency of " + type + " requests (us)";
+    list.push_back(temp);
+
+    temp.name = name + "latency.p99";
+    temp.desc = "99th percentile latency of " + type + " requests (us)";
+    list.push_back(temp);
+
+    temp.name = name + "latency.p99.9";
+    temp.desc = "99.9th percentile latency of " + type + " requests (us)";
+    list.push_back(temp);
+  }
+}
+
+void IOStatistics::getStatValues(std::vector<double> &values) {
+  double elapsed = getElapsed();
+
+  values.push_back(elapsed);
+
+  for (int i = 0; i < IO_NUM; i++) {
+    auto &hist = latency[i];
+    uint64_t count = hist.getCount();
+
+    values.push_back((double)count);
+    values.push_back(elapsed > 0. ? count / elapsed : 0.);
+    values.push_back(elapsed > 0. ? bytes[i] / elapsed / 1048576. : 0.);
+    values.push_back(hist.getMean() / 1000000.);
+    values.push_back(hist.getMax() / 1000000.);
+    values.push_back(hist.getPercentile(50.) / 1000000.);
+    values.push_back(hist.getPercentile(99.) / 1000000.);
+    values.push_back(hist.getPercentile(99.9) / 1000000.);
+  }
+}
+
+void IOStatistics::print(std::ostream &os, std::string prefix) {
+  const double percentiles[] = {50., 90., 99., 99.9, 99.99};
+  double elapsed = getElapsed();
+
+  os << prefix << "elapsed: " << elapsed << " s" << std::endl;
+
+  for (int i = 0; i < IO_NUM; i++) {
+    auto &hist = latency[i];
+    uint64_t count = hist.getCount();
+
+    if (count == 0) {
+      continue;
+    }
+
+    os << prefix << std::left << std::setw(6) << ioTypeName[i]
+       << std::right << "count: " << count;
+
+    if (elapsed > 0.) {
+      os << ", IOPS: " << count / elapsed
+         << ", BW: " << bytes[i] / elapsed / 1048576. << " MiB/s";
+    }
+
+    os << std::endl;
+
+    // Latency in micro-second
+    os << prefix << "      latency(us) avg: " << hist.getMean() / 1000000.
+       << ", min: " << hist.getMin() / 1000000.
+       << ", max: " << hist.getMax() / 1000000. << std::endl;
+    os << prefix << "      percentile(us)";
+
+    for (auto p : percentiles) {
+      os << " p" << p << ": " << hist.getPercentile(p) / 1000000.;
+    }
+
+    os << std::endl;
+  }
+}
+
+void IOStatistics::printHistogram(std::ostream &os, std::string prefix) {
+  for (int i = 0; i < IO_NUM; i++) {
+    if (latency[i].getCount() == 0) {
+      continue;
+    }
+
+    os << "# " << prefix << ioTypeName[i]
+       << " latency(us): lower upper count cumulative" << std::endl;
+    latency[i].print(os, 1000000.);
+  }
+}
+
+void IOStatistics::reset() {
+  for (int i = 0; i < IO_NUM; i++) {
+    bytes[i] = 0;
+    latency[i].reset();
+  }
+
+  firstArrival = UINT64_MAX;
+  lastCompletion = 0;
+}
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __IGL_BLOCK_IO__
+#define __IGL_BLOCK_IO__
+
+#include <iostream>
+
+#include "hil/hil.hh"
+#include "sim/statistics.hh"
+#include "util/histogram.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+typedef enum {
+  IO_READ,
+  IO_WRITE,
+  IO_FLUSH,
+  IO_TRIM,
+  IO_NUM
+} IO_TYPE;
+
+extern const char *ioTypeName[IO_NUM];
+
+/**
+ * \brief Byte addressed block device on top of HIL
+ *
+ * Drives HIL::HIL directly, without NVMe/SATA/UFS host interface emulation.
+ * Offset and length in byte are converted to logical page range in the same
+ * way as HIL::NVMe::Subsystem::convertUnit.
+ */
+class BlockIO {
+ private:
+  HIL::HIL *pHIL;
+
+  uint64_t totalLogicalPages;
+  uint32_t logicalPageSize;
+
+  uint64_t outstanding;
+  DMAFunction completion;
+
+ public:
+  BlockIO(HIL::HIL *);
+  ~BlockIO();
+
+  void submit(IO_TYPE, uint64_t, uint64_t, DMAFunction &, void * = nullptr);
+
+  uint64_t getCapacity();
+  uint32_t getLogicalPageSize();
+  uint64_t getOutstanding();
+
+  void getStatList(std::vector<Stats> &, std::string);
+  void getStatValues(std::vector<double> &);
+  void printStats(std::ostream &);
+  void printMemoryUsage(std::ostream &);
+};
+
+/**
+ * \brief Host side I/O statistics
+ *
+ * Latency is measured from arrival of request to completion, as seen by host.
+ */
+class IOStatistics {
+ private:
+  uint64_t bytes[IO_NUM];
+  Histogram latency[IO_NUM];
+
+  uint64_t firstArrival;
+  uint64_t lastCompletion;
+
+  double getElapsed();
+
+ public:
+  IOStatistics();
+
+  void add(IO_TYPE, uint64_t, uint64_t, uint64_t);
+  void merge(const IOStatistics &);
+  uint64_t getCount();
+  void getStatList(std::vector<Stats> &, std::string);
+  void getStatValues(std::vector<double> &);
+  void print(std::ostream &, std::string = "");
+  void printHistogram(std::ostream &, std::string = "");
+  void reset();
+};
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
+
+#endif
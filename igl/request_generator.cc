@@ -0,0 +1,592 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "igl/request_generator.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+
+#include "lib/inih/ini.h"
+#include "sim/base_config.hh"
+#include "util/algorithm.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+JobParam::_JobParam()
+    : random(false),
+      readRatio(100),
+      trim(false),
+      offset(0),
+      size(0),
+      offsetRatio(-1.),
+      sizeRatio(-1.),
+      queueDepth(1),
+      ioCount(0),
+      ioSize(0),
+      runtime(0),
+      distribution(DIST_UNIFORM),
+      seed(0) {
+  blockSize.push_back(std::make_pair(4096, 1));
+  distParam[0] = 0.;
+  distParam[1] = 0.;
+}
+
+// Parse size with k, m, g, t suffix (power of 1024)
+static bool parseSize(const char *str, uint64_t &size) {
+  char *end = nullptr;
+
+  size = strtoull(str, &end, 10);
+
+  if (end == str) {
+    return false;
+  }
+
+  switch (tolower(*end)) {
+    case 't':
+      size <<= 10;
+      /* fallthrough */
+    case 'g':
+      size <<= 10;
+      /* fallthrough */
+    case 'm':
+      size <<= 10;
+      /* fallthrough */
+    case 'k':
+      size <<= 10;
+      /* fallthrough */
+    case 'b':
+    case 0:
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+// Parse size or percentage
+static bool parseSizeOrRatio(const char *str, uint64_t &size, double &ratio) {
+  if (strchr(str, '%')) {
+    ratio = strtod(str, nullptr) / 100.;
+
+    return ratio >= 0. && ratio <= 1.;
+  }
+
+  ratio = -1.;
+
+  return parseSize(str, size);
+}
+
+// Parse time in second with us, ms, s suffix into pico-second
+static bool parseTime(const char *str, uint64_t &tick) {
+  char *end = nullptr;
+  double value = strtod(str, &end);
+
+  if (end == str) {
+    return false;
+  }
+
+  if (strcmp(end, "us") == 0) {
+    value *= 1e6;
+  }
+  else if (strcmp(end, "ms") == 0) {
+    value *= 1e9;
+  }
+  else if (strcmp(end, "s") == 0 || *end == 0) {
+    value *= 1e12;
+  }
+  else {
+    return false;
+  }
+
+  tick = (uint64_t)value;
+
+  return true;
+}
+
+typedef struct {
+  std::vector<JobParam> *jobs;
+  JobParam global;
+  std::string section;
+  bool isGlobal;
+} JobFileContext;
+
+static bool setJobParam(JobParam &job, const char *name, const char *value) {
+  bool ret = true;
+
+  if (MATCH_NAME("rw") || MATCH_NAME("readwrite")) {
+    job.random = strncmp(value, "rand", 4) == 0;
+    job.trim = false;
+
+    if (job.random) {
+      value += 4;
+    }
+
+    if (MATCH_VALUE("read")) {
+      job.readRatio = 100;
+    }
+    else if (MATCH_VALUE("write")) {
+      job.readRatio = 0;
+    }
+    else if (MATCH_VALUE("trim")) {
+      job.readRatio = 0;
+      job.trim = true;
+    }
+    else if (MATCH_VALUE("rw") || MATCH_VALUE("readwrite")) {
+      job.readRatio = 50;
+    }
+    else {
+      ret = false;
+    }
+  }
+  else if (MATCH_NAME("rwmixread")) {
+    job.readRatio = (uint32_t)strtoul(value, nullptr, 10);
+    ret = job.readRatio <= 100;
+  }
+  else if (MATCH_NAME("rwmixwrite")) {
+    job.readRatio = 100 - (uint32_t)strtoul(value, nullptr, 10);
+    ret = job.readRatio <= 100;
+  }
+  else if (MATCH_NAME("bs") || MATCH_NAME("blocksize")) {
+    uint64_t size;
+
+    ret = parseSize(value, size) && size > 0;
+
+    job.blockSize.clear();
+    job.blockSize.push_back(std::make_pair(size, 1));
+  }
+  else if (MATCH_NAME("bssplit")) {
+    std::string list(value);
+    size_t pos = 0;
+
+    job.blockSize.clear();
+
+    // 4k/70:64k/30
+    while (ret && pos < list.length()) {
+      size_t next = list.find(':', pos);
+      std::string item = list.substr(pos, next - pos);
+      size_t slash = item.find('/');
+      uint64_t size;
+      uint32_t weight = 1;
+
+      if (slash != std::string::npos) {
+        weight = (uint32_t)strtoul(item.c_str() + slash + 1, nullptr, 10);
+        item.resize(slash);
+      }
+
+      ret = parseSize(item.c_str(), size) && size > 0;
+
+      if (weight > 0) {
+        job.blockSize.push_back(std::make_pair(size, weight));
+      }
+
+      pos = next == std::string::npos ? next : next + 1;
+    }
+
+    ret = ret && job.blockSize.size() > 0;
+  }
+  else if (MATCH_NAME("offset")) {
+    ret = parseSizeOrRatio(value, job.offset, job.offsetRatio);
+  }
+  else if (MATCH_NAME("size")) {
+    ret = parseSizeOrRatio(value, job.size, job.sizeRatio);
+  }
+  else if (MATCH_NAME("iodepth")) {
+    job.queueDepth = (uint32_t)strtoul(value, nullptr, 10);
+    ret = job.queueDepth > 0;
+  }
+  else if (MATCH_NAME("number_ios")) {
+    job.ioCount = strtoull(value, nullptr, 10);
+  }
+  else if (MATCH_NAME("io_size")) {
+    ret = parseSize(value, job.ioSize);
+  }
+  else if (MATCH_NAME("runtime")) {
+    ret = parseTime(value, job.runtime);
+  }
+  else if (MATCH_NAME("random_distribution")) {
+    if (MATCH_VALUE("random")) {
+      job.distribution = DIST_UNIFORM;
+    }
+    else if (strncmp(value, "zipf:", 5) == 0) {
+      job.distribution = DIST_ZIPF;
+      job.distParam[0] = strtod(value + 5, nullptr);
+      ret = job.distParam[0] > 0.;
+    }
+    else if (strncmp(value, "hotcold:", 8) == 0) {
+      char *end = nullptr;
+
+      job.distribution = DIST_HOTCOLD;
+      job.distParam[0] = strtod(value + 8, &end);
+      job.distParam[1] = *end == ':' ? strtod(end + 1, nullptr) : -1.;
+      ret = job.distParam[0] > 0. && job.distParam[0] <= 1. &&
+            job.distParam[1] >= 0. && job.distParam[1] <= 1.;
+    }
+    else {
+      ret = false;
+    }
+  }
+  else if (MATCH_NAME("randseed")) {
+    job.seed = strtoull(value, nullptr, 10);
+  }
+  else {
+    ret = false;
+  }
+
+  return ret;
+}
+
+static int jobFileHandler(void *context, const char *section,
+                          const char *name, const char *value) {
+  auto pContext = (JobFileContext *)context;
+
+  if (pContext->section != section) {
+    pContext->section = section;
+    pContext->isGlobal = MATCH_SECTION("global");
+
+    if (!pContext->isGlobal) {
+      pContext->jobs->push_back(pContext->global);
+      pContext->jobs->back().name = section;
+    }
+  }
+
+  JobParam &job =
+      pContext->isGlobal ? pContext->global : pContext->jobs->back();
+
+  if (!setJobParam(job, name, value)) {
+    warn("Invalid job option %s = %s in [%s]", name, value, section);
+
+    return 0;
+  }
+
+  return 1;
+}
+
+bool loadJobFile(std::string path, std::vector<JobParam> &jobs) {
+  JobFileContext context;
+  int ret;
+
+  context.jobs = &jobs;
+  context.isGlobal = true;
+
+  jobs.clear();
+
+  ret = ini_parse(path.c_str(), jobFileHandler, &context);
+
+  if (ret < 0) {
+    return false;
+  }
+  else if (ret > 0) {
+    warn("Failed to parse job file %s at line %d", path.c_str(), ret);
+
+    return false;
+  }
+
+  // Different default seed for each job
+  for (uint64_t i = 0; i < jobs.size(); i++) {
+    if (jobs[i].seed == 0) {
+      jobs[i].seed = i + 1;
+    }
+  }
+
+  return jobs.size() > 0;
+}
+
+ZipfSampler::ZipfSampler(uint64_t count, double e) : n(count), exponent(e) {
+  hIntegralX1 = hIntegral(1.5) - 1.;
+  hIntegralN = hIntegral(n + 0.5);
+  s = 2. - hIntegralInverse(hIntegral(2.5) - h(2.));
+}
+
+double ZipfSampler::h(double x) {
+  return exp(-exponent * log(x));
+}
+
+double ZipfSampler::hIntegral(double x) {
+  double logX = log(x);
+  double t = (1. - exponent) * logX;
+
+  // expm1(t) / t, stable around zero
+  t = fabs(t) > 1e-8 ? expm1(t) / t : 1. + t * 0.5 * (1. + t / 3. * (1. + t * 0.25));
+
+  return t * logX;
+}
+
+double ZipfSampler::hIntegralInverse(double x) {
+  double t = x * (1. - exponent);
+
+  if (t < -1.) {
+    t = -1.;
+  }
+
+  // log1p(t) / t, stable around zero
+  t = fabs(t) > 1e-8 ? log1p(t) / t : 1. - t * (0.5 - t * (1. / 3. - 0.25 * t));
+
+  return exp(t * x);
+}
+
+uint64_t ZipfSampler::sample(std::mt19937_64 &rng) {
+  std::uniform_real_distribution<double> dist(0., 1.);
+
+  while (true) {
+    double u = hIntegralN + dist(rng) * (hIntegralX1 - hIntegralN);
+    double x = hIntegralInverse(u);
+    uint64_t k = (uint64_t)(x + 0.5);
+
+    if (k < 1) {
+      k = 1;
+    }
+    else if (k > n) {
+      k = n;
+    }
+
+    if (k - x <= s || u >= hIntegral(k + 0.5) - h((double)k)) {
+      return k;
+    }
+  }
+}
+
+RequestGenerator::RequestGenerator(BlockIO &b, JobParam &p)
+    : io(b),
+      param(p),
+      rng(p.seed),
+      realDist(0., 1.),
+      zipf(nullptr),
+      multiplier(1),
+      blockSizeWeight(0),
+      cursor(0),
+      beginAt(0),
+      issuedCount(0),
+      issuedBytes(0),
+      outstanding(0),
+      reachEnd(false) {
+  uint64_t capacity = io.getCapacity();
+
+  granularity = UINT64_MAX;
+
+  for (auto &iter : param.blockSize) {
+    granularity = MIN(granularity, iter.first);
+    blockSizeWeight += iter.second;
+  }
+
+  // Resolve I/O region
+  if (param.offsetRatio >= 0.) {
+    param.offset = (uint64_t)(capacity * param.offsetRatio);
+  }
+
+  param.offset -= param.offset % granularity;
+
+  if (param.sizeRatio >= 0.) {
+    param.size = (uint64_t)(capacity * param.sizeRatio);
+  }
+
+  if (param.size == 0 || param.offset + param.size > capacity) {
+    if (param.offset >= capacity) {
+      panic("Job %s: offset is beyond capacity", param.name.c_str());
+    }
+
+    param.size = capacity - param.offset;
+  }
+
+  param.size -= param.size % granularity;
+  units = param.size / granularity;
+
+  for (auto &iter : param.blockSize) {
+    if (iter.first > param.size) {
+      panic("Job %s: block size is larger than I/O region",
+            param.name.c_str());
+    }
+  }
+
+  // Write whole region once if no limit is given
+  if (param.ioCount == 0 && param.ioSize == 0 && param.runtime == 0) {
+    param.ioSize = param.size;
+  }
+
+  if (param.random && param.distribution == DIST_ZIPF) {
+    zipf = new ZipfSampler(units, param.distParam[0]);
+
+    // Hot ranks should not be adjacent
+    multiplier = 999983;
+
+    while (std::gcd(multiplier, units) != 1) {
+      multiplier += 2;
+    }
+  }
+
+  completion = [this](uint64_t tick, void *context) {
+    auto pRecord = (IORecord *)context;
+
+    stat.add(pRecord->type, pRecord->length, pRecord->issuedAt, tick);
+    outstanding--;
+
+    delete pRecord;
+
+    while (outstanding < param.queueDepth && canIssue()) {
+      issue();
+    }
+
+    checkEnd();
+  };
+}
+
+RequestGenerator::~RequestGenerator() {
+  delete zipf;
+}
+
+bool RequestGenerator::canIssue() {
+  if (param.ioCount > 0 && issuedCount >= param.ioCount) {
+    return false;
+  }
+
+  if (param.ioSize > 0 && issuedBytes >= param.ioSize) {
+    return false;
+  }
+
+  if (param.runtime > 0 && getTick() >= beginAt + param.runtime) {
+    return false;
+  }
+
+  return true;
+}
+
+uint64_t RequestGenerator::nextBlockSize() {
+  if (param.blockSize.size() == 1) {
+    return param.blockSize.front().first;
+  }
+
+  uint64_t pick = rng() % blockSizeWeight;
+
+  for (auto &iter : param.blockSize) {
+    if (pick < iter.second) {
+      return iter.first;
+    }
+
+    pick -= iter.second;
+  }
+
+  return param.blockSize.back().first;
+}
+
+uint64_t RequestGenerator::nextOffset(uint64_t length) {
+  uint64_t offset = 0;
+
+  if (param.random) {
+    uint64_t index = 0;
+
+    switch (param.distribution) {
+      case DIST_UNIFORM:
+        index = rng() % units;
+
+        break;
+      case DIST_ZIPF:
+        index = ((zipf->sample(rng) - 1) * multiplier) % units;
+
+        break;
+      case DIST_HOTCOLD: {
+        uint64_t hot = MAX((uint64_t)(units * param.distParam[0]), 1);
+
+        if (hot >= units || realDist(rng) < param.distParam[1]) {
+          index = rng() % hot;
+        }
+        else {
+          index = hot + rng() % (units - hot);
+        }
+      } break;
+    }
+
+    offset = index * granularity;
+
+    if (offset + length > param.size) {
+      offset = param.size - length;
+      offset -= offset % granularity;
+    }
+  }
+  else {
+    if (cursor + length > param.size) {
+      cursor = 0;
+    }
+
+    offset = cursor;
+    cursor += length;
+  }
+
+  return param.offset + offset;
+}
+
+void RequestGenerator::issue() {
+  IO_TYPE type = IO_WRITE;
+  uint64_t length = nextBlockSize();
+
+  if (param.trim) {
+    type = IO_TRIM;
+  }
+  else if (param.readRatio == 100 ||
+           (param.readRatio > 0 && realDist(rng) * 100. < param.readRatio)) {
+    type = IO_READ;
+  }
+
+  issuedCount++;
+  issuedBytes += length;
+  outstanding++;
+
+  io.submit(type, nextOffset(length), length, completion,
+            new IORecord{type, length, getTick()});
+}
+
+void RequestGenerator::checkEnd() {
+  if (!reachEnd && outstanding == 0 && !canIssue()) {
+    reachEnd = true;
+
+    if (endHandler) {
+      endHandler();
+    }
+  }
+}
+
+void RequestGenerator::begin(std::function<void()> func) {
+  endHandler = func;
+  beginAt = getTick();
+
+  while (outstanding < param.queueDepth && canIssue()) {
+    issue();
+  }
+
+  checkEnd();
+}
+
+std::string RequestGenerator::getName() {
+  return param.name;
+}
+
+bool RequestGenerator::isFinished() {
+  return reachEnd;
+}
+
+IOStatistics &RequestGenerator::getStatistics() {
+  return stat;
+}
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __IGL_REQUEST_GENERATOR__
+#define __IGL_REQUEST_GENERATOR__
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "igl/block_io.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+typedef enum {
+  DIST_UNIFORM,   //!< Uniform random
+  DIST_ZIPF,      //!< Zipfian, parameter is exponent
+  DIST_HOTCOLD,   //!< Hot/cold, parameters are hot space and access ratio
+} DISTRIBUTION;
+
+/**
+ * \brief Job description
+ *
+ * Key names follow fio where possible:
+ *   rw                   read, write, trim, randread, randwrite, randtrim,
+ *                        rw (readwrite), randrw
+ *   rwmixread            Percentage of reads in mixed workload
+ *   bs                   Block size (k, m, g suffix)
+ *   bssplit              Block size distribution, ex) 4k/70:64k/30
+ *   offset, size         I/O region in byte or in % of capacity
+ *   iodepth              Number of outstanding requests of this job
+ *   number_ios, io_size  Stop after given number of requests / bytes
+ *   runtime              Stop after given simulated time (us, ms, s suffix)
+ *   random_distribution  random, zipf:<theta>, hotcold:<space>:<access>
+ *   randseed             Seed of random generator
+ * Settings in [global] section apply to following jobs.
+ */
+typedef struct _JobParam {
+  std::string name;
+
+  bool random;
+  uint32_t readRatio;  //!< Percentage
+  bool trim;
+
+  std::vector<std::pair<uint64_t, uint32_t>> blockSize;  //!< Size, weight
+
+  uint64_t offset;
+  uint64_t size;
+  double offsetRatio;  //!< Used when offset is given in percentage
+  double sizeRatio;    //!< Used when size is given in percentage
+
+  uint32_t queueDepth;
+  uint64_t ioCount;
+  uint64_t ioSize;
+  uint64_t runtime;  //!< In pico-second
+
+  DISTRIBUTION distribution;
+  double distParam[2];
+
+  uint64_t seed;
+
+  _JobParam();
+} JobParam;
+
+bool loadJobFile(std::string, std::vector<JobParam> &);
+
+/**
+ * \brief Zipfian integer sampler
+ *
+ * Rejection-inversion sampling (W. Hormann and G. Derflinger, 1996), so it
+ * needs neither table nor normalization constant over whole range.
+ */
+class ZipfSampler {
+ private:
+  uint64_t n;
+  double exponent;
+  double hIntegralX1;
+  double hIntegralN;
+  double s;
+
+  double h(double);
+  double hIntegral(double);
+  double hIntegralInverse(double);
+
+ public:
+  ZipfSampler(uint64_t, double);
+
+  uint64_t sample(std::mt19937_64 &);  //!< Returns 1 ~ n
+};
+
+/**
+ * \brief Synthetic workload generator
+ *
+ * Keeps queueDepth requests of one job in flight on BlockIO (closed loop).
+ */
+class RequestGenerator {
+ private:
+  typedef struct {
+    IO_TYPE type;
+    uint64_t length;
+    uint64_t issuedAt;
+  } IORecord;
+
+  BlockIO &io;
+  JobParam param;
+
+  std::mt19937_64 rng;
+  std::uniform_real_distribution<double> realDist;
+  ZipfSampler *zipf;
+
+  uint64_t granularity;  //!< Alignment of random offset
+  uint64_t units;        //!< Number of aligned units in region
+  uint64_t multiplier;   //!< Scatters zipf rank over region
+  uint64_t blockSizeWeight;
+  uint64_t cursor;
+
+  uint64_t beginAt;
+  uint64_t issuedCount;
+  uint64_t issuedBytes;
+  uint64_t outstanding;
+  bool reachEnd;
+
+  DMAFunction completion;
+  std::function<void()> endHandler;
+
+  IOStatistics stat;
+
+  bool canIssue();
+  uint64_t nextBlockSize();
+  uint64_t nextOffset(uint64_t);
+  void issue();
+  void checkEnd();
+
+ public:
+  RequestGenerator(BlockIO &, JobParam &);
+  ~RequestGenerator();
+
+  void begin(std::function<void()>);
+
+  std::string getName();
+  bool isFinished();
+  IOStatistics &getStatistics();
+};
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "igl/stat_sampler.hh"
+
+#include <cstring>
+
+#include "sim/trace.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+template <class T>
+inline void writeValue(std::ostream &out, T value) {
+  out.write((const char *)&value, sizeof(T));
+}
+
+template <class T>
+inline bool readValue(std::istream &in, T &value) {
+  return (bool)in.read((char *)&value, sizeof(T));
+}
+
+void writeCSVHeader(std::ostream &out, std::vector<std::string> &names) {
+  out << "tick";
+
+  for (auto &iter : names) {
+    out << "," << iter;
+  }
+
+  for (auto &iter : names) {
+    out << "," << iter << ".delta";
+  }
+
+  out << std::endl;
+}
+
+void writeCSVRow(std::ostream &out, uint64_t tick, const double *data,
+                 uint64_t count) {
+  out << tick;
+
+  for (uint64_t i = 0; i < count; i++) {
+    out << "," << data[i];
+  }
+
+  out << "\n";
+}
+
+StatSampler::StatSampler(BlockIO &b, std::ostream &o, bool bin, uint64_t i)
+    : io(b), out(o), binary(bin), interval(i), lastSampleAt(0) {
+  if (interval == 0) {
+    panic("Sampling interval should be larger than zero");
+  }
+
+  sampleEvent = allocate([this](uint64_t tick) {
+    sample(tick);
+
+    schedule(sampleEvent, tick + interval);
+  });
+
+  io.getStatList(list, "");
+}
+
+StatSampler::~StatSampler() {
+  deallocate(sampleEvent);
+}
+
+void StatSampler::writeHeader() {
+  if (binary) {
+    out.write(STAT_SERIES_MAGIC, sizeof(STAT_SERIES_MAGIC));
+    writeValue(out, interval);
+    writeValue(out, (uint32_t)list.size());
+
+    for (auto &iter : list) {
+      writeValue(out, (uint16_t)iter.name.length());
+      out.write(iter.name.data(), iter.name.length());
+    }
+  }
+  else {
+    std::vector<std::string> names;
+
+    for (auto &iter : list) {
+      names.push_back(iter.name);
+    }
+
+    // Byte and tick counters need more digits than default
+    out.precision(15);
+
+    writeCSVHeader(out, names);
+  }
+}
+
+void StatSampler::sample(uint64_t tick) {
+  uint64_t count = last.size();
+
+  // Values first, then delta of each value appended in same buffer
+  values.clear();
+  io.getStatValues(values);
+
+  if (values.size() != count) {
+    panic("Number of statistics changed while sampling");
+  }
+
+  values.resize(count * 2);
+
+  for (uint64_t i = 0; i < count; i++) {
+    values[count + i] = values[i] - last[i];
+    last[i] = values[i];
+  }
+
+  if (binary) {
+    writeValue(out, tick);
+    out.write((const char *)values.data(), count * 2 * sizeof(double));
+  }
+  else {
+    writeCSVRow(out, tick, values.data(), count * 2);
+  }
+
+  lastSampleAt = tick;
+}
+
+void StatSampler::begin() {
+  writeHeader();
+
+  last.clear();
+  io.getStatValues(last);
+  values.reserve(last.size() * 2);
+
+  lastSampleAt = getTick();
+
+  schedule(sampleEvent, lastSampleAt + interval);
+}
+
+void StatSampler::end() {
+  uint64_t tick = getTick();
+
+  deschedule(sampleEvent);
+
+  if (tick > lastSampleAt) {
+    sample(tick);
+  }
+
+  out.flush();
+}
+
+//! Convert binary output of StatSampler to CSV
+bool decodeStatSeries(std::istream &in, std::ostream &out) {
+  char magic[sizeof(STAT_SERIES_MAGIC)];
+  std::vector<std::string> names;
+  std::vector<double> data;
+  uint64_t interval;
+  uint64_t tick;
+  uint32_t count;
+  uint16_t length;
+
+  in.read(magic, sizeof(magic));
+
+  if (!in.good() || memcmp(magic, STAT_SERIES_MAGIC, sizeof(magic)) != 0) {
+    return false;
+  }
+
+  if (!readValue(in, interval) || !readValue(in, count)) {
+    return false;
+  }
+
+  names.resize(count);
+
+  for (auto &iter : names) {
+    if (!readValue(in, length)) {
+      return false;
+    }
+
+    iter.resize(length);
+
+    if (!in.read(&iter[0], length)) {
+      return false;
+    }
+  }
+
+  data.resize(count * 2);
+  out.precision(15);
+
+  writeCSVHeader(out, names);
+
+  while (readValue(in, tick)) {
+    if (!in.read((char *)data.data(), data.size() * sizeof(double))) {
+      return false;
+    }
+
+    writeCSVRow(out, tick, data.data(), data.size());
+  }
+
+  // Partial sample means truncated file
+  return in.gcount() == 0;
+}
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
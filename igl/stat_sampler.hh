@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __IGL_STAT_SAMPLER__
+#define __IGL_STAT_SAMPLER__
+
+#include <iostream>
+
+#include "igl/block_io.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+/**
+ * \brief Periodic statistics sampler
+ *
+ * Collects all statistics of BlockIO (HIL, ICL, DRAM, FTL, PAL and CPU) at
+ * every interval of simulated time, and writes them as time series. Each
+ * sample has tick, values of all statistics, and delta of each value since
+ * previous sample (or since begin() for first one). Last sample written by
+ * end() may cover shorter interval.
+ *
+ * CSV output starts with header line of names, where delta columns have
+ * ".delta" suffix. Binary output starts with STAT_SERIES_MAGIC, interval,
+ * number of statistics and names (uint16_t length and characters), followed
+ * by samples of uint64_t tick, double values[count] and double
+ * deltas[count]. Convert binary output to CSV with decodeStatSeries.
+ */
+#define STAT_SERIES_MAGIC "SimpleSSD-sts1"
+
+class StatSampler {
+ private:
+  BlockIO &io;
+  std::ostream &out;
+  bool binary;
+  uint64_t interval;
+
+  Event sampleEvent;
+  uint64_t lastSampleAt;
+
+  std::vector<Stats> list;
+  std::vector<double> last;
+  std::vector<double> values;
+
+  void writeHeader();
+  void sample(uint64_t);
+
+ public:
+  StatSampler(BlockIO &, std::ostream &, bool, uint64_t);
+  ~StatSampler();
+
+  void begin();
+  void end();
+};
+
+bool decodeStatSeries(std::istream &, std::ostream &);
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
+
+#endif
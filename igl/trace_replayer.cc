@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "igl/trace_replayer.hh"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "util/algorithm.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+// Tick (pico-second) per timestamp unit of each trace format
+const uint64_t tickPerUnit[3] = {
+    1000,    //!< TRACE_BLKPARSE, stored in nano-second
+    100000,  //!< TRACE_MSR, Windows filetime in 100 nano-second
+    1000,    //!< TRACE_SPC, stored in nano-second
+};
+
+#define SECTOR_SIZE 512
+#define MAX_TOKENS 16
+
+// Split line in place, and return number of tokens
+static uint32_t tokenize(char *line, bool csv, char **tokens) {
+  uint32_t count = 0;
+  char *cur = line;
+
+  while (*cur && count < MAX_TOKENS) {
+    if (csv) {
+      tokens[count++] = cur;
+
+      while (*cur && *cur != ',') {
+        cur++;
+      }
+    }
+    else {
+      while (*cur && isspace(*cur)) {
+        cur++;
+      }
+
+      if (*cur == 0) {
+        break;
+      }
+
+      tokens[count++] = cur;
+
+      while (*cur && !isspace(*cur)) {
+        cur++;
+      }
+    }
+
+    if (*cur) {
+      *cur++ = 0;
+    }
+  }
+
+  return count;
+}
+
+static bool isNumber(const char *str) {
+  return isdigit(str[0]) || (str[0] == '.' && isdigit(str[1]));
+}
+
+ReplayParam::_ReplayParam()
+    : format(TRACE_BLKPARSE),
+      mode(ISSUE_OPEN_LOOP),
+      queueDepth(32),
+      timeScale(1.),
+      maxCount(0),
+      blkparseAction('D') {}
+
+TraceReplayer::TraceReplayer(BlockIO &b, ReplayParam &p, std::string path)
+    : io(b),
+      param(p),
+      reachEnd(false),
+      hasNext(false),
+      firstTimestamp(0),
+      baseTick(0),
+      readCount(0),
+      issueCount(0),
+      wrapCount(0) {
+  file.open(path);
+
+  if (!file.is_open()) {
+    panic("Failed to open trace file %s", path.c_str());
+  }
+
+  if (param.queueDepth == 0) {
+    panic("Queue depth should be larger than zero");
+  }
+
+  submitEvent = allocate([this](uint64_t tick) { submit(tick); });
+
+  completion = [this](uint64_t tick, void *context) {
+    auto pRecord = (Record *)context;
+
+    stat.add(pRecord->type, pRecord->length, pRecord->arrivedAt, tick);
+
+    delete pRecord;
+
+    if (pending.size() > 0) {
+      pRecord = pending.front();
+      pending.pop_front();
+
+      issue(pRecord);
+    }
+    else if (param.mode == ISSUE_CLOSED_LOOP && hasNext) {
+      pRecord = new Record(next);
+      pRecord->arrivedAt = tick;
+
+      readNext();
+      issue(pRecord);
+    }
+
+    checkEnd();
+  };
+}
+
+TraceReplayer::~TraceReplayer() {
+  for (auto &iter : pending) {
+    delete iter;
+  }
+
+  deallocate(submitEvent);
+}
+
+bool TraceReplayer::parseLine(std::string &line, Record &record) {
+  char *tokens[MAX_TOKENS];
+  uint32_t count;
+
+  switch (param.format) {
+    case TRACE_BLKPARSE: {
+      // 8,0  3  1  0.000000000  4079  Q  WS 223490 + 8 [process]
+      char *rwbs;
+
+      count = tokenize(&line[0], false, tokens);
+
+      if (count < 7 || !isNumber(tokens[3]) || tokens[5][1] != 0 ||
+          tokens[5][0] != param.blkparseAction) {
+        return false;
+      }
+
+      rwbs = tokens[6];
+
+      if (count >= 10 && strcmp(tokens[8], "+") == 0) {
+        record.offset = strtoull(tokens[7], nullptr, 10) * SECTOR_SIZE;
+        record.length = strtoull(tokens[9], nullptr, 10) * SECTOR_SIZE;
+      }
+      else {
+        record.offset = 0;
+        record.length = 0;
+      }
+
+      if (strchr(rwbs, 'D')) {
+        record.type = IO_TRIM;
+      }
+      else if (strchr(rwbs, 'R') && record.length > 0) {
+        record.type = IO_READ;
+      }
+      else if (strchr(rwbs, 'W') && record.length > 0) {
+        record.type = IO_WRITE;
+      }
+      else if (strchr(rwbs, 'F')) {
+        record.type = IO_FLUSH;
+      }
+      else {
+        return false;
+      }
+
+      record.timestamp = (uint64_t)(strtod(tokens[3], nullptr) * 1e9 + 0.5);
+    } break;
+    case TRACE_MSR:
+      // Timestamp,Hostname,DiskNumber,Type,Offset,Size,ResponseTime
+      count = tokenize(&line[0], true, tokens);
+
+      if (count < 6 || !isNumber(tokens[0])) {
+        return false;
+      }
+
+      if (tolower(tokens[3][0]) == 'r') {
+        record.type = IO_READ;
+      }
+      else if (tolower(tokens[3][0]) == 'w') {
+        record.type = IO_WRITE;
+      }
+      else {
+        return false;
+      }
+
+      record.timestamp = strtoull(tokens[0], nullptr, 10);
+      record.offset = strtoull(tokens[4], nullptr, 10);
+      record.length = strtoull(tokens[5], nullptr, 10);
+
+      break;
+    case TRACE_SPC:
+      // ASU,LBA,Size,Opcode,Timestamp
+      count = tokenize(&line[0], true, tokens);
+
+      if (count < 5 || !isNumber(tokens[0])) {
+        return false;
+      }
+
+      if (tolower(tokens[3][0]) == 'r') {
+        record.type = IO_READ;
+      }
+      else if (tolower(tokens[3][0]) == 'w') {
+        record.type = IO_WRITE;
+      }
+      else {
+        return false;
+      }
+
+      record.offset = strtoull(tokens[1], nullptr, 10) * SECTOR_SIZE;
+      record.length = strtoull(tokens[2], nullptr, 10);
+      record.timestamp = (uint64_t)(strtod(tokens[4], nullptr) * 1e9 + 0.5);
+
+      break;
+    default:
+      panic("Invalid trace format %u", param.format);
+      break;
+  }
+
+  if (record.type != IO_FLUSH) {
+    uint64_t capacity = io.getCapacity();
+
+    if (record.length == 0) {
+      return false;
+    }
+
+    // Fold requests beyond capacity of simulated SSD
+    if (record.offset + record.length > capacity) {
+      wrapCount++;
+
+      record.length = MIN(record.length, capacity);
+      record.offset %= capacity;
+      record.offset -= record.offset % io.getLogicalPageSize();
+
+      if (record.offset + record.length > capacity) {
+        record.offset = capacity - record.length;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool TraceReplayer::readRecord(Record &record) {
+  std::string line;
+
+  while (std::getline(file, line)) {
+    if (parseLine(line, record)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void TraceReplayer::readNext() {
+  uint64_t arrivedAt = next.arrivedAt;
+
+  hasNext = false;
+
+  if (param.maxCount == 0 || readCount < param.maxCount) {
+    hasNext = readRecord(next);
+  }
+
+  if (hasNext) {
+    if (readCount++ == 0) {
+      firstTimestamp = next.timestamp;
+      arrivedAt = baseTick;
+    }
+
+    // Timestamps may not be strictly sorted
+    if (next.timestamp > firstTimestamp) {
+      next.arrivedAt = baseTick + (uint64_t)((next.timestamp - firstTimestamp) *
+                                             tickPerUnit[param.format] *
+                                             param.timeScale);
+    }
+    else {
+      next.arrivedAt = baseTick;
+    }
+
+    next.arrivedAt = MAX(next.arrivedAt, arrivedAt);
+  }
+}
+
+void TraceReplayer::issue(Record *pRecord) {
+  if (io.getOutstanding() >= param.queueDepth) {
+    pending.push_back(pRecord);
+
+    return;
+  }
+
+  issueCount++;
+
+  io.submit(pRecord->type, pRecord->offset, pRecord->length, completion,
+            pRecord);
+}
+
+void TraceReplayer::submit(uint64_t tick) {
+  while (hasNext && next.arrivedAt <= tick) {
+    issue(new Record(next));
+
+    readNext();
+  }
+
+  if (hasNext) {
+    schedule(submitEvent, next.arrivedAt);
+  }
+
+  checkEnd();
+}
+
+void TraceReplayer::checkEnd() {
+  if (!reachEnd && !hasNext && pending.size() == 0 &&
+      io.getOutstanding() == 0) {
+    reachEnd = true;
+
+    if (wrapCount > 0) {
+      warn("%" PRIu64 " requests were beyond SSD capacity and folded",
+           wrapCount);
+    }
+
+    if (endHandler) {
+      endHandler();
+    }
+  }
+}
+
+void TraceReplayer::begin(std::function<void()> func) {
+  endHandler = func;
+  baseTick = getTick();
+
+  next.arrivedAt = baseTick;
+
+  readNext();
+
+  if (param.mode == ISSUE_OPEN_LOOP) {
+    submit(baseTick);
+  }
+  else {
+    while (hasNext && io.getOutstanding() < param.queueDepth) {
+      Record *pRecord = new Record(next);
+
+      pRecord->arrivedAt = baseTick;
+
+      readNext();
+      issue(pRecord);
+    }
+
+    checkEnd();
+  }
+}
+
+IOStatistics &TraceReplayer::getStatistics() {
+  return stat;
+}
+
+uint64_t TraceReplayer::getIssuedCount() {
+  return issueCount;
+}
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
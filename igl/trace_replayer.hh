@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __IGL_TRACE_REPLAYER__
+#define __IGL_TRACE_REPLAYER__
+
+#include <deque>
+#include <fstream>
+
+#include "igl/block_io.hh"
+
+namespace SimpleSSD {
+
+namespace IGL {
+
+typedef enum {
+  TRACE_BLKPARSE,  //!< Default text output of blkparse
+  TRACE_MSR,       //!< MSR-Cambridge CSV
+  TRACE_SPC,       //!< SNIA/UMass SPC format
+} TRACE_FORMAT;
+
+typedef enum {
+  ISSUE_OPEN_LOOP,    //!< Issue at timestamp of trace
+  ISSUE_CLOSED_LOOP,  //!< Issue when previous request completes
+} ISSUE_MODE;
+
+typedef struct _ReplayParam {
+  TRACE_FORMAT format;
+  ISSUE_MODE mode;
+  uint32_t queueDepth;
+  double timeScale;    //!< Multiplier of inter-arrival time
+  uint64_t maxCount;   //!< 0 for whole trace
+  char blkparseAction;  //!< Action of blkparse to replay (Q, D, C, ...)
+
+  _ReplayParam();
+} ReplayParam;
+
+class TraceReplayer {
+ private:
+  typedef struct {
+    IO_TYPE type;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t timestamp;  //!< Trace timestamp in pico-second
+    uint64_t arrivedAt;
+  } Record;
+
+  BlockIO &io;
+  ReplayParam param;
+  std::ifstream file;
+
+  Event submitEvent;
+  DMAFunction completion;
+  std::function<void()> endHandler;
+
+  bool reachEnd;
+  bool hasNext;
+  Record next;
+  std::deque<Record *> pending;
+
+  uint64_t firstTimestamp;
+  uint64_t baseTick;
+  uint64_t readCount;
+  uint64_t issueCount;
+  uint64_t wrapCount;
+
+  IOStatistics stat;
+
+  bool parseLine(std::string &, Record &);
+  bool readRecord(Record &);
+  void readNext();
+  void issue(Record *);
+  void submit(uint64_t);
+  void checkEnd();
+
+ public:
+  TraceReplayer(BlockIO &, ReplayParam &, std::string);
+  ~TraceReplayer();
+
+  void begin(std::function<void()>);
+
+  IOStatistics &getStatistics();
+  uint64_t getIssuedCount();
+};
+
+}  // namespace IGL
+
+}  // namespace SimpleSSD
+
+#endif
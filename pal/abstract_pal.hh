@@ -28,7 +28,7 @@ namespace SimpleSSD {
 
 namespace PAL {
 
-class AbstractPAL : public StatObject {
+class AbstractPAL : public StatObject, public StateObject {
  protected:
   Parameter &param;
   ConfigReader &conf;
@@ -20,6 +20,7 @@
 #include "PAL2.h"
 
 #include "util/algorithm.hh"
+#include "util/memory.hh"
 
 PAL2::PAL2(PALStatistics *statistics, SimpleSSD::PAL::Parameter *p,
            SimpleSSD::ConfigReader *c, Latency *l)
@@ -557,6 +558,7 @@ void PAL2::TimelineScheduling(Command &req, CPDPBP &reqCPD) {
 #endif
 
     // 6) Write-back latency on RequestLL
+    req.started = tsDMA0.StartTick;
     req.finished = tsDMA1.EndTick;
 
     // categorize the time spent for read/write operation
@@ -961,3 +963,162 @@ void PAL2::AssemblePPN(CPDPBP *pCPDPBP, uint64_t *pPPN) {
   DPRINTF(PAL, "PAL    ==> 0x%llx (%llu)\n", *pPPN, *pPPN);  // Use DPRINTF here
 #endif
 }
+
+void PAL2::saveFreeSlot(
+    std::ostream &out,
+    std::map<uint64_t, std::map<uint64_t, uint64_t> *> &tgtFreeSlot) {
+  pushValue(out, (uint64_t)tgtFreeSlot.size());
+
+  for (auto &iter : tgtFreeSlot) {
+    pushValue(out, iter.first);
+    pushValue(out, (uint64_t)iter.second->size());
+
+    for (auto &slot : *iter.second) {
+      pushValue(out, slot.first);
+      pushValue(out, slot.second);
+    }
+  }
+}
+
+void PAL2::loadFreeSlot(
+    std::istream &in,
+    std::map<uint64_t, std::map<uint64_t, uint64_t> *> &tgtFreeSlot) {
+  uint64_t length;
+  uint64_t size;
+  uint64_t start;
+  uint64_t end;
+
+  // Slot lengths are fixed by NAND configuration, so only contents are loaded
+  checkValue(in, tgtFreeSlot.size(), "PAL2 free slot length count");
+
+  for (uint64_t i = 0; i < tgtFreeSlot.size(); i++) {
+    popValue(in, length);
+
+    auto iter = tgtFreeSlot.find(length);
+
+    if (iter == tgtFreeSlot.end()) {
+      SimpleSSD::panic("Checkpoint does not match NAND timing configuration");
+    }
+
+    iter->second->clear();
+    popValue(in, size);
+
+    for (uint64_t j = 0; j < size; j++) {
+      popValue(in, start);
+      popValue(in, end);
+
+      iter->second->emplace_hint(iter->second->end(), start, end);
+    }
+  }
+}
+
+// Host memory used by timeline (free slots and busy time slots)
+uint64_t PAL2::getMemoryUsage() {
+  uint64_t bytes = SimpleSSD::memoryUsage(MergedTimeSlots);
+  auto freeSlot =
+      [&bytes](std::map<uint64_t, std::map<uint64_t, uint64_t> *> &tgt) {
+        bytes += SimpleSSD::memoryUsage(tgt);
+
+        for (auto &iter : tgt) {
+          bytes += SimpleSSD::allocationSize(sizeof(*iter.second)) +
+                   SimpleSSD::memoryUsage(*iter.second);
+        }
+      };
+
+  for (int i = 0; i < 3; i++) {
+    bytes += SimpleSSD::memoryUsage(OpTimeStamp[i]);
+  }
+
+  for (uint32_t i = 0; i < pParam->channel; i++) {
+    freeSlot(ChFreeSlots[i]);
+  }
+
+  for (uint64_t i = 0; i < totalDie; i++) {
+    freeSlot(DieFreeSlots[i]);
+  }
+
+  bytes += SimpleSSD::allocationSize(pParam->channel * sizeof(*ChFreeSlots)) +
+           SimpleSSD::allocationSize(totalDie * sizeof(*DieFreeSlots));
+
+  return bytes;
+}
+
+void PAL2::saveState(std::ostream &out) {
+  pushTag(out, "PAL2");
+
+  pushValue(out, (uint64_t)pParam->channel);
+  pushValue(out, totalDie);
+
+  pushValue(out, (uint64_t)MergedTimeSlots.size());
+
+  for (auto &iter : MergedTimeSlots) {
+    pushValue(out, iter);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    pushValue(out, (uint64_t)OpTimeStamp[i].size());
+
+    for (auto &iter : OpTimeStamp[i]) {
+      pushValue(out, iter.first);
+      pushValue(out, iter.second);
+    }
+  }
+
+  for (uint32_t i = 0; i < pParam->channel; i++) {
+    saveFreeSlot(out, ChFreeSlots[i]);
+  }
+
+  out.write((const char *)ChStartPoint, pParam->channel * sizeof(uint64_t));
+
+  for (uint64_t i = 0; i < totalDie; i++) {
+    saveFreeSlot(out, DieFreeSlots[i]);
+  }
+
+  out.write((const char *)DieStartPoint, totalDie * sizeof(uint64_t));
+}
+
+void PAL2::loadState(std::istream &in) {
+  uint64_t size;
+  uint64_t key;
+  uint64_t value;
+  TimeSlot slot;
+
+  popTag(in, "PAL2");
+
+  checkValue(in, pParam->channel, "PAL2 channel count");
+  checkValue(in, totalDie, "PAL2 die count");
+
+  MergedTimeSlots.clear();
+  popValue(in, size);
+
+  for (uint64_t i = 0; i < size; i++) {
+    popValue(in, slot);
+    MergedTimeSlots.push_back(slot);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    OpTimeStamp[i].clear();
+    popValue(in, size);
+
+    for (uint64_t j = 0; j < size; j++) {
+      popValue(in, key);
+      popValue(in, value);
+
+      OpTimeStamp[i].emplace_hint(OpTimeStamp[i].end(), key, value);
+    }
+  }
+
+  for (uint32_t i = 0; i < pParam->channel; i++) {
+    loadFreeSlot(in, ChFreeSlots[i]);
+  }
+
+  in.read((char *)ChStartPoint, pParam->channel * sizeof(uint64_t));
+  checkStream(in);
+
+  for (uint64_t i = 0; i < totalDie; i++) {
+    loadFreeSlot(in, DieFreeSlots[i]);
+  }
+
+  in.read((char *)DieStartPoint, totalDie * sizeof(uint64_t));
+  checkStream(in);
+}
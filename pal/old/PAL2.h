@@ -25,6 +25,7 @@
 #include "Latency.h"
 #include "PALStatistics.h"
 #include "pal/pal.hh"
+#include "sim/state.hh"
 
 #include "PAL2_TimeSlot.h"
 
@@ -39,7 +40,7 @@ using namespace std;
 
 class PALStatistics;
 
-class PAL2  // let's not inherit PAL1
+class PAL2 : public SimpleSSD::StateObject  // let's not inherit PAL1
 {
  public:
   PAL2(PALStatistics *statistics, SimpleSSD::PAL::Parameter *p,
@@ -100,6 +101,19 @@ class PAL2  // let's not inherit PAL1
   void printCPDPBP(CPDPBP *pCPDPBP);
   void PPNdisassemble(uint64_t *pPPN, CPDPBP *pCPDPBP);
   void AssemblePPN(CPDPBP *pCPDPBP, uint64_t *pPPN);
+
+  uint64_t getMemoryUsage();
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
+
+ private:
+  void saveFreeSlot(
+      std::ostream &,
+      std::map<uint64_t, std::map<uint64_t, uint64_t> *> &tgtFreeSlot);
+  void loadFreeSlot(
+      std::istream &,
+      std::map<uint64_t, std::map<uint64_t, uint64_t> *> &tgtFreeSlot);
 };
 
 #endif
@@ -19,6 +19,7 @@
 
 #include "PALStatistics.h"
 #include "util/algorithm.hh"
+#include "util/memory.hh"
 #include "util/old/SimpleSSD_types.h"
 
 char ADDR_STRINFO[ADDR_NUM][10] = {"Channel", "Package", "Die",
@@ -235,10 +236,7 @@ void PALStatistics::getEraseBreakdown(Breakdown &value) {
 }
 
 void PALStatistics::getChannelActiveTime(uint32_t c, ActiveTime &stat) {
-  static uint32_t numOfChannel =
-      gconf->readUint(SimpleSSD::CONFIG_PAL, SimpleSSD::PAL::PAL_CHANNEL);
-
-  if (c < numOfChannel) {
+  if (c < totalChannel) {
     stat.min = Ticks_Active_ch[c].vals[OPER_NUM].minval;
     stat.max = Ticks_Active_ch[c].vals[OPER_NUM].maxval;
     stat.average = Ticks_Active_ch[c].vals[OPER_NUM].avg();
@@ -254,15 +252,13 @@ void PALStatistics::getDieActiveTime(uint32_t d, ActiveTime &stat) {
 }
 
 void PALStatistics::getChannelActiveTimeAll(ActiveTime &stat) {
-  static uint32_t numOfChannel =
-      gconf->readUint(SimpleSSD::CONFIG_PAL, SimpleSSD::PAL::PAL_CHANNEL);
   ActiveTime tmp;
 
   stat.min = (double)std::numeric_limits<uint64_t>::max();
   stat.max = 0.;
   stat.average = 0.;
 
-  for (uint32_t i = 0; i < numOfChannel; i++) {
+  for (uint32_t i = 0; i < totalChannel; i++) {
     getChannelActiveTime(i, tmp);
 
     if (stat.min > tmp.min) {
@@ -275,7 +271,7 @@ void PALStatistics::getChannelActiveTimeAll(ActiveTime &stat) {
     stat.average += tmp.average;
   }
 
-  stat.average /= numOfChannel;
+  stat.average /= totalChannel;
 }
 
 void PALStatistics::getDieActiveTimeAll(ActiveTime &stat) {
@@ -514,6 +510,8 @@ void PALStatistics::ValueOper::printstat_latency(const char *) {}
 
 PALStatistics::PALStatistics(SimpleSSD::ConfigReader *c, Latency *l)
     : gconf(c), lat(l) {
+  totalChannel =
+      gconf->readUint(SimpleSSD::CONFIG_PAL, SimpleSSD::PAL::PAL_CHANNEL);
   LastTick = 0;
 
   InitStats();
@@ -605,6 +603,154 @@ void PALStatistics::ClearStats() {
   }
 }
 
+void PALStatistics::saveSnapshot(std::ostream &out,
+                                 std::map<uint64_t, ValueOper *> &snapshot) {
+  pushValue(out, (uint64_t)snapshot.size());
+
+  for (auto &iter : snapshot) {
+    pushValue(out, iter.first);
+    pushValue(out, *iter.second);
+  }
+}
+
+void PALStatistics::loadSnapshot(std::istream &in,
+                                 std::map<uint64_t, ValueOper *> &snapshot) {
+  uint64_t size;
+  uint64_t tick;
+
+  for (auto &iter : snapshot) {
+    delete iter.second;
+  }
+
+  snapshot.clear();
+  popValue(in, size);
+
+  for (uint64_t i = 0; i < size; i++) {
+    ValueOper *value = new ValueOper();
+
+    popValue(in, tick);
+    popValue(in, *value);
+
+    snapshot.emplace(tick, value);
+  }
+}
+
+// Host memory used by periodic snapshots
+uint64_t PALStatistics::getMemoryUsage() {
+  return SimpleSSD::memoryUsage(Ticks_Total_snapshot) +
+         SimpleSSD::memoryUsage(Access_Capacity_snapshot) +
+         (Ticks_Total_snapshot.size() + Access_Capacity_snapshot.size()) *
+             SimpleSSD::allocationSize(sizeof(ValueOper));
+}
+
+void PALStatistics::saveState(std::ostream &out) {
+  pushTag(out, "PSTA");
+
+  pushValue(out, (uint64_t)totalChannel);
+  pushValue(out, totalDie);
+
+  pushValue(out, sim_start_time_ps);
+  pushValue(out, LastTick);
+  pushValue(out, ExactBusyTime);
+  pushValue(out, SampledExactBusyTime);
+  pushValue(out, OpBusyTime);
+  pushValue(out, LastOpBusyTime);
+  pushValue(out, LastExactBusyTime);
+  pushValue(out, LastExecutionTime);
+
+  pushValue(out, PPN_requested_rwe);
+  pushValue(out, PPN_requested_pagetype);
+  out.write((const char *)PPN_requested_ch, totalChannel * sizeof(CounterOper));
+  out.write((const char *)PPN_requested_die, totalDie * sizeof(CounterOper));
+  pushValue(out, CF_DMA0_dma);
+  pushValue(out, CF_DMA0_mem);
+  pushValue(out, CF_DMA0_none);
+  pushValue(out, CF_DMA1_dma);
+  pushValue(out, CF_DMA1_none);
+
+  pushValue(out, Ticks_DMA0WAIT);
+  pushValue(out, Ticks_DMA0);
+  pushValue(out, Ticks_MEM);
+  pushValue(out, Ticks_DMA1WAIT);
+  pushValue(out, Ticks_DMA1);
+  pushValue(out, Ticks_Total);
+  pushValue(out, Energy_DMA0);
+  pushValue(out, Energy_MEM);
+  pushValue(out, Energy_DMA1);
+  pushValue(out, Energy_Total);
+  pushValue(out, Ticks_TotalOpti);
+  out.write((const char *)Ticks_Active_ch, totalChannel * sizeof(ValueOper));
+  out.write((const char *)Ticks_Active_die, totalDie * sizeof(ValueOper));
+  pushValue(out, Access_Capacity);
+  pushValue(out, Access_Bandwidth);
+  pushValue(out, Access_Bandwidth_widle);
+  pushValue(out, Access_Oper_Bandwidth);
+  pushValue(out, Access_Iops);
+  pushValue(out, Access_Iops_widle);
+  pushValue(out, Access_Oper_Iops);
+
+  saveSnapshot(out, Ticks_Total_snapshot);
+  saveSnapshot(out, Access_Capacity_snapshot);
+
+  pushValue(out, SampledTick);
+  pushValue(out, skip);
+}
+
+void PALStatistics::loadState(std::istream &in) {
+  popTag(in, "PSTA");
+
+  checkValue(in, totalChannel, "PAL channel count");
+  checkValue(in, totalDie, "PAL die count");
+
+  popValue(in, sim_start_time_ps);
+  popValue(in, LastTick);
+  popValue(in, ExactBusyTime);
+  popValue(in, SampledExactBusyTime);
+  popValue(in, OpBusyTime);
+  popValue(in, LastOpBusyTime);
+  popValue(in, LastExactBusyTime);
+  popValue(in, LastExecutionTime);
+
+  popValue(in, PPN_requested_rwe);
+  popValue(in, PPN_requested_pagetype);
+  in.read((char *)PPN_requested_ch, totalChannel * sizeof(CounterOper));
+  in.read((char *)PPN_requested_die, totalDie * sizeof(CounterOper));
+  checkStream(in);
+  popValue(in, CF_DMA0_dma);
+  popValue(in, CF_DMA0_mem);
+  popValue(in, CF_DMA0_none);
+  popValue(in, CF_DMA1_dma);
+  popValue(in, CF_DMA1_none);
+
+  popValue(in, Ticks_DMA0WAIT);
+  popValue(in, Ticks_DMA0);
+  popValue(in, Ticks_MEM);
+  popValue(in, Ticks_DMA1WAIT);
+  popValue(in, Ticks_DMA1);
+  popValue(in, Ticks_Total);
+  popValue(in, Energy_DMA0);
+  popValue(in, Energy_MEM);
+  popValue(in, Energy_DMA1);
+  popValue(in, Energy_Total);
+  popValue(in, Ticks_TotalOpti);
+  in.read((char *)Ticks_Active_ch, totalChannel * sizeof(ValueOper));
+  in.read((char *)Ticks_Active_die, totalDie * sizeof(ValueOper));
+  checkStream(in);
+  popValue(in, Access_Capacity);
+  popValue(in, Access_Bandwidth);
+  popValue(in, Access_Bandwidth_widle);
+  popValue(in, Access_Oper_Bandwidth);
+  popValue(in, Access_Iops);
+  popValue(in, Access_Iops_widle);
+  popValue(in, Access_Oper_Iops);
+
+  loadSnapshot(in, Ticks_Total_snapshot);
+  loadSnapshot(in, Access_Capacity_snapshot);
+
+  popValue(in, SampledTick);
+  popValue(in, skip);
+}
+
 void PALStatistics::UpdateLastTick(uint64_t tick) {
   if (LastTick < tick)
     LastTick = tick;
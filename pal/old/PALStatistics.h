@@ -27,6 +27,7 @@
 
 #include "sim/config_reader.hh"
 #include "sim/simulator.hh"
+#include "sim/state.hh"
 
 #include <cassert>
 #include <cstdio>
@@ -46,6 +47,7 @@ using namespace std;
 // From ftl_command.hh
 typedef struct _Command {
   Tick arrived;
+  Tick started;  // First DMA began, after waiting channel and die
   Tick finished;
   Addr ppn;
   PAL_OPERATION operation;
@@ -54,6 +56,7 @@ typedef struct _Command {
 
   _Command()
       : arrived(0),
+        started(0),
         finished(0),
         ppn(0),
         operation(OPER_NUM),
@@ -61,6 +64,7 @@ typedef struct _Command {
         size(0) {}
   _Command(Tick t, Addr a, PAL_OPERATION op, uint64_t s)
       : arrived(t),
+        started(0),
         finished(0),
         ppn(a),
         operation(op),
@@ -80,7 +84,7 @@ typedef struct _Command {
 // From ftl_defs.hh
 #define EPOCH_INTERVAL 100000000000
 
-class PALStatistics {
+class PALStatistics : public SimpleSSD::StateObject {
  public:
   enum {
     /*
@@ -103,6 +107,7 @@ class PALStatistics {
 
   SimpleSSD::ConfigReader *gconf;
   Latency *lat;
+  uint32_t totalChannel;
   uint64_t totalDie;
 
 #if 0  // ch-die io count (legacy)
@@ -321,9 +326,17 @@ class PALStatistics {
   void PrintDieIdleTicks(uint32_t die_num, uint64_t sim_time_ps,
                          uint64_t idle_power_nw);
 
+  uint64_t getMemoryUsage();
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
+
  private:
   void ClearStats();
   void InitStats();
+
+  void saveSnapshot(std::ostream &, std::map<uint64_t, ValueOper *> &);
+  void loadSnapshot(std::istream &, std::map<uint64_t, ValueOper *> &);
 };
 
 #endif  //__PALStatistics_h__
@@ -149,6 +149,18 @@ void PAL::resetStatValues() {
   pPAL->resetStatValues();
 }
 
+void PAL::getMemoryUsage(std::vector<MemoryUsage> &list, std::string prefix) {
+  pPAL->getMemoryUsage(list, prefix + "pal.");
+}
+
+void PAL::saveState(std::ostream &out) {
+  pPAL->saveState(out);
+}
+
+void PAL::loadState(std::istream &in) {
+  pPAL->loadState(in);
+}
+
 }  // namespace PAL
 
 }  // namespace SimpleSSD
@@ -42,7 +42,7 @@ typedef struct {
   uint32_t pageInSuperPage;  //!< # pages in one superpage
 } Parameter;
 
-class PAL : public StatObject {
+class PAL : public StatObject, public StateObject {
  private:
   Parameter param;
   AbstractPAL *pPAL;
@@ -63,6 +63,10 @@ class PAL : public StatObject {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 };
 
 }  // namespace PAL
@@ -27,6 +27,8 @@
 #include "pal/old/LatencyTLC.h"
 #include "pal/old/PAL2.h"
 #include "pal/old/PALStatistics.h"
+#include "sim/profile.hh"
+#include "sim/request_trace.hh"
 #include "util/algorithm.hh"
 
 #define FLUSH_PERIOD 100000000000ull  // 0.1sec
@@ -43,6 +45,11 @@ PALOLD::PALOLD(Parameter &p, ConfigReader &c)
 
   memset(&stat, 0, sizeof(stat));
 
+  pageAllocation = conf.getPageAllocationConfig();
+  superblock = conf.getSuperblockConfig();
+  useMultiplaneOP = conf.readBoolean(CONFIG_PAL, NAND_USE_MULTI_PLANE_OP);
+  bRandomTweak = conf.readBoolean(CONFIG_FTL, FTL::FTL_USE_RANDOM_IO_TWEAK);
+
   switch (conf.readInt(CONFIG_PAL, NAND_FLASH_TYPE)) {
     case NAND_SLC:
       lat = new LatencySLC(*pTiming, *pPower);
@@ -78,6 +85,8 @@ PALOLD::PALOLD(Parameter &p, ConfigReader &c)
 
   // We will periodically flush timeslot for saving memory
   flushFunction = [this](uint64_t tick) {
+    ProfileScope scope(PROFILE_PAL);
+
     pal->FlushFreeSlots(tick - FLUSH_RANGE);
     pal->FlushTimeSlots(tick - FLUSH_RANGE);
 
@@ -88,12 +97,16 @@ PALOLD::PALOLD(Parameter &p, ConfigReader &c)
 }
 
 PALOLD::~PALOLD() {
+  deallocate(flushEvent);
+
   delete pal;
   delete stats;
   delete lat;
 }
 
 void PALOLD::read(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_PAL);
+
   uint64_t finishedAt = tick;
   ::Command cmd(tick, 0, OPER_READ, param.superPageSize);
   std::vector<::CPDPBP> list;
@@ -108,6 +121,9 @@ void PALOLD::read(Request &req, uint64_t &tick) {
     pal->submit(cmd, iter);
     stat.readCount++;
 
+    traceSpan(TRACE_PAL_WAIT, req.reqSubID, cmd.arrived, cmd.started);
+    traceSpan(TRACE_PAL_READ, req.reqSubID, cmd.started, cmd.finished);
+
     finishedAt = MAX(finishedAt, cmd.finished);
   }
 
@@ -115,6 +131,8 @@ void PALOLD::read(Request &req, uint64_t &tick) {
 }
 
 void PALOLD::write(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_PAL);
+
   uint64_t finishedAt = tick;
   ::Command cmd(tick, 0, OPER_WRITE, param.superPageSize);
   std::vector<::CPDPBP> list;
@@ -129,6 +147,9 @@ void PALOLD::write(Request &req, uint64_t &tick) {
     pal->submit(cmd, iter);
     stat.writeCount++;
 
+    traceSpan(TRACE_PAL_WAIT, req.reqSubID, cmd.arrived, cmd.started);
+    traceSpan(TRACE_PAL_WRITE, req.reqSubID, cmd.started, cmd.finished);
+
     finishedAt = MAX(finishedAt, cmd.finished);
   }
 
@@ -136,6 +157,8 @@ void PALOLD::write(Request &req, uint64_t &tick) {
 }
 
 void PALOLD::erase(Request &req, uint64_t &tick) {
+  ProfileScope scope(PROFILE_PAL);
+
   uint64_t finishedAt = tick;
   ::Command cmd(tick, 0, OPER_ERASE, param.superPageSize * param.page);
   std::vector<::CPDPBP> list;
@@ -150,6 +173,9 @@ void PALOLD::erase(Request &req, uint64_t &tick) {
     pal->submit(cmd, iter);
     stat.eraseCount++;
 
+    traceSpan(TRACE_PAL_WAIT, req.reqSubID, cmd.arrived, cmd.started);
+    traceSpan(TRACE_PAL_ERASE, req.reqSubID, cmd.started, cmd.finished);
+
     finishedAt = MAX(finishedAt, cmd.finished);
   }
 
@@ -158,24 +184,17 @@ void PALOLD::erase(Request &req, uint64_t &tick) {
 
 void PALOLD::convertCPDPBP(Request &req, std::vector<::CPDPBP> &list) {
   ::CPDPBP addr;
-  static uint32_t pageAllocation = conf.getPageAllocationConfig();
-  static uint8_t superblock = conf.getSuperblockConfig();
-  static bool useMultiplaneOP =
-      conf.readBoolean(CONFIG_PAL, NAND_USE_MULTI_PLANE_OP);
-  static uint32_t pageInSuperPage = param.pageInSuperPage;
-  static bool bRandomTweak =
-      conf.readBoolean(CONFIG_FTL, FTL::FTL_USE_RANDOM_IO_TWEAK);
   uint32_t value[4];
   uint32_t *ptr[4];
   uint64_t tmp = req.blockIndex;
   int count = 0;
 
-  if (bRandomTweak && req.ioFlag.size() != pageInSuperPage) {
+  if (bRandomTweak && req.ioFlag.size() != param.pageInSuperPage) {
     panic("Invalid size of I/O flag");
   }
 
-  if (!bRandomTweak && req.ioFlag.size() != pageInSuperPage) {
-    req.ioFlag = Bitset(pageInSuperPage);
+  if (!bRandomTweak && req.ioFlag.size() != param.pageInSuperPage) {
+    req.ioFlag = Bitset(param.pageInSuperPage);
     req.ioFlag.set();
   }
 
@@ -312,7 +331,7 @@ void PALOLD::convertCPDPBP(Request &req, std::vector<::CPDPBP> &list) {
     }
   }
 
-  if (tmp != pageInSuperPage) {
+  if (tmp != param.pageInSuperPage) {
     panic("I/O flag size != # pages in super page");
   }
 }
@@ -522,6 +541,52 @@ void PALOLD::resetStatValues() {
   memset(&stat, 0, sizeof(stat));
 }
 
+void PALOLD::getMemoryUsage(std::vector<MemoryUsage> &list,
+                            std::string prefix) {
+  MemoryUsage temp;
+
+  temp.name = prefix + "memory.timeline";
+  temp.desc = "Host memory used by channel and die timeline in byte";
+  temp.bytes = pal->getMemoryUsage();
+  list.push_back(temp);
+
+  temp.name = prefix + "memory.statistics";
+  temp.desc = "Host memory used by PAL statistics snapshot in byte";
+  temp.bytes = stats->getMemoryUsage();
+  list.push_back(temp);
+}
+
+void PALOLD::saveState(std::ostream &out) {
+  uint64_t flushAt = 0;
+
+  pushTag(out, "PALO");
+
+  scheduled(flushEvent, &flushAt);
+
+  pushValue(out, flushAt);
+  pushValue(out, lastResetTick);
+  pushValue(out, stat);
+
+  pal->saveState(out);
+  stats->saveState(out);
+}
+
+void PALOLD::loadState(std::istream &in) {
+  uint64_t flushAt;
+
+  popTag(in, "PALO");
+
+  popValue(in, flushAt);
+  popValue(in, lastResetTick);
+  popValue(in, stat);
+
+  pal->loadState(in);
+  stats->loadState(in);
+
+  // Keep flush period aligned with the run checkpoint was taken from
+  schedule(flushEvent, flushAt);
+}
+
 void PALOLD::read(::CPDPBP &addr, uint64_t &tick) {
   ::Command cmd(tick, 0, OPER_READ, param.superPageSize);
 
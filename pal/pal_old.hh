@@ -45,6 +45,11 @@ class PALOLD : public AbstractPAL {
 
   uint8_t lastResetTick;
 
+  uint32_t pageAllocation;
+  uint8_t superblock;
+  bool useMultiplaneOP;
+  bool bRandomTweak;
+
   struct {
     uint64_t readCount;
     uint64_t writeCount;
@@ -66,6 +71,10 @@ class PALOLD : public AbstractPAL {
   void getStatList(std::vector<Stats> &, std::string) override;
   void getStatValues(std::vector<double> &) override;
   void resetStatValues() override;
+  void getMemoryUsage(std::vector<MemoryUsage> &, std::string) override;
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
 
   // Direct interface for OCSSD
   void read(::CPDPBP &, uint64_t &);
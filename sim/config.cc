@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sim/config.hh"
+
+#include <cstdlib>
+
+namespace SimpleSSD {
+
+const char NAME_RANDOM_SEED[] = "RandomSeed";
+
+SimConfig::SimConfig() {
+  randomSeed = 0;
+}
+
+bool SimConfig::setConfig(const char *name, const char *value) {
+  bool ret = true;
+
+  if (MATCH_NAME(NAME_RANDOM_SEED)) {
+    randomSeed = strtoull(value, nullptr, 10);
+  }
+  else {
+    ret = false;
+  }
+
+  return ret;
+}
+
+uint64_t SimConfig::readUint(uint32_t idx) {
+  uint64_t ret = 0;
+
+  switch (idx) {
+    case SIM_RANDOM_SEED:
+      ret = randomSeed;
+      break;
+  }
+
+  return ret;
+}
+
+}  // namespace SimpleSSD
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __SIM_CONFIG__
+#define __SIM_CONFIG__
+
+#include "sim/base_config.hh"
+
+namespace SimpleSSD {
+
+typedef enum {
+  SIM_RANDOM_SEED,
+} SIM_CONFIG;
+
+/**
+ * \brief Simulation engine configuration
+ *
+ * Settings of simulation itself, not of the simulated SSD.
+ */
+class SimConfig : public BaseConfig {
+ private:
+  uint64_t randomSeed;  //!< Default: 0
+
+ public:
+  SimConfig();
+
+  bool setConfig(const char *, const char *) override;
+
+  uint64_t readUint(uint32_t) override;
+};
+
+}  // namespace SimpleSSD
+
+#endif
@@ -38,6 +38,7 @@ const char SECTION_ICL[] = "icl";
 const char SECTION_PAL[] = "pal";
 const char SECTION_SATA[] = "sata";
 const char SECTION_UFS[] = "ufs";
+const char SECTION_SIM[] = "sim";
 
 bool BaseConfig::convertBool(const char *value) {
   bool ret = false;
@@ -54,7 +55,33 @@ bool ConfigReader::init(std::string file) {
     return false;
   }
 
-  // Update all
+  update();
+
+  return true;
+}
+
+bool ConfigReader::init(std::string file,
+                        const std::vector<ConfigOverride> &list) {
+  if (ini_parse(file.c_str(), parserHandler, this) < 0) {
+    return false;
+  }
+
+  for (auto &iter : list) {
+    if (!setConfig(iter.section.c_str(), iter.name.c_str(),
+                   iter.value.c_str())) {
+      warn("Config override [%s] %s = %s not handled", iter.section.c_str(),
+           iter.name.c_str(), iter.value.c_str());
+
+      return false;
+    }
+  }
+
+  update();
+
+  return true;
+}
+
+void ConfigReader::update() {
   cpuConfig.update();
   dramConfig.update();
   ftlConfig.update();
@@ -63,8 +90,7 @@ bool ConfigReader::init(std::string file) {
   palConfig.update();
   sataConfig.update();
   ufsConfig.update();
-
-  return true;
+  simConfig.update();
 }
 
 int64_t ConfigReader::readInt(CONFIG_SECTION section, uint32_t idx) {
@@ -85,6 +111,8 @@ int64_t ConfigReader::readInt(CONFIG_SECTION section, uint32_t idx) {
       return iclConfig.readInt(idx);
     case CONFIG_PAL:
       return palConfig.readInt(idx);
+    case CONFIG_SIM:
+      return simConfig.readInt(idx);
     default:
       return 0;
   }
@@ -108,6 +136,8 @@ uint64_t ConfigReader::readUint(CONFIG_SECTION section, uint32_t idx) {
       return iclConfig.readUint(idx);
     case CONFIG_PAL:
       return palConfig.readUint(idx);
+    case CONFIG_SIM:
+      return simConfig.readUint(idx);
     default:
       return 0;
   }
@@ -131,6 +161,8 @@ float ConfigReader::readFloat(CONFIG_SECTION section, uint32_t idx) {
       return iclConfig.readFloat(idx);
     case CONFIG_PAL:
       return palConfig.readFloat(idx);
+    case CONFIG_SIM:
+      return simConfig.readFloat(idx);
     default:
       return 0.f;
   }
@@ -154,6 +186,8 @@ std::string ConfigReader::readString(CONFIG_SECTION section, uint32_t idx) {
       return iclConfig.readString(idx);
     case CONFIG_PAL:
       return palConfig.readString(idx);
+    case CONFIG_SIM:
+      return simConfig.readString(idx);
     default:
       return std::string();
   }
@@ -177,6 +211,8 @@ bool ConfigReader::readBoolean(CONFIG_SECTION section, uint32_t idx) {
       return iclConfig.readBoolean(idx);
     case CONFIG_PAL:
       return palConfig.readBoolean(idx);
+    case CONFIG_SIM:
+      return simConfig.readBoolean(idx);
     default:
       return false;
   }
@@ -185,38 +221,47 @@ bool ConfigReader::readBoolean(CONFIG_SECTION section, uint32_t idx) {
 int ConfigReader::parserHandler(void *context, const char *section,
                                 const char *name, const char *value) {
   ConfigReader *pThis = (ConfigReader *)context;
+
+  if (!pThis->setConfig(section, name, value)) {
+    warn("Config [%s] %s = %s not handled", section, name, value);
+  }
+
+  return 1;
+}
+
+bool ConfigReader::setConfig(const char *section, const char *name,
+                             const char *value) {
   bool handled = false;
 
   if (MATCH_SECTION(SECTION_CPU)) {
-    handled = pThis->cpuConfig.setConfig(name, value);
+    handled = cpuConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_DRAM)) {
-    handled = pThis->dramConfig.setConfig(name, value);
+    handled = dramConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_FTL)) {
-    handled = pThis->ftlConfig.setConfig(name, value);
+    handled = ftlConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_NVME)) {
-    handled = pThis->nvmeConfig.setConfig(name, value);
+    handled = nvmeConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_SATA)) {
-    handled = pThis->sataConfig.setConfig(name, value);
+    handled = sataConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_UFS)) {
-    handled = pThis->ufsConfig.setConfig(name, value);
+    handled = ufsConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_ICL)) {
-    handled = pThis->iclConfig.setConfig(name, value);
+    handled = iclConfig.setConfig(name, value);
   }
   else if (MATCH_SECTION(SECTION_PAL)) {
-    handled = pThis->palConfig.setConfig(name, value);
+    handled = palConfig.setConfig(name, value);
   }
-
-  if (!handled) {
-    warn("Config [%s] %s = %s not handled", section, name, value);
+  else if (MATCH_SECTION(SECTION_SIM)) {
+    handled = simConfig.setConfig(name, value);
   }
 
-  return 1;
+  return handled;
 }
 
 DRAM::Config::DRAMStructure *ConfigReader::getDRAMStructure() {
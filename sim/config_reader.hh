@@ -24,6 +24,7 @@
 
 #include <cinttypes>
 #include <string>
+#include <vector>
 
 #include "cpu/config.hh"
 #include "dram/config.hh"
@@ -34,6 +35,7 @@
 #include "icl/config.hh"
 #include "lib/inih/ini.h"
 #include "pal/config.hh"
+#include "sim/config.hh"
 
 namespace SimpleSSD {
 
@@ -46,8 +48,21 @@ typedef enum {
   CONFIG_UFS,
   CONFIG_ICL,
   CONFIG_PAL,
+  CONFIG_SIM,
 } CONFIG_SECTION;
 
+/**
+ * \brief Configuration override
+ *
+ * Applied after parsing configuration file, as if the value is written at
+ * the end of given section.
+ */
+typedef struct {
+  std::string section;  //!< Section name in lower case, ex) ftl
+  std::string name;     //!< Key name, ex) OverProvisioningRatio
+  std::string value;
+} ConfigOverride;
+
 class ConfigReader {
  private:
   CPU::Config cpuConfig;
@@ -58,11 +73,16 @@ class ConfigReader {
   HIL::UFS::Config ufsConfig;
   ICL::Config iclConfig;
   PAL::Config palConfig;
+  SimConfig simConfig;
 
   static int parserHandler(void *, const char *, const char *, const char *);
 
+  bool setConfig(const char *, const char *, const char *);
+  void update();
+
  public:
   bool init(std::string);
+  bool init(std::string, const std::vector<ConfigOverride> &);
 
   int64_t readInt(CONFIG_SECTION, uint32_t);
   uint64_t readUint(CONFIG_SECTION, uint32_t);
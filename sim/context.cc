@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sim/context.hh"
+
+namespace SimpleSSD {
+
+Context defaultContext;
+
+// Defined in sim/context.hh
+thread_local Context *currentContext = &defaultContext;
+
+Context::Context()
+    : sim(nullptr),
+      logger(nullptr),
+      cpu(nullptr),
+      tracer(nullptr),
+      profiler(nullptr),
+      logMask(0),
+      randomSeed(0) {}
+
+void setContext(Context *p) {
+  currentContext = p ? p : &defaultContext;
+}
+
+}  // namespace SimpleSSD
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __SIM_CONTEXT__
+#define __SIM_CONTEXT__
+
+#include <cinttypes>
+
+namespace SimpleSSD {
+
+class Simulator;
+struct Logger;
+class RequestTracer;
+class Profiler;
+
+namespace CPU {
+
+class CPU;
+
+}
+
+/**
+ * \brief Per-instance engine context
+ *
+ * Holds engine-wide state of one simulated SSD: simulator, log system,
+ * request tracer, profiler, CPU model and random seed. Free functions like
+ * getTick(), schedule(), execute() and debugprint() use context bound to
+ * calling thread by setContext().
+ *
+ * Threads not bound to any context share one default context, so single
+ * instance usage (gem5) does not need to know about this. To simulate
+ * multiple SSDs concurrently, create one Context per instance, and bind it
+ * before initSimpleSSDEngine() in the thread running that instance.
+ */
+class Context {
+ public:
+  Simulator *sim;
+  Logger *logger;
+  CPU::CPU *cpu;
+  RequestTracer *tracer;  //!< nullptr when request trace is disabled
+  Profiler *profiler;     //!< nullptr when host time profile is disabled
+
+  uint64_t logMask;     //!< Enabled LOG_IDs, zero when no debug output
+  uint64_t randomSeed;  //!< Seed of all RANDOM_STREAMs
+
+  Context();
+};
+
+// Defined in sim/context.cc
+extern thread_local Context *currentContext;
+
+inline Context *getContext() {
+  return currentContext;
+}
+
+void setContext(Context *);
+
+}  // namespace SimpleSSD
+
+#endif
@@ -19,10 +19,12 @@
 
 #include "sim/cpu.hh"
 
+#include "sim/context.hh"
+#include "sim/profile.hh"
+
 namespace SimpleSSD {
 
 // Defined in sim/cpu.hh
-CPU::CPU *cpu = nullptr;
 DMAFunction cpuHandler = commonCPUHandler;
 
 CPUContext::_CPUContext(DMAFunction &f, void *c) : func(f), context(c) {}
@@ -36,37 +38,49 @@ CPUContext::_CPUContext(DMAFunction &f, void *c, CPU::NAMESPACE n,
     : func(f), context(c), ns(n), fct(fc), delay(d) {}
 
 void initCPU(ConfigReader &conf) {
-  if (cpu) {
-    delete cpu;
+  Context *ctx = getContext();
+
+  if (ctx->cpu) {
+    delete ctx->cpu;
   }
 
-  cpu = new CPU::CPU(conf);
+  ctx->cpu = new CPU::CPU(conf);
 }
 
 void deInitCPU() {
-  delete cpu;
-  cpu = nullptr;
+  Context *ctx = getContext();
+
+  delete ctx->cpu;
+  ctx->cpu = nullptr;
 }
 
 void getCPUStatList(std::vector<Stats> &list, std::string prefix) {
+  CPU::CPU *cpu = getContext()->cpu;
+
   if (cpu) {
     cpu->getStatList(list, prefix);
   }
 }
 
 void getCPUStatValues(std::vector<double> &values) {
+  CPU::CPU *cpu = getContext()->cpu;
+
   if (cpu) {
     cpu->getStatValues(values);
   }
 }
 
 void resetCPUStatValues() {
+  CPU::CPU *cpu = getContext()->cpu;
+
   if (cpu) {
     cpu->resetStatValues();
   }
 }
 
 void printCPULastStat() {
+  CPU::CPU *cpu = getContext()->cpu;
+
   if (cpu) {
     cpu->printLastStat();
   }
@@ -74,6 +88,9 @@ void printCPULastStat() {
 
 void execute(CPU::NAMESPACE ns, CPU::FUNCTION fct, DMAFunction &func,
              void *context, uint64_t delay) {
+  ProfileScope scope(PROFILE_CPU);
+  CPU::CPU *cpu = getContext()->cpu;
+
   if (cpu) {
     cpu->execute(ns, fct, func, context, delay);
   }
@@ -89,6 +106,9 @@ void commonCPUHandler(uint64_t, void *context) {
 }
 
 uint64_t applyLatency(CPU::NAMESPACE ns, CPU::FUNCTION fct) {
+  ProfileScope scope(PROFILE_CPU);
+  CPU::CPU *cpu = getContext()->cpu;
+
   if (cpu) {
     return cpu->applyLatency(ns, fct);
   }
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sim/engine.hh"
+
+#include "sim/trace.hh"
+
+namespace SimpleSSD {
+
+// Heap arity. Four children share one or two cache lines
+#define HEAP_ARITY 4
+
+// Value of heapIndex when event is not scheduled
+#define NOT_SCHEDULED 0
+// Value of currentSlot when no event is running
+#define NO_SLOT 0xFFFFFFFF
+
+EventEngine::EventEngine()
+    : tick(0),
+      order(0),
+      eventCount(0),
+      currentSlot(NO_SLOT),
+      currentPending(false),
+      deallocCurrent(false),
+      stopRequested(false) {}
+
+EventEngine::~EventEngine() {}
+
+EventEngine::EventSlot &EventEngine::getSlot(Event eid, const char *op) {
+  if (eid == 0 || eid > slots.size() || !slots[eid - 1].allocated) {
+    panic("Tried to %s invalid event %" PRIu64, op, eid);
+  }
+
+  return slots[eid - 1];
+}
+
+void EventEngine::place(uint32_t index, HeapEntry &entry) {
+  heap[index] = entry;
+  heapIndex[entry.slot] = index + 1;
+}
+
+void EventEngine::siftUp(uint32_t index) {
+  HeapEntry entry = heap[index];
+
+  while (index > 0) {
+    uint32_t parent = (index - 1) / HEAP_ARITY;
+
+    if (!less(entry, heap[parent])) {
+      break;
+    }
+
+    place(index, heap[parent]);
+    index = parent;
+  }
+
+  place(index, entry);
+}
+
+void EventEngine::siftDown(uint32_t index) {
+  HeapEntry entry = heap[index];
+  uint32_t size = heap.size();
+
+  while (true) {
+    uint32_t first = index * HEAP_ARITY + 1;
+    uint32_t last = first + HEAP_ARITY;
+    uint32_t child = index;
+
+    if (first >= size) {
+      break;
+    }
+
+    if (last > size) {
+      last = size;
+    }
+
+    // Find smallest child
+    child = first;
+
+    for (uint32_t i = first + 1; i < last; i++) {
+      if (less(heap[i], heap[child])) {
+        child = i;
+      }
+    }
+
+    if (!less(heap[child], entry)) {
+      break;
+    }
+
+    place(index, heap[child]);
+    index = child;
+  }
+
+  place(index, entry);
+}
+
+void EventEngine::remove(uint32_t index) {
+  uint32_t last = heap.size() - 1;
+
+  heapIndex[heap[index].slot] = NOT_SCHEDULED;
+
+  if (index != last) {
+    heap[index] = heap[last];
+    heap.pop_back();
+
+    if (index > 0 && less(heap[index], heap[(index - 1) / HEAP_ARITY])) {
+      siftUp(index);
+    }
+    else {
+      siftDown(index);
+    }
+  }
+  else {
+    heap.pop_back();
+  }
+}
+
+void EventEngine::dispatch() {
+  HeapEntry entry = heap.front();
+  EventSlot &slot = slots[entry.slot];
+
+  tick = entry.tick;
+  eventCount++;
+
+  // Entry stays at heap root while handler runs. As it has the smallest key,
+  // nothing scheduled by handler can move it. If handler reschedules itself
+  // (common for periodic events), root is updated in place with single sift.
+  currentSlot = entry.slot;
+  currentPending = true;
+
+  slot.func(tick);
+
+  if (currentPending) {
+    remove(0);
+  }
+
+  currentSlot = NO_SLOT;
+  currentPending = false;
+
+  // Event deallocated itself inside its own handler
+  if (deallocCurrent) {
+    deallocCurrent = false;
+    slot.func = nullptr;
+    freeSlots.push_back(entry.slot);
+  }
+}
+
+uint64_t EventEngine::getCurrentTick() {
+  return tick;
+}
+
+Event EventEngine::allocateEvent(EventFunction func) {
+  uint32_t index;
+
+  if (freeSlots.size() > 0) {
+    index = freeSlots.back();
+    freeSlots.pop_back();
+  }
+  else {
+    index = slots.size();
+    slots.emplace_back();
+    heapIndex.push_back(NOT_SCHEDULED);
+  }
+
+  EventSlot &slot = slots[index];
+
+  slot.func = func;
+  heapIndex[index] = NOT_SCHEDULED;
+  slot.allocated = true;
+
+  return index + 1;
+}
+
+void EventEngine::scheduleEvent(Event eid, uint64_t when) {
+  getSlot(eid, "schedule");
+  HeapEntry entry;
+
+  // Same as gem5 wrapper, never go back in time
+  if (when < tick) {
+    when = tick;
+  }
+
+  entry.tick = when;
+  entry.order = order++;
+  entry.slot = eid - 1;
+
+  if (entry.slot == currentSlot && currentPending) {
+    // Running event schedules itself again
+    currentPending = false;
+    heap.front() = entry;
+
+    siftDown(0);
+  }
+  else if (heapIndex[entry.slot] != NOT_SCHEDULED) {
+    // Reschedule
+    uint32_t index = heapIndex[entry.slot] - 1;
+    bool earlier = less(entry, heap[index]);
+
+    heap[index] = entry;
+
+    if (earlier) {
+      siftUp(index);
+    }
+    else {
+      siftDown(index);
+    }
+  }
+  else {
+    heap.push_back(entry);
+    siftUp(heap.size() - 1);
+  }
+}
+
+void EventEngine::descheduleEvent(Event eid) {
+  getSlot(eid, "deschedule");
+
+  if (eid - 1 == currentSlot && currentPending) {
+    return;
+  }
+
+  if (heapIndex[eid - 1] != NOT_SCHEDULED) {
+    remove(heapIndex[eid - 1] - 1);
+  }
+}
+
+bool EventEngine::isScheduled(Event eid, uint64_t *when) {
+  getSlot(eid, "query");
+
+  if (eid - 1 == currentSlot && currentPending) {
+    return false;
+  }
+
+  if (heapIndex[eid - 1] != NOT_SCHEDULED) {
+    if (when) {
+      *when = heap[heapIndex[eid - 1] - 1].tick;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+void EventEngine::deallocateEvent(Event eid) {
+  EventSlot &slot = getSlot(eid, "deallocate");
+
+  if (heapIndex[eid - 1] != NOT_SCHEDULED) {
+    remove(heapIndex[eid - 1] - 1);
+  }
+
+  if (eid - 1 == currentSlot) {
+    currentPending = false;
+  }
+
+  slot.allocated = false;
+
+  if (eid - 1 == currentSlot) {
+    // Cannot destroy std::function while it is running
+    deallocCurrent = true;
+  }
+  else {
+    slot.func = nullptr;
+    freeSlots.push_back(eid - 1);
+  }
+}
+
+/**
+ * Process events until event queue is empty or stop() is called.
+ * Returns true if there are remaining events.
+ */
+bool EventEngine::run() {
+  stopRequested = false;
+
+  while (!stopRequested && heap.size() > 0) {
+    dispatch();
+  }
+
+  return heap.size() > 0;
+}
+
+/**
+ * Process events scheduled at or before given tick, and advance current tick
+ * to it. Periodic events (DRAM refresh, PAL flush) never leave the queue
+ * empty, so use this (or stop()) to end the simulation.
+ * Returns true if there are remaining events.
+ */
+bool EventEngine::runUntil(uint64_t until) {
+  stopRequested = false;
+
+  while (!stopRequested && heap.size() > 0 && heap.front().tick <= until) {
+    dispatch();
+  }
+
+  if (!stopRequested && tick < until) {
+    tick = until;
+  }
+
+  return heap.size() > 0;
+}
+
+void EventEngine::stop() {
+  stopRequested = true;
+}
+
+/**
+ * Jump to given tick without processing events, used when restoring
+ * checkpoint. Events scheduled before the tick are moved to it, keeping
+ * their schedule order.
+ */
+void EventEngine::setCurrentTick(uint64_t now) {
+  if (now < tick) {
+    panic("Cannot move current tick backward");
+  }
+
+  tick = now;
+
+  for (auto &iter : heap) {
+    if (iter.tick < now) {
+      iter.tick = now;
+    }
+  }
+
+  // Rebuild heap, as clamped entries are now ordered by schedule order
+  for (uint32_t i = heap.size() / HEAP_ARITY + 1; i-- > 0;) {
+    if (i < heap.size()) {
+      siftDown(i);
+    }
+  }
+}
+
+uint64_t EventEngine::getEventCount() {
+  return eventCount;
+}
+
+uint64_t EventEngine::getPendingEventCount() {
+  return heap.size();
+}
+
+}  // namespace SimpleSSD
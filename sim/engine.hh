@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __SIM_ENGINE__
+#define __SIM_ENGINE__
+
+#include <deque>
+#include <vector>
+
+#include "sim/simulator.hh"
+
+namespace SimpleSSD {
+
+/**
+ * \brief Native event engine
+ *
+ * Standalone implementation of Simulator interface, so SimpleSSD can run
+ * without full-system simulator. Event functions are stored once in pooled
+ * slots at allocateEvent, and (re)scheduling only touches 4-ary min-heap of
+ * (tick, order, slot) entries. Events at same tick are processed in schedule
+ * order.
+ */
+class EventEngine : public Simulator {
+ private:
+  struct EventSlot {
+    EventFunction func;
+    bool allocated;
+
+    EventSlot() : allocated(false) {}
+  };
+
+  struct HeapEntry {
+    uint64_t tick;
+    uint64_t order;
+    uint32_t slot;
+  };
+
+  // std::deque keeps references valid while callback allocates new events
+  std::deque<EventSlot> slots;
+  std::vector<uint32_t> heapIndex;  // Position in heap of each slot, plus one
+  std::vector<uint32_t> freeSlots;
+  std::vector<HeapEntry> heap;
+
+  uint64_t tick;
+  uint64_t order;
+  uint64_t eventCount;
+  uint32_t currentSlot;
+  bool currentPending;
+  bool deallocCurrent;
+  bool stopRequested;
+
+  EventSlot &getSlot(Event, const char *);
+
+  inline bool less(const HeapEntry &a, const HeapEntry &b) {
+    return a.tick < b.tick || (a.tick == b.tick && a.order < b.order);
+  }
+
+  void place(uint32_t, HeapEntry &);
+  void siftUp(uint32_t);
+  void siftDown(uint32_t);
+  void remove(uint32_t);
+
+  void dispatch();
+
+ public:
+  EventEngine();
+  ~EventEngine();
+
+  uint64_t getCurrentTick() override;
+
+  Event allocateEvent(EventFunction) override;
+  void scheduleEvent(Event, uint64_t) override;
+  void descheduleEvent(Event) override;
+  bool isScheduled(Event, uint64_t * = nullptr) override;
+  void deallocateEvent(Event) override;
+
+  bool run();
+  bool runUntil(uint64_t);
+  void stop();
+  void setCurrentTick(uint64_t);
+
+  uint64_t getEventCount();
+  uint64_t getPendingEventCount();
+};
+
+}  // namespace SimpleSSD
+
+#endif
@@ -22,40 +22,405 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "sim/context.hh"
+#include "sim/request_trace.hh"
+#include "util/algorithm.hh"
 #include "util/simplessd.hh"
 
+// Functions below are called through debugprint macro in sim/trace.hh
+#undef debugprint
+
 namespace SimpleSSD {
 
+typedef enum : uint8_t {
+  ARG_INT,
+  ARG_LONG,
+  ARG_LONG_LONG,
+  ARG_INTMAX,
+  ARG_SIZE,
+  ARG_PTRDIFF,
+  ARG_DOUBLE,
+  ARG_LONG_DOUBLE,
+  ARG_STRING,
+  ARG_POINTER,
+} ARG_TYPE;
+
+typedef struct {
+  ARG_TYPE type;
+  uint8_t bits;  //!< Truncate integer to this width (hh, h), 0 if not
+  bool isSigned;
+} Argument;
+
+//! One conversion specification of printf format, without '%'
+typedef struct {
+  std::string flags;
+  std::string width;      //!< Digits or *
+  std::string precision;  //!< Empty, or . followed by digits or *
+  std::string length;
+  char conversion;
+} Conversion;
+
+typedef struct {
+  uint32_t id;
+  std::vector<Argument> args;
+} Format;
+
+class BinarySink {
+ private:
+  std::ostream *out;
+  std::vector<uint8_t> buffer;
+  uint64_t used;
+
+  std::unordered_map<const char *, Format> formats;
+
+  void append(const void *, uint64_t);
+  template <class T>
+  void append(T value) {
+    append(&value, sizeof(T));
+  }
+
+  Format &getFormat(LOG_ID, const char *);
+
+ public:
+  BinarySink(std::ostream *, uint64_t);
+  ~BinarySink();
+
+  void print(LOG_ID, const char *, va_list);
+  void flush();
+};
+
 struct Logger {
   std::ostream *outfile;
   std::ostream *errfile;
 
-  Logger(std::ostream *o, std::ostream *e) : outfile(o), errfile(e) {}
+  BinarySink *sink;
+  uint64_t mask;
+
+  Logger(std::ostream *o, std::ostream *e)
+      : outfile(o), errfile(e), sink(nullptr), mask(~0ull) {}
+  ~Logger() { delete sink; }
+};
+
+const std::string logName[LOG_NUM] = {
+    "global",             //!< LOG_COMMON
+    "CPU",                //!< LOG_CPU
+    "HIL",                //!< LOG_HIL
+    "HIL::NVMe",          //!< LOG_HIL_NVME
+    "HIL::SATA",          //!< LOG_HIL_SATA
+    "HIL::UFS",           //!< LOG_HIL_UFS
+    "ICL",                //!< LOG_ICL
+    "ICL::GenericCache",  //!< LOG_ICL_GENERIC_CACHE
+    "FTL",                //!< LOG_FTL
+    "FTL::PageMapping",   //!< LOG_FTL_PAGE_MAPPING
+    "FTL::FastMapping",   //!< LOG_FTL_FAST_MAPPING
+    "PAL",                //!< LOG_PAL
+    "PAL::PALOLD",        //!< LOG_PAL_OLD
 };
 
-Logger *logger = nullptr;
+// Parse conversion specification after '%', returns pointer after it
+const char *parseConversion(const char *str, Conversion &conv) {
+  const char *begin;
+
+  begin = str;
+  while (*str && strchr("-+ #0", *str)) {
+    str++;
+  }
+  conv.flags.assign(begin, str);
+
+  begin = str;
+  if (*str == '*') {
+    str++;
+  }
+  else {
+    while (*str >= '0' && *str <= '9') {
+      str++;
+    }
+  }
+  conv.width.assign(begin, str);
+
+  begin = str;
+  if (*str == '.') {
+    str++;
+
+    if (*str == '*') {
+      str++;
+    }
+    else {
+      while (*str >= '0' && *str <= '9') {
+        str++;
+      }
+    }
+  }
+  conv.precision.assign(begin, str);
+
+  begin = str;
+  while (*str && strchr("hljztL", *str)) {
+    str++;
+  }
+  conv.length.assign(begin, str);
+
+  conv.conversion = *str;
+
+  if (*str) {
+    str++;
+  }
+
+  return str;
+}
+
+void getArguments(const char *format, std::vector<Argument> &list) {
+  Conversion conv;
+
+  while (*format) {
+    if (*format++ != '%') {
+      continue;
+    }
+
+    format = parseConversion(format, conv);
+
+    if (conv.width == "*") {
+      list.push_back({ARG_INT, 0, true});
+    }
+    if (conv.precision == ".*") {
+      list.push_back({ARG_INT, 0, true});
+    }
+
+    switch (conv.conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c': {
+        Argument arg = {ARG_INT, 0, false};
+
+        arg.isSigned = conv.conversion == 'd' || conv.conversion == 'i';
+
+        if (conv.length == "hh") {
+          arg.bits = 8;
+        }
+        else if (conv.length == "h") {
+          arg.bits = 16;
+        }
+        else if (conv.length == "l") {
+          arg.type = ARG_LONG;
+        }
+        else if (conv.length == "ll") {
+          arg.type = ARG_LONG_LONG;
+        }
+        else if (conv.length == "j") {
+          arg.type = ARG_INTMAX;
+        }
+        else if (conv.length == "z") {
+          arg.type = ARG_SIZE;
+        }
+        else if (conv.length == "t") {
+          arg.type = ARG_PTRDIFF;
+        }
+
+        list.push_back(arg);
+      } break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        list.push_back(
+            {conv.length == "L" ? ARG_LONG_DOUBLE : ARG_DOUBLE, 0, true});
+        break;
+      case 's':
+        list.push_back({ARG_STRING, 0, false});
+        break;
+      case 'p':
+      case 'n':
+        list.push_back({ARG_POINTER, 0, false});
+        break;
+    }
+  }
+}
+
+BinarySink::BinarySink(std::ostream *o, uint64_t size)
+    : out(o), buffer(size), used(0) {
+  append(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+}
+
+BinarySink::~BinarySink() {
+  flush();
+}
+
+void BinarySink::append(const void *data, uint64_t size) {
+  if (used + size > buffer.size()) {
+    flush();
+
+    if (size > buffer.size()) {
+      out->write((const char *)data, size);
+
+      return;
+    }
+  }
+
+  memcpy(buffer.data() + used, data, size);
+  used += size;
+}
+
+void BinarySink::flush() {
+  out->write((const char *)buffer.data(), used);
+  out->flush();
+
+  used = 0;
+}
+
+// Formats are identified by address of format string
+Format &BinarySink::getFormat(LOG_ID id, const char *format) {
+  auto iter = formats.find(format);
+
+  if (iter == formats.end()) {
+    uint16_t length = (uint16_t)MIN(strlen(format), UINT16_MAX);
+
+    iter = formats.emplace(format, Format()).first;
+    iter->second.id = (uint32_t)formats.size() - 1;
+    getArguments(format, iter->second.args);
+
+    append((uint8_t)BINARY_LOG_FORMAT);
+    append(iter->second.id);
+    append((uint8_t)id);
+    append(length);
+    append(format, length);
+  }
+
+  return iter->second;
+}
+
+void BinarySink::print(LOG_ID id, const char *format, va_list args) {
+  Format &fmt = getFormat(id, format);
+
+  append((uint8_t)BINARY_LOG_PRINT);
+  append(getTick());
+  append(fmt.id);
+
+  for (auto &arg : fmt.args) {
+    uint64_t value = 0;
+
+    switch (arg.type) {
+      case ARG_INT:
+        value = arg.isSigned ? (uint64_t)(int64_t)va_arg(args, int)
+                             : (uint64_t)va_arg(args, unsigned int);
+        break;
+      case ARG_LONG:
+        value = arg.isSigned ? (uint64_t)(int64_t)va_arg(args, long)
+                             : (uint64_t)va_arg(args, unsigned long);
+        break;
+      case ARG_LONG_LONG:
+        value = (uint64_t)va_arg(args, unsigned long long);
+        break;
+      case ARG_INTMAX:
+        value = (uint64_t)va_arg(args, uintmax_t);
+        break;
+      case ARG_SIZE:
+        value = (uint64_t)va_arg(args, size_t);
+        break;
+      case ARG_PTRDIFF:
+        value = (uint64_t)(int64_t)va_arg(args, ptrdiff_t);
+        break;
+      case ARG_DOUBLE:
+        append(va_arg(args, double));
+        continue;
+      case ARG_LONG_DOUBLE:
+        append((double)va_arg(args, long double));
+        continue;
+      case ARG_STRING: {
+        const char *str = va_arg(args, const char *);
+        uint16_t length = 0;
+
+        if (str) {
+          length = (uint16_t)MIN(strlen(str), UINT16_MAX);
+        }
+
+        append(length);
+        append(str, length);
+      }
+        continue;
+      case ARG_POINTER:
+        value = (uint64_t)(uintptr_t)va_arg(args, void *);
+        break;
+    }
+
+    if (arg.bits == 8) {
+      value = arg.isSigned ? (uint64_t)(int64_t)(int8_t)value
+                           : (uint64_t)(uint8_t)value;
+    }
+    else if (arg.bits == 16) {
+      value = arg.isSigned ? (uint64_t)(int64_t)(int16_t)value
+                           : (uint64_t)(uint16_t)value;
+    }
+
+    append(value);
+  }
+}
+
+// Format to string, without calling vsnprintf twice for short message
+std::string formatString(const char *format, va_list args) {
+  char buffer[256];
+  va_list copied;
+  int length;
+
+  va_copy(copied, args);
+  length = vsnprintf(buffer, sizeof(buffer), format, args);
+
+  if (length < 0) {
+    length = 0;
+  }
+
+  if ((size_t)length < sizeof(buffer)) {
+    va_end(copied);
+
+    return std::string(buffer, length);
+  }
+
+  std::vector<char> str(length + 1);
+
+  vsnprintf(str.data(), str.size(), format, copied);
+  va_end(copied);
+
+  return std::string(str.data(), length);
+}
 
 void panic(const char *format, ...) {
+  Logger *logger = getContext()->logger;
+
+  // Keep request trace written before panic
+  if (getContext()->tracer) {
+    getContext()->tracer->flush();
+  }
+
   if (logger) {
-    va_list args, copied;
-    std::vector<char> str;
+    va_list args;
+    std::string str;
 
     va_start(args, format);
-    va_copy(copied, args);
-    str.resize(vsnprintf(nullptr, 0, format, args) + 1);
+    str = formatString(format, args);
     va_end(args);
-    vsnprintf(str.data(), str.size(), format, copied);
-    va_end(copied);
+
+    // Keep debug log written before panic
+    if (logger->sink) {
+      logger->sink->flush();
+    }
 
     if (logger->errfile) {
-      *(logger->errfile) << getTick() << ": panic: " << str.data() << std::endl;
+      *(logger->errfile) << getTick() << ": panic: " << str << std::endl;
     }
     else {
-      std::cerr << getTick() << ": panic: " << str.data() << std::endl;
+      std::cerr << getTick() << ": panic: " << str << std::endl;
     }
   }
 
@@ -63,70 +428,63 @@ void panic(const char *format, ...) {
 }
 
 void warn(const char *format, ...) {
+  Logger *logger = getContext()->logger;
+
   if (logger && logger->errfile) {
-    va_list args, copied;
-    std::vector<char> str;
+    va_list args;
+    std::string str;
 
     va_start(args, format);
-    va_copy(copied, args);
-    str.resize(vsnprintf(nullptr, 0, format, args) + 1);
+    str = formatString(format, args);
     va_end(args);
-    vsnprintf(str.data(), str.size(), format, copied);
-    va_end(copied);
 
-    *(logger->errfile) << getTick() << ": warn: " << str.data() << std::endl;
+    *(logger->errfile) << getTick() << ": warn: " << str << std::endl;
   }
 }
 
 void info(const char *format, ...) {
+  Logger *logger = getContext()->logger;
+
   if (logger && logger->errfile) {
-    va_list args, copied;
-    std::vector<char> str;
+    va_list args;
+    std::string str;
 
     va_start(args, format);
-    va_copy(copied, args);
-    str.resize(vsnprintf(nullptr, 0, format, args) + 1);
+    str = formatString(format, args);
     va_end(args);
-    vsnprintf(str.data(), str.size(), format, copied);
-    va_end(copied);
 
-    *(logger->errfile) << getTick() << ": info: " << str.data() << std::endl;
+    *(logger->errfile) << getTick() << ": info: " << str << std::endl;
   }
 }
 
-const std::string logName[LOG_NUM] = {
-    "global",             //!< LOG_COMMON
-    "CPU",                //!< LOG_CPU
-    "HIL",                //!< LOG_HIL
-    "HIL::NVMe",          //!< LOG_HIL_NVME
-    "HIL::SATA",          //!< LOG_HIL_SATA
-    "HIL::UFS",           //!< LOG_HIL_UFS
-    "ICL",                //!< LOG_ICL
-    "ICL::GenericCache",  //!< LOG_ICL_GENERIC_CACHE
-    "FTL",                //!< LOG_FTL
-    "FTL::PageMapping",   //!< LOG_FTL_PAGE_MAPPING
-    "PAL",                //!< LOG_PAL
-    "PAL::PALOLD",        //!< LOG_PAL_OLD
-};
-
 void debugprint(LOG_ID id, const char *format, ...) {
-  if (logger && logger->outfile && id < LOG_NUM) {
-    va_list args, copied;
-    std::vector<char> str;
+  Logger *logger = getContext()->logger;
 
-    va_start(args, format);
-    va_copy(copied, args);
-    str.resize(vsnprintf(nullptr, 0, format, args) + 1);
-    va_end(args);
-    vsnprintf(str.data(), str.size(), format, copied);
-    va_end(copied);
+  if (logger && id < LOG_NUM) {
+    va_list args;
+
+    if (logger->sink) {
+      va_start(args, format);
+      logger->sink->print(id, format, args);
+      va_end(args);
+    }
+
+    if (logger->outfile) {
+      std::string str;
 
-    *(logger->outfile) << getTick() << ": " << logName[id] << ": " << str.data()
-                       << std::endl;
+      va_start(args, format);
+      str = formatString(format, args);
+      va_end(args);
+
+      *(logger->outfile) << getTick() << ": " << logName[id] << ": " << str
+                         << std::endl;
+    }
   }
 }
 
 void debugprint(LOG_ID id, const uint8_t *buffer, uint64_t size) {
+  Logger *logger = getContext()->logger;
+
   if (logger && logger->outfile && id < LOG_NUM) {
     uint32_t temp;
 
@@ -137,14 +495,281 @@ void debugprint(LOG_ID id, const uint8_t *buffer, uint64_t size) {
   }
 }
 
+void updateLogMask() {
+  Context *ctx = getContext();
+  Logger *logger = ctx->logger;
+
+  if (logger && (logger->outfile || logger->sink)) {
+    ctx->logMask = logger->mask;
+  }
+  else {
+    ctx->logMask = 0;
+  }
+}
+
 void initLogSystem(std::ostream *out, std::ostream *err) {
   destroyLogSystem();
 
-  logger = new Logger(out, err);
+  getContext()->logger = new Logger(out, err);
+
+  updateLogMask();
+}
+
+/**
+ * Record debugprint in binary format to stream, in addition to text log
+ * given to initLogSystem. Records are buffered per context, so there is no
+ * locking even when multiple instances run in parallel.
+ */
+void initBinaryLog(std::ostream *out, uint64_t bufferSize) {
+  Logger *logger = getContext()->logger;
+
+  if (!logger) {
+    panic("Log system is not initialized");
+  }
+
+  delete logger->sink;
+  logger->sink = nullptr;
+
+  if (out) {
+    logger->sink = new BinarySink(out, bufferSize);
+  }
+
+  updateLogMask();
+}
+
+//! Select components to print, one bit per LOG_ID
+void setLogMask(uint64_t mask) {
+  Logger *logger = getContext()->logger;
+
+  if (!logger) {
+    panic("Log system is not initialized");
+  }
+
+  logger->mask = mask;
+
+  updateLogMask();
+}
+
+//! Parse comma separated component names (ex. "FTL,PAL::PALOLD"), or "all"
+bool parseLogMask(std::string str, uint64_t &mask) {
+  uint64_t begin = 0;
+
+  mask = 0;
+
+  while (begin <= str.length()) {
+    auto end = str.find(',', begin);
+    std::string name;
+    bool found = false;
+
+    if (end == std::string::npos) {
+      end = str.length();
+    }
+
+    name = str.substr(begin, end - begin);
+    begin = end + 1;
+
+    if (name.length() == 0) {
+      continue;
+    }
+
+    if (strcasecmp(name.c_str(), "all") == 0) {
+      mask = ~0ull;
+
+      continue;
+    }
+
+    for (uint32_t i = 0; i < LOG_NUM; i++) {
+      if (strcasecmp(name.c_str(), logName[i].c_str()) == 0) {
+        mask |= 1ull << i;
+        found = true;
+
+        break;
+      }
+    }
+
+    if (!found) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 void destroyLogSystem() {
-  delete logger;
+  Context *ctx = getContext();
+
+  delete ctx->logger;
+  ctx->logger = nullptr;
+
+  updateLogMask();
+}
+
+template <class T>
+bool readValue(std::istream &in, T &value) {
+  in.read((char *)&value, sizeof(T));
+
+  return in.good();
+}
+
+template <class T>
+void appendFormatted(std::string &str, std::string &spec, T value) {
+  int length = snprintf(nullptr, 0, spec.c_str(), value);
+
+  if (length > 0) {
+    std::vector<char> buffer(length + 1);
+
+    snprintf(buffer.data(), buffer.size(), spec.c_str(), value);
+    str.append(buffer.data(), length);
+  }
+}
+
+/**
+ * Decode binary log written by initBinaryLog to text, in same format as
+ * text log
+ */
+bool decodeBinaryLog(std::istream &in, std::ostream &out) {
+  std::vector<std::pair<LOG_ID, std::string>> formats;
+  char magic[sizeof(BINARY_LOG_MAGIC)];
+  uint8_t type;
+
+  in.read(magic, sizeof(magic));
+
+  if (!in.good() || memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0) {
+    return false;
+  }
+
+  while (readValue(in, type)) {
+    if (type == BINARY_LOG_FORMAT) {
+      uint32_t id;
+      uint8_t logID;
+      uint16_t length;
+      std::string format;
+
+      readValue(in, id);
+      readValue(in, logID);
+      readValue(in, length);
+      format.resize(length);
+      in.read(&format[0], length);
+
+      if (!in.good() || id != formats.size() || logID >= LOG_NUM) {
+        return false;
+      }
+
+      formats.emplace_back((LOG_ID)logID, format);
+    }
+    else if (type == BINARY_LOG_PRINT) {
+      uint64_t tick;
+      uint32_t id;
+      std::string str;
+      const char *format;
+      Conversion conv;
+
+      readValue(in, tick);
+
+      if (!readValue(in, id) || id >= formats.size()) {
+        return false;
+      }
+
+      format = formats[id].second.c_str();
+
+      // Arguments are recorded as getArguments() lists them
+      while (*format) {
+        std::string spec("%");
+        int64_t value;
+
+        if (*format != '%') {
+          str.push_back(*format++);
+
+          continue;
+        }
+
+        format = parseConversion(format + 1, conv);
+        spec += conv.flags;
+
+        if (conv.width == "*") {
+          readValue(in, value);
+          spec += std::to_string(value);
+        }
+        else {
+          spec += conv.width;
+        }
+
+        if (conv.precision == ".*") {
+          readValue(in, value);
+          spec += "." + std::to_string(value);
+        }
+        else {
+          spec += conv.precision;
+        }
+
+        switch (conv.conversion) {
+          case '%':
+            str.push_back('%');
+            break;
+          case 'd':
+          case 'i':
+          case 'u':
+          case 'o':
+          case 'x':
+          case 'X':
+            readValue(in, value);
+            spec += "ll";
+            spec.push_back(conv.conversion);
+            appendFormatted(str, spec, (long long)value);
+            break;
+          case 'c':
+            readValue(in, value);
+            spec.push_back('c');
+            appendFormatted(str, spec, (int)value);
+            break;
+          case 'f':
+          case 'F':
+          case 'e':
+          case 'E':
+          case 'g':
+          case 'G':
+          case 'a':
+          case 'A': {
+            double real;
+
+            readValue(in, real);
+            spec.push_back(conv.conversion);
+            appendFormatted(str, spec, real);
+          } break;
+          case 's': {
+            uint16_t length;
+            std::string arg;
+
+            readValue(in, length);
+            arg.resize(length);
+            in.read(&arg[0], length);
+            spec.push_back('s');
+            appendFormatted(str, spec, arg.c_str());
+          } break;
+          case 'p':
+            readValue(in, value);
+            spec.push_back('p');
+            appendFormatted(str, spec, (void *)(uintptr_t)value);
+            break;
+          case 'n':
+            readValue(in, value);
+            break;
+        }
+      }
+
+      if (!in.good()) {
+        return false;
+      }
+
+      out << tick << ": " << logName[formats[id].first] << ": " << str
+          << "\n";
+    }
+    else {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 }  // namespace SimpleSSD
@@ -22,13 +22,39 @@
 #ifndef __SIM_LOG__
 #define __SIM_LOG__
 
+#include <cinttypes>
 #include <iostream>
+#include <string>
 
 namespace SimpleSSD {
 
+/**
+ * \brief Binary debug log format
+ *
+ * Binary log stores format string once, and raw arguments of each
+ * debugprint call, so logging does not format text while simulating.
+ * File starts with BINARY_LOG_MAGIC, followed by records:
+ *  - BINARY_LOG_FORMAT: uint32_t format ID, uint8_t LOG_ID,
+ *    uint16_t length, format string (written at first use of format)
+ *  - BINARY_LOG_PRINT: uint64_t tick, uint32_t format ID, arguments in
+ *    order of format. Integers and pointers are 8 bytes, floating points
+ *    are double, strings are uint16_t length and characters.
+ */
+#define BINARY_LOG_MAGIC "SimpleSSD-blog1"
+
+typedef enum : uint8_t {
+  BINARY_LOG_FORMAT,
+  BINARY_LOG_PRINT,
+} BINARY_LOG_RECORD;
+
 void initLogSystem(std::ostream *, std::ostream *);
+void initBinaryLog(std::ostream *, uint64_t = 1048576);
+void setLogMask(uint64_t);
+bool parseLogMask(std::string, uint64_t &);
 void destroyLogSystem();
 
+bool decodeBinaryLog(std::istream &, std::ostream &);
+
 }  // namespace SimpleSSD
 
 #endif
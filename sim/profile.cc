@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "sim/profile.hh"
+
+#include <cstring>
+#include <iomanip>
+
+#include "sim/trace.hh"
+
+namespace SimpleSSD {
+
+const char profileName[PROFILE_NUM][8] = {"other", "hil", "icl",  "ftl",
+                                          "ftl.gc", "pal", "dram", "cpu"};
+
+Profiler::Profiler(std::ostream *o) : out(o), depth(0) {
+  memset(counter, 0, sizeof(counter));
+  memset(calls, 0, sizeof(calls));
+
+  stack[0] = PROFILE_OTHER;
+
+  beginTime = std::chrono::steady_clock::now();
+  beginCounter = readProfileCounter();
+  last = beginCounter;
+}
+
+Profiler::~Profiler() {
+  if (out) {
+    print(*out);
+  }
+}
+
+void Profiler::overflow() {
+  panic("Profile scope nested too deep");
+}
+
+void Profiler::print(std::ostream &os) {
+  uint64_t now = readProfileCounter();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - beginTime;
+  double total = elapsed.count();
+  double scale;
+
+  // Charge time until now to current scope, as if it is left here
+  counter[stack[depth]] += now - last;
+  last = now;
+
+  // Counter is converted to second with ratio measured over whole run
+  scale = now > beginCounter ? total / (now - beginCounter) : 0.;
+
+  os << "Host time profile: " << std::fixed << std::setprecision(3) << total
+     << " s" << std::endl;
+  os << "  " << std::left << std::setw(8) << "layer" << std::right
+     << std::setw(12) << "time(s)" << std::setw(8) << "share" << std::setw(14)
+     << "calls" << std::setw(12) << "ns/call" << std::endl;
+
+  for (int i = 0; i < PROFILE_NUM; i++) {
+    double time = counter[i] * scale;
+
+    os << "  " << std::left << std::setw(8) << profileName[i] << std::right
+       << std::setw(12) << std::setprecision(3) << time << std::setw(7)
+       << std::setprecision(1) << (total > 0. ? time * 100. / total : 0.)
+       << "%" << std::setw(14) << calls[i] << std::setw(12);
+
+    if (calls[i] > 0) {
+      os << std::setprecision(1) << time * 1e9 / calls[i];
+    }
+    else {
+      os << "-";
+    }
+
+    os << std::endl;
+  }
+
+  os.unsetf(std::ios::floatfield);
+  os << std::setprecision(6);
+}
+
+/**
+ * Profile host time of current context, report is written to out when
+ * profiler is destroyed.
+ */
+void initProfiler(std::ostream *out) {
+  Context *ctx = getContext();
+
+  delete ctx->profiler;
+  ctx->profiler = nullptr;
+
+#ifndef SIMPLESSD_NO_PROFILE
+  if (out) {
+    ctx->profiler = new Profiler(out);
+  }
+#else
+  if (out) {
+    warn("Host time profile is disabled at compile time");
+  }
+#endif
+}
+
+void destroyProfiler() {
+  Context *ctx = getContext();
+
+  delete ctx->profiler;
+  ctx->profiler = nullptr;
+}
+
+const char *getProfileName(PROFILE_ID id) {
+  return id < PROFILE_NUM ? profileName[id] : "unknown";
+}
+
+}  // namespace SimpleSSD
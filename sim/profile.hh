@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __SIM_PROFILE__
+#define __SIM_PROFILE__
+
+#include <chrono>
+#include <cinttypes>
+#include <iostream>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "sim/context.hh"
+
+namespace SimpleSSD {
+
+/**
+ * \brief Host time profile of each layer
+ *
+ * Measures host CPU time spent in each layer of simulator, to find which
+ * one slows down simulation. Layers call each other synchronously, so time
+ * is exclusive: time in FTL called by ICL is charged to FTL only. Time out
+ * of any layer (event engine, host interface, tools) goes to PROFILE_OTHER.
+ *
+ * Enabled per context by initProfiler(), and reported at
+ * releaseSimpleSSDEngine(). Define SIMPLESSD_NO_PROFILE to compile out
+ * all counters.
+ */
+typedef enum : uint8_t {
+  PROFILE_OTHER,   //!< Event engine, host interface and tools
+  PROFILE_HIL,     //!< HIL request handling and completion
+  PROFILE_ICL,     //!< Internal cache
+  PROFILE_FTL,     //!< Mapping table lookup and update
+  PROFILE_FTL_GC,  //!< Victim selection and GC (log block merge of FAST)
+  PROFILE_PAL,     //!< PAL2 timeline scheduling
+  PROFILE_DRAM,    //!< DRAM timing and DRAMPower
+  PROFILE_CPU,     //!< Firmware CPU model
+  PROFILE_NUM
+} PROFILE_ID;
+
+#define PROFILE_MAX_DEPTH 32
+
+//! Cheapest monotonic counter of host, not in any fixed unit
+inline uint64_t readProfileCounter() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+class Profiler {
+ private:
+  std::ostream *out;
+
+  uint64_t counter[PROFILE_NUM];
+  uint64_t calls[PROFILE_NUM];
+  PROFILE_ID stack[PROFILE_MAX_DEPTH];
+  uint32_t depth;
+  uint64_t last;
+
+  uint64_t beginCounter;
+  std::chrono::steady_clock::time_point beginTime;
+
+ public:
+  Profiler(std::ostream *);
+  ~Profiler();
+
+  inline void enter(PROFILE_ID id) {
+    uint64_t now = readProfileCounter();
+
+    counter[stack[depth]] += now - last;
+    last = now;
+
+    if (++depth == PROFILE_MAX_DEPTH) {
+      depth--;
+      overflow();
+    }
+
+    stack[depth] = id;
+    calls[id]++;
+  }
+
+  inline void leave() {
+    uint64_t now = readProfileCounter();
+
+    counter[stack[depth]] += now - last;
+    last = now;
+
+    if (depth > 0) {
+      depth--;
+    }
+  }
+
+  void overflow();
+  void print(std::ostream &);
+};
+
+void initProfiler(std::ostream *);
+void destroyProfiler();
+
+const char *getProfileName(PROFILE_ID);
+
+/**
+ * \brief Charge host time of current scope to given layer
+ *
+ * Costs one branch when profiler is disabled.
+ */
+class ProfileScope {
+#ifndef SIMPLESSD_NO_PROFILE
+ private:
+  Profiler *profiler;
+
+ public:
+  ProfileScope(PROFILE_ID id) : profiler(getContext()->profiler) {
+    if (profiler) {
+      profiler->enter(id);
+    }
+  }
+
+  ~ProfileScope() {
+    if (profiler) {
+      profiler->leave();
+    }
+  }
+#else
+ public:
+  ProfileScope(PROFILE_ID) {}
+#endif
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+}  // namespace SimpleSSD
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sim/request_trace.hh"
+
+#include <cstring>
+
+#include "sim/trace.hh"
+
+namespace SimpleSSD {
+
+const char *traceName[TRACE_NUM] = {
+    "hil.read",     //!< TRACE_HIL_READ
+    "hil.write",    //!< TRACE_HIL_WRITE
+    "hil.flush",    //!< TRACE_HIL_FLUSH
+    "hil.trim",     //!< TRACE_HIL_TRIM
+    "cpu.queue",    //!< TRACE_CPU_QUEUE
+    "icl.hit",      //!< TRACE_ICL_HIT
+    "icl.miss",     //!< TRACE_ICL_MISS
+    "ftl.mapping",  //!< TRACE_FTL_MAPPING
+    "ftl.gc",       //!< TRACE_FTL_GC
+    "pal.wait",     //!< TRACE_PAL_WAIT
+    "pal.read",     //!< TRACE_PAL_READ
+    "pal.write",    //!< TRACE_PAL_WRITE
+    "pal.erase",    //!< TRACE_PAL_ERASE
+};
+
+RequestTracer::RequestTracer(std::ostream *o, uint64_t size)
+    : out(o), buffer(size), used(0), current(0) {
+  out->write(REQUEST_TRACE_MAGIC, sizeof(REQUEST_TRACE_MAGIC));
+}
+
+RequestTracer::~RequestTracer() {
+  flush();
+}
+
+void RequestTracer::record(TRACE_ID id, uint64_t subID, uint64_t begin,
+                           uint64_t end) {
+  // Background work is recorded only as one span of triggering request
+  if (current == 0) {
+    return;
+  }
+
+  TraceRecord &rec = buffer[used++];
+
+  rec.reqID = current;
+  rec.begin = begin;
+  rec.end = end;
+  rec.subID = (uint32_t)subID;
+  rec.id = id;
+  memset(rec.reserved, 0, sizeof(rec.reserved));
+
+  if (used == buffer.size()) {
+    flush();
+  }
+}
+
+void RequestTracer::flush() {
+  out->write((const char *)buffer.data(), used * sizeof(TraceRecord));
+  out->flush();
+
+  used = 0;
+}
+
+/**
+ * Record request lifecycle of current context to stream. Records are
+ * buffered per context, bufferSize is in records.
+ */
+void initRequestTrace(std::ostream *out, uint64_t bufferSize) {
+  Context *ctx = getContext();
+
+  if (bufferSize == 0) {
+    panic("Invalid request trace buffer size");
+  }
+
+  delete ctx->tracer;
+  ctx->tracer = nullptr;
+
+  if (out) {
+    ctx->tracer = new RequestTracer(out, bufferSize);
+  }
+}
+
+void destroyRequestTrace() {
+  Context *ctx = getContext();
+
+  delete ctx->tracer;
+  ctx->tracer = nullptr;
+}
+
+const char *getTraceName(TRACE_ID id) {
+  return id < TRACE_NUM ? traceName[id] : "unknown";
+}
+
+//! Read whole trace written by initRequestTrace
+bool readRequestTrace(std::istream &in, std::vector<TraceRecord> &list) {
+  char magic[sizeof(REQUEST_TRACE_MAGIC)];
+  TraceRecord rec;
+
+  in.read(magic, sizeof(magic));
+
+  if (!in.good() || memcmp(magic, REQUEST_TRACE_MAGIC, sizeof(magic)) != 0) {
+    return false;
+  }
+
+  while (in.read((char *)&rec, sizeof(TraceRecord))) {
+    if (rec.id >= TRACE_NUM) {
+      return false;
+    }
+
+    list.push_back(rec);
+  }
+
+  // Partial record means truncated file
+  return in.gcount() == 0;
+}
+
+}  // namespace SimpleSSD
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __SIM_REQUEST_TRACE__
+#define __SIM_REQUEST_TRACE__
+
+#include <cinttypes>
+#include <iostream>
+#include <vector>
+
+#include "sim/context.hh"
+
+namespace SimpleSSD {
+
+/**
+ * \brief Request lifecycle trace
+ *
+ * Records where each host request spends time, as spans of ticks in each
+ * layer. Layers process request synchronously in one event, so spans are
+ * attributed to HIL request currently being processed, set by
+ * traceRequest(). Spans of background work (cache eviction, GC) are not
+ * recorded, only its total span is attributed to the request triggered it.
+ *
+ * File starts with REQUEST_TRACE_MAGIC, followed by TraceRecords.
+ */
+#define REQUEST_TRACE_MAGIC "SimpleSSD-rtr1"
+
+typedef enum : uint8_t {
+  TRACE_HIL_READ,     //!< Arrival to completion of host request
+  TRACE_HIL_WRITE,    //!< Arrival to completion of host request
+  TRACE_HIL_FLUSH,    //!< Arrival to completion of host request
+  TRACE_HIL_TRIM,     //!< Arrival to completion of host request
+  TRACE_CPU_QUEUE,    //!< Arrival to start of HIL firmware
+  TRACE_ICL_HIT,      //!< Cache access without eviction
+  TRACE_ICL_MISS,     //!< Cache access with NVM access or eviction
+  TRACE_FTL_MAPPING,  //!< DRAM access of mapping table
+  TRACE_FTL_GC,       //!< Whole GC triggered by request
+  TRACE_PAL_WAIT,     //!< Wait for channel and die
+  TRACE_PAL_READ,     //!< Channel and die busy for operation
+  TRACE_PAL_WRITE,    //!< Channel and die busy for operation
+  TRACE_PAL_ERASE,    //!< Channel and die busy for operation
+  TRACE_NUM
+} TRACE_ID;
+
+typedef struct {
+  uint64_t reqID;
+  uint64_t begin;
+  uint64_t end;
+  uint32_t subID;
+  uint8_t id;
+  uint8_t reserved[3];
+} TraceRecord;
+
+class RequestTracer {
+ private:
+  std::ostream *out;
+  std::vector<TraceRecord> buffer;
+  uint64_t used;
+  uint64_t current;
+
+ public:
+  RequestTracer(std::ostream *, uint64_t);
+  ~RequestTracer();
+
+  uint64_t setRequest(uint64_t reqID) {
+    uint64_t prev = current;
+
+    current = reqID;
+
+    return prev;
+  }
+
+  void record(TRACE_ID, uint64_t, uint64_t, uint64_t);
+  void flush();
+};
+
+void initRequestTrace(std::ostream *, uint64_t = 65536);
+void destroyRequestTrace();
+
+//! Set HIL request of following spans, returns previous one
+inline uint64_t traceRequest(uint64_t reqID) {
+  RequestTracer *tracer = getContext()->tracer;
+
+  return tracer ? tracer->setRequest(reqID) : 0;
+}
+
+inline void traceSpan(TRACE_ID id, uint64_t subID, uint64_t begin,
+                      uint64_t end) {
+  RequestTracer *tracer = getContext()->tracer;
+
+  if (tracer) {
+    tracer->record(id, subID, begin, end);
+  }
+}
+
+const char *getTraceName(TRACE_ID);
+bool readRequestTrace(std::istream &, std::vector<TraceRecord> &);
+
+}  // namespace SimpleSSD
+
+#endif
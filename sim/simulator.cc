@@ -19,16 +19,17 @@
 
 #include "sim/simulator.hh"
 
-namespace SimpleSSD {
+#include "sim/context.hh"
 
-// Defined in sim/simulator.hh
-Simulator *sim = nullptr;
+namespace SimpleSSD {
 
 void setSimulator(Simulator *p) {
-  sim = p;
+  getContext()->sim = p;
 }
 
 uint64_t getTick() {
+  Simulator *sim = getContext()->sim;
+
   if (sim) {
     return sim->getCurrentTick();
   }
@@ -37,6 +38,8 @@ uint64_t getTick() {
 }
 
 Event allocate(EventFunction f) {
+  Simulator *sim = getContext()->sim;
+
   if (sim) {
     return sim->allocateEvent(f);
   }
@@ -45,18 +48,24 @@ Event allocate(EventFunction f) {
 }
 
 void schedule(Event e, uint64_t t) {
+  Simulator *sim = getContext()->sim;
+
   if (sim) {
     sim->scheduleEvent(e, t);
   }
 }
 
 void deschedule(Event e) {
+  Simulator *sim = getContext()->sim;
+
   if (sim) {
     sim->descheduleEvent(e);
   }
 }
 
 bool scheduled(Event e, uint64_t *p) {
+  Simulator *sim = getContext()->sim;
+
   if (sim) {
     return sim->isScheduled(e, p);
   }
@@ -65,6 +74,8 @@ bool scheduled(Event e, uint64_t *p) {
 }
 
 void deallocate(Event e) {
+  Simulator *sim = getContext()->sim;
+
   if (sim) {
     sim->deallocateEvent(e);
   }
@@ -25,32 +25,87 @@
 
 namespace SimpleSSD {
 
-template <class T>
-void StateObject::pushValue(std::vector<uint8_t> &data, T value) {
-  uint32_t valueSize = sizeof(value);
-  uint8_t *src = (uint8_t *)&value;
-  uint8_t *dst = nullptr;
+#define CHECKPOINT_MAGIC "SimpleSSD-ckpt"
+#define CHECKPOINT_VERSION 8
 
-  data.resize(data.size() + valueSize);
+const uint32_t tagLength = 4;
 
-  dst = data.data() + data.size() - valueSize;
-  memcpy(dst, src, valueSize);
+void StateObject::pushString(std::ostream &out, const std::string &str) {
+  pushValue(out, (uint64_t)str.length());
+  out.write(str.data(), str.length());
 }
 
-template <class T>
-void StateObject::popValue(std::vector<uint8_t> &data, T value) {
-  uint32_t valueSize = sizeof(value);
-  uint8_t *dst = (uint8_t *)&value;
-  uint8_t *src = nullptr;
+void StateObject::popString(std::istream &in, std::string &str) {
+  uint64_t length;
 
-  if (data.size() < valueSize) {
-    panic("Invalid data stream size");
+  popValue(in, length);
+  str.resize(length);
+  in.read(&str[0], length);
+  checkStream(in);
+}
+
+void StateObject::pushTag(std::ostream &out, const char *tag) {
+  out.write(tag, tagLength);
+}
+
+void StateObject::popTag(std::istream &in, const char *tag) {
+  char buffer[tagLength];
+
+  in.read(buffer, tagLength);
+  checkStream(in);
+
+  if (memcmp(buffer, tag, tagLength) != 0) {
+    panic("Checkpoint mismatch: expected section %.4s, got %.4s", tag,
+          buffer);
+  }
+}
+
+void StateObject::checkValue(std::istream &in, uint64_t expected,
+                             const char *name) {
+  uint64_t value;
+
+  popValue(in, value);
+
+  if (value != expected) {
+    panic("Checkpoint does not match configuration: %s is %" PRIu64
+          " in checkpoint, but %" PRIu64 " in current configuration",
+          name, value, expected);
+  }
+}
+
+void StateObject::checkStream(std::istream &in) {
+  if (!in.good()) {
+    panic("Unexpected end of checkpoint");
+  }
+}
+
+void writeCheckpointHeader(std::ostream &out, uint64_t tick) {
+  uint32_t version = CHECKPOINT_VERSION;
+
+  out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+  out.write((const char *)&version, sizeof(version));
+  out.write((const char *)&tick, sizeof(tick));
+}
+
+bool readCheckpointHeader(std::istream &in, uint64_t &tick) {
+  char magic[sizeof(CHECKPOINT_MAGIC)];
+  uint32_t version;
+
+  in.read(magic, sizeof(magic));
+  in.read((char *)&version, sizeof(version));
+  in.read((char *)&tick, sizeof(tick));
+
+  if (!in.good() || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+    return false;
   }
 
-  src = data.data() + data.size() - valueSize;
-  memcpy(dst, src, valueSize);
+  if (version != CHECKPOINT_VERSION) {
+    warn("Checkpoint version %u is not supported", version);
+
+    return false;
+  }
 
-  data.erase(data.begin() + data.size() - valueSize, data.end());
+  return true;
 }
 
 }  // namespace SimpleSSD
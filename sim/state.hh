@@ -23,25 +23,84 @@
 #define __SIM_STATE__
 
 #include <cinttypes>
+#include <iostream>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace SimpleSSD {
 
+/**
+ * \brief Checkpointable object
+ *
+ * State is written to binary stream in native byte order, in the order of
+ * saveState calls, and read back in the same order by loadState. Each object
+ * starts its state with four-character tag, so mismatch between writer and
+ * reader is detected at the first wrong section instead of silently loading
+ * garbage.
+ *
+ * Checkpoint should be taken when there is no outstanding request, as
+ * in-flight events are not part of the state.
+ */
 class StateObject {
  protected:
   template <class T>
-  static void pushValue(std::vector<uint8_t> &, T);
+  static void pushValue(std::ostream &out, const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable type can be written directly");
+
+    out.write((const char *)&value, sizeof(T));
+  }
+
+  template <class T>
+  static void popValue(std::istream &in, T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable type can be read directly");
+
+    in.read((char *)&value, sizeof(T));
+    checkStream(in);
+  }
+
   template <class T>
-  static void popValue(std::vector<uint8_t> &, T);
+  static void pushVector(std::ostream &out, const std::vector<T> &list) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable type can be written directly");
+
+    pushValue(out, (uint64_t)list.size());
+    out.write((const char *)list.data(), list.size() * sizeof(T));
+  }
+
+  template <class T>
+  static void popVector(std::istream &in, std::vector<T> &list) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable type can be read directly");
+    uint64_t size;
+
+    popValue(in, size);
+    list.resize(size);
+    in.read((char *)list.data(), size * sizeof(T));
+    checkStream(in);
+  }
+
+  static void pushString(std::ostream &, const std::string &);
+  static void popString(std::istream &, std::string &);
+
+  static void pushTag(std::ostream &, const char *);
+  static void popTag(std::istream &, const char *);
+  static void checkValue(std::istream &, uint64_t, const char *);
+  static void checkStream(std::istream &);
 
  public:
   StateObject() {}
   virtual ~StateObject() {}
 
-  virtual void saveState(std::vector<uint8_t> &) {}
-  virtual void loadState(std::vector<uint8_t> &) {}
+  virtual void saveState(std::ostream &) {}
+  virtual void loadState(std::istream &) {}
 };
 
+void writeCheckpointHeader(std::ostream &, uint64_t);
+bool readCheckpointHeader(std::istream &, uint64_t &);
+
 }  // namespace SimpleSSD
 
 #endif
@@ -33,6 +33,12 @@ typedef struct {
   std::string desc;
 } Stats;
 
+typedef struct {
+  std::string name;
+  std::string desc;
+  uint64_t bytes;  //!< Estimated host memory usage
+} MemoryUsage;
+
 class StatObject {
  public:
   StatObject() {}
@@ -41,6 +47,14 @@ class StatObject {
   virtual void getStatList(std::vector<Stats> &, std::string) {}
   virtual void getStatValues(std::vector<double> &) {}
   virtual void resetStatValues() {}
+
+  /**
+   * \brief Report host memory used by internal data structures
+   *
+   * Unlike getStatValues, this is not reset by resetStatValues. Roots of the
+   * stat tree (HIL, NVMe subsystem) append these to their stat list.
+   */
+  virtual void getMemoryUsage(std::vector<MemoryUsage> &, std::string) {}
 };
 
 }  // namespace SimpleSSD
@@ -24,6 +24,8 @@
 
 #include <cinttypes>
 
+#include "sim/context.hh"
+
 namespace SimpleSSD {
 
 typedef enum {
@@ -46,6 +48,28 @@ typedef enum {
 void debugprint(LOG_ID, const char *, ...);
 void debugprint(LOG_ID, const uint8_t *, uint64_t);
 
+inline bool isLogEnabled(LOG_ID id) {
+  return (getContext()->logMask >> id) & 1;
+}
+
+/**
+ * Components compiled into debugprint, one bit per LOG_ID. Calls for other
+ * components are removed at compile time, with their arguments. Set to 0 by
+ * DEBUG_LOG=OFF in CMake.
+ */
+#ifndef SIMPLESSD_LOG_MASK
+#define SIMPLESSD_LOG_MASK 0xFFFFFFFFFFFFFFFFull
+#endif
+
+// Arguments are evaluated only when component is enabled at runtime
+#define debugprint(id, ...)                                                  \
+  do {                                                                       \
+    if ((((uint64_t)(SIMPLESSD_LOG_MASK) >> (id)) & 1) &&                    \
+        SimpleSSD::isLogEnabled(id)) {                                       \
+      SimpleSSD::debugprint(id, __VA_ARGS__);                                \
+    }                                                                        \
+  } while (0)
+
 void panic(const char *, ...);
 void warn(const char *, ...);
 void info(const char *, ...);
@@ -0,0 +1,520 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "dram/simple.hh"
+#include "ftl/ftl.hh"
+#include "icl/icl.hh"
+#include "pal/pal.hh"
+#include "sim/engine.hh"
+#include "util/bitset.hh"
+
+using namespace SimpleSSD;
+
+/**
+ * \brief One microbenchmark
+ *
+ * Component under test is built by constructor, outside of measured time.
+ * run() performs given number of operations back to back (each operation
+ * starts when previous one finishes in simulated time), and returns
+ * simulated ticks spent.
+ */
+class Benchmark {
+ protected:
+  EventEngine &engine;
+  std::mt19937_64 gen;
+
+  // Advance engine with operations, so periodic events (PAL flush, DRAM
+  // refresh) run as they do in full simulation
+  inline void advance(uint64_t tick) {
+    if (tick > engine.getCurrentTick()) {
+      engine.runUntil(tick);
+    }
+  }
+
+ public:
+  Benchmark(EventEngine &e) : engine(e), gen(1) {}
+  virtual ~Benchmark() {}
+
+  virtual uint64_t run(uint64_t) = 0;
+};
+
+volatile uint64_t benchSink;
+
+class BitsetBench : public Benchmark {
+ private:
+  Bitset a;
+  Bitset b;
+  bool logic;
+  uint64_t sink;
+
+ public:
+  BitsetBench(EventEngine &e, bool l)
+      : Benchmark(e), a(256), b(256), logic(l), sink(0) {}
+
+  uint64_t run(uint64_t n) override {
+    for (uint64_t i = 0; i < n; i++) {
+      if (logic) {
+        b.set((uint32_t)(i * 7) & 255);
+        a |= b;
+        a &= b;
+        sink += a.count() + a.any();
+      }
+      else {
+        a.set((uint32_t)i & 255);
+        sink += a.test((uint32_t)(i * 7) & 255);
+        a.reset((uint32_t)(i * 13) & 255);
+      }
+    }
+
+    // Keep compiler from removing loop
+    benchSink = sink;
+
+    return 0;
+  }
+};
+
+class DRAMBench : public Benchmark {
+ private:
+  DRAM::SimpleDRAM dram;
+  uint64_t size;
+
+ public:
+  DRAMBench(EventEngine &e, ConfigReader &conf, uint64_t s)
+      : Benchmark(e), dram(conf), size(s) {}
+
+  uint64_t run(uint64_t n) override {
+    uint64_t begin = engine.getCurrentTick();
+    uint64_t tick = begin;
+
+    for (uint64_t i = 0; i < n; i++) {
+      dram.read(nullptr, size, tick);
+      advance(tick);
+    }
+
+    return tick - begin;
+  }
+};
+
+class PALBench : public Benchmark {
+ private:
+  PAL::PAL pal;
+  PAL::Request req;
+  bool write;
+
+ public:
+  PALBench(EventEngine &e, ConfigReader &conf, bool w)
+      : Benchmark(e),
+        pal(conf),
+        req(pal.getInfo()->pageInSuperPage),
+        write(w) {
+    req.ioFlag.set();
+  }
+
+  uint64_t run(uint64_t n) override {
+    std::uniform_int_distribution<uint32_t> block(
+        0, pal.getInfo()->superBlock - 1);
+    std::uniform_int_distribution<uint32_t> page(0, pal.getInfo()->page - 1);
+    uint64_t begin = engine.getCurrentTick();
+    uint64_t tick = begin;
+
+    for (uint64_t i = 0; i < n; i++) {
+      req.blockIndex = block(gen);
+      req.pageIndex = page(gen);
+
+      if (write) {
+        pal.write(req, tick);
+      }
+      else {
+        pal.read(req, tick);
+      }
+
+      advance(tick);
+    }
+
+    return tick - begin;
+  }
+};
+
+class FTLBench : public Benchmark {
+ private:
+  DRAM::SimpleDRAM dram;
+  FTL::FTL ftl;
+  FTL::Request req;
+  uint64_t totalPages;
+  bool write;
+
+ public:
+  FTLBench(EventEngine &e, ConfigReader &conf, bool w)
+      : Benchmark(e),
+        dram(conf),
+        ftl(conf, &dram),
+        req(ftl.getInfo()->ioUnitInPage),
+        write(w) {
+    FTL::Parameter *param = ftl.getInfo();
+
+    totalPages = param->totalLogicalBlocks * param->pagesInBlock;
+
+    req.ioFlag.set();
+  }
+
+  uint64_t run(uint64_t n) override {
+    std::uniform_int_distribution<uint64_t> lpn(0, totalPages - 1);
+    uint64_t begin = engine.getCurrentTick();
+    uint64_t tick = begin;
+
+    for (uint64_t i = 0; i < n; i++) {
+      req.lpn = lpn(gen);
+
+      if (write) {
+        ftl.write(req, tick);
+      }
+      else {
+        ftl.read(req, tick);
+      }
+
+      advance(tick);
+    }
+
+    return tick - begin;
+  }
+};
+
+class ICLBench : public Benchmark {
+ private:
+  ICL::ICL icl;
+  ICL::Request req;
+  uint64_t totalPages;
+  bool write;
+  bool hit;
+
+ public:
+  ICLBench(EventEngine &e, ConfigReader &conf, bool w, bool h)
+      : Benchmark(e), icl(conf), write(w), hit(h) {
+    uint32_t pageSize;
+
+    icl.getLPNInfo(totalPages, pageSize);
+
+    req.range.slpn = 0;
+    req.range.nlp = 1;
+    req.offset = 0;
+    req.length = pageSize;
+  }
+
+  uint64_t run(uint64_t n) override {
+    std::uniform_int_distribution<uint64_t> lpn(0, totalPages - 1);
+    uint64_t begin = engine.getCurrentTick();
+    uint64_t tick = begin;
+
+    for (uint64_t i = 0; i < n; i++) {
+      // Hit path accesses same page, which is cached after first access
+      req.range.slpn = hit ? 0 : lpn(gen);
+
+      if (write) {
+        icl.write(req, tick);
+      }
+      else {
+        icl.read(req, tick);
+      }
+
+      advance(tick);
+    }
+
+    return tick - begin;
+  }
+};
+
+typedef struct {
+  const char *name;
+  const char *desc;
+  std::function<Benchmark *()> create;
+} BenchEntry;
+
+typedef struct {
+  uint64_t iterations;
+  double hostTime;
+  uint64_t simTime;
+} BenchResult;
+
+void usage(const char *name) {
+  std::cerr
+      << "Usage: " << name << " [options] <config file>\n"
+      << "Run microbenchmarks of SimpleSSD hot paths with components built "
+         "from config.\n\n"
+      << "Options:\n"
+      << "  -f <name>  Run only benchmarks whose name contains <name>\n"
+      << "  -t <sec>   Minimum host time of each benchmark (default: 1.0)\n"
+      << "  -o <file>  Write results as CSV\n"
+      << "  -L         List benchmarks and exit\n";
+}
+
+double measure(Benchmark *bench, uint64_t n, uint64_t &simTime) {
+  auto begin = std::chrono::steady_clock::now();
+
+  simTime = bench->run(n);
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  return elapsed.count();
+}
+
+/**
+ * Grow iteration count until one run takes at least 1/10 of minimum time,
+ * then run once more with count scaled to reach minimum time. Like Google
+ * Benchmark, only last run is reported.
+ */
+BenchResult runBenchmark(Benchmark *bench, double minTime) {
+  BenchResult result;
+  double elapsed;
+  uint64_t n = 1;
+
+  while (true) {
+    elapsed = measure(bench, n, result.simTime);
+
+    if (elapsed >= minTime / 10 || n >= (1ull << 40)) {
+      break;
+    }
+
+    n *= 10;
+  }
+
+  if (elapsed < minTime) {
+    n = (uint64_t)(n * minTime / (elapsed > 0. ? elapsed : 1e-9)) + 1;
+    elapsed = measure(bench, n, result.simTime);
+  }
+
+  result.iterations = n;
+  result.hostTime = elapsed;
+
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<BenchEntry> list;
+  std::string filter;
+  std::string outPath;
+  std::ofstream outFile;
+  double minTime = 1.;
+  bool listOnly = false;
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+
+    if (opt[0] != '-' || opt[1] == 0 || opt[2] != 0) {
+      break;
+    }
+
+    if (opt[1] == 'L') {
+      listOnly = true;
+
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+
+      return 1;
+    }
+
+    const char *arg = argv[++i];
+
+    switch (opt[1]) {
+      case 'f':
+        filter = arg;
+        break;
+      case 't':
+        minTime = strtod(arg, nullptr);
+        break;
+      case 'o':
+        outPath = arg;
+        break;
+      default:
+        usage(argv[0]);
+
+        return 1;
+    }
+  }
+
+  EventEngine engine;
+  ConfigReader conf;
+  std::string configPath;
+
+  // Components are built with their own config, as each needs different
+  // initial state. Config readers must live as long as components.
+  std::vector<ConfigReader *> configs;
+
+  auto makeConfig = [&](std::vector<ConfigOverride> overrides) {
+    ConfigReader *pConf = new ConfigReader();
+
+    if (!pConf->init(configPath, overrides)) {
+      std::cerr << "Failed to read config file " << configPath << std::endl;
+
+      exit(1);
+    }
+
+    configs.push_back(pConf);
+
+    return pConf;
+  };
+
+  // Filled drive, by sequential filling, with given ratio of valid and
+  // invalid pages
+  auto filled = [&](const char *fill, const char *invalid) {
+    return makeConfig({{"ftl", "FillingMode", "0"},
+                       {"ftl", "FillRatio", fill},
+                       {"ftl", "InvalidPageRatio", invalid}});
+  };
+
+  // Cache enabled, on half filled drive
+  auto cached = [&]() {
+    return makeConfig({{"icl", "EnableReadCache", "1"},
+                       {"icl", "EnableWriteCache", "1"},
+                       {"ftl", "FillingMode", "0"},
+                       {"ftl", "FillRatio", "0.5"},
+                       {"ftl", "InvalidPageRatio", "0"}});
+  };
+
+  list.push_back({"bitset.set_test", "Set, test and reset single bit",
+                  [&]() { return new BitsetBench(engine, false); }});
+  list.push_back({"bitset.logic_count", "Or, and, count and any of 256 bits",
+                  [&]() { return new BitsetBench(engine, true); }});
+  list.push_back({"dram.read", "SimpleDRAM::read of one mapping entry",
+                  [&]() { return new DRAMBench(engine, conf, 8); }});
+  list.push_back({"dram.read.4k", "SimpleDRAM::read of 4KB",
+                  [&]() { return new DRAMBench(engine, conf, 4096); }});
+  list.push_back({"pal.read", "PAL read of random page (timeline scheduling)",
+                  [&]() { return new PALBench(engine, conf, false); }});
+  list.push_back({"pal.write", "PAL write of random page (timeline scheduling)",
+                  [&]() { return new PALBench(engine, conf, true); }});
+  list.push_back({"ftl.read.fill50", "FTL random read, 50% filled", [&]() {
+                    return new FTLBench(engine, *filled("0.5", "0"), false);
+                  }});
+  list.push_back({"ftl.write.fill0", "FTL random write, empty drive", [&]() {
+                    return new FTLBench(engine, *filled("0", "0"), true);
+                  }});
+  list.push_back({"ftl.write.fill50", "FTL random write, 50% filled", [&]() {
+                    return new FTLBench(engine, *filled("0.5", "0"), true);
+                  }});
+  list.push_back({"ftl.write.fill90", "FTL random write, 90% filled", [&]() {
+                    return new FTLBench(engine, *filled("0.9", "0"), true);
+                  }});
+  list.push_back({"ftl.write.gc",
+                  "FTL random write, full drive (GC on most writes)",
+                  [&]() {
+                    return new FTLBench(engine, *filled("1", "1"), true);
+                  }});
+  list.push_back({"icl.read.hit", "GenericCache read hit", [&]() {
+                    return new ICLBench(engine, *cached(), false, true);
+                  }});
+  list.push_back({"icl.read.miss", "GenericCache read miss of random page",
+                  [&]() {
+                    return new ICLBench(engine, *cached(), false, false);
+                  }});
+  list.push_back({"icl.write.hit", "GenericCache write hit", [&]() {
+                    return new ICLBench(engine, *cached(), true, true);
+                  }});
+  list.push_back({"icl.write.miss", "GenericCache write miss of random page",
+                  [&]() {
+                    return new ICLBench(engine, *cached(), true, false);
+                  }});
+
+  if (listOnly) {
+    for (auto &iter : list) {
+      std::cout << std::left << std::setw(20) << iter.name << " " << iter.desc
+                << std::endl;
+    }
+
+    return 0;
+  }
+
+  if (argc - i != 1) {
+    usage(argv[0]);
+
+    return 1;
+  }
+
+  configPath = argv[i];
+
+  if (outPath.length() > 0) {
+    outFile.open(outPath);
+
+    if (!outFile.is_open()) {
+      std::cerr << "Failed to open output file " << outPath << std::endl;
+
+      return 1;
+    }
+
+    outFile << "name,iterations,ns_per_op,ops_per_sec,sim_ns_per_op"
+            << std::endl;
+  }
+
+  conf = initSimpleSSDEngine(nullptr, &engine, nullptr, &std::cerr, configPath);
+
+  // Components do not model timing at tick 0 (initialization)
+  engine.setCurrentTick(1);
+
+  std::cout << std::left << std::setw(20) << "Benchmark" << std::right
+            << std::setw(14) << "Iterations" << std::setw(14) << "ns/op"
+            << std::setw(14) << "ops/s" << std::setw(14) << "sim ns/op"
+            << std::endl;
+
+  for (auto &iter : list) {
+    if (filter.length() > 0 && strstr(iter.name, filter.c_str()) == nullptr) {
+      continue;
+    }
+
+    Benchmark *bench = iter.create();
+    BenchResult result = runBenchmark(bench, minTime);
+    double nsPerOp = result.hostTime * 1e9 / result.iterations;
+    double opsPerSec = result.iterations / result.hostTime;
+    double simPerOp = result.simTime / 1000. / result.iterations;
+
+    delete bench;
+
+    std::cout << std::left << std::setw(20) << iter.name << std::right
+              << std::setw(14) << result.iterations << std::setw(14)
+              << std::fixed << std::setprecision(1) << nsPerOp
+              << std::setw(14) << std::setprecision(0) << opsPerSec
+              << std::setw(14) << std::setprecision(1) << simPerOp
+              << std::endl;
+
+    if (outFile.is_open()) {
+      outFile << iter.name << "," << result.iterations << "," << nsPerOp
+              << "," << opsPerSec << "," << simPerOp << std::endl;
+    }
+  }
+
+  releaseSimpleSSDEngine();
+
+  for (auto &iter : configs) {
+    delete iter;
+  }
+
+  return 0;
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "sim/request_trace.hh"
+
+using namespace SimpleSSD;
+
+// Latency components, each tick of request belongs to exactly one of them
+typedef enum {
+  PART_QUEUE,     //!< Waiting for HIL firmware (CPU)
+  PART_CACHE,     //!< ICL, excluding FTL and PAL below
+  PART_MAPPING,   //!< DRAM access of FTL mapping table
+  PART_PAL_WAIT,  //!< Waiting for channel and die
+  PART_PAL,       //!< NAND operation
+  PART_FIRMWARE,  //!< Not covered by any span, ex. firmware latency
+  PART_NUM
+} PART;
+
+const char *partName[PART_NUM] = {
+    "queue", "cache", "mapping", "palwait", "pal", "firmware",
+};
+
+typedef struct {
+  uint64_t reqID;
+  uint8_t type;
+  uint64_t arrivedAt;
+  uint64_t total;
+  uint64_t part[PART_NUM];
+  uint64_t gc;  //!< Part of PART_PAL_WAIT overlapped with GC
+} Breakdown;
+
+typedef std::pair<uint64_t, uint64_t> Window;
+
+void usage(const char *name) {
+  std::cerr
+      << "Usage: " << name << " [options] <request trace file>\n"
+      << "Break down latency of host requests in request trace of "
+         "SimpleSSD.\n\n"
+      << "Each request is split into exclusive components. When spans "
+         "overlap,\ntime is charged to the lowest layer: pal > palwait > "
+         "mapping > cache >\nqueue. (gc) is part of palwait overlapped "
+         "with garbage collection.\n\n"
+      << "Options:\n"
+      << "  -c <file>  Write breakdown of every request to CSV file\n";
+}
+
+// Merge overlapped windows
+void mergeWindows(std::vector<Window> &list) {
+  std::vector<Window> merged;
+
+  std::sort(list.begin(), list.end());
+
+  for (auto &iter : list) {
+    if (merged.size() > 0 && iter.first <= merged.back().second) {
+      merged.back().second = std::max(merged.back().second, iter.second);
+    }
+    else {
+      merged.push_back(iter);
+    }
+  }
+
+  list.swap(merged);
+}
+
+uint64_t getOverlap(std::vector<Window> &list, uint64_t begin, uint64_t end) {
+  uint64_t sum = 0;
+
+  auto iter = std::upper_bound(list.begin(), list.end(), Window(begin, 0));
+
+  if (iter != list.begin()) {
+    iter--;
+  }
+
+  for (; iter != list.end() && iter->first < end; iter++) {
+    uint64_t b = std::max(begin, iter->first);
+    uint64_t e = std::min(end, iter->second);
+
+    if (b < e) {
+      sum += e - b;
+    }
+  }
+
+  return sum;
+}
+
+int getPart(uint8_t id) {
+  switch (id) {
+    case TRACE_CPU_QUEUE:
+      return PART_QUEUE;
+    case TRACE_ICL_HIT:
+    case TRACE_ICL_MISS:
+      return PART_CACHE;
+    case TRACE_FTL_MAPPING:
+      return PART_MAPPING;
+    case TRACE_PAL_WAIT:
+      return PART_PAL_WAIT;
+    case TRACE_PAL_READ:
+    case TRACE_PAL_WRITE:
+    case TRACE_PAL_ERASE:
+      return PART_PAL;
+  }
+
+  return -1;
+}
+
+void breakdown(Breakdown &result, const TraceRecord *hil,
+               std::vector<const TraceRecord *> &spans,
+               std::vector<Window> &gcWindows) {
+  std::vector<uint64_t> points;
+  uint64_t begin = hil->begin;
+  uint64_t end = std::max(hil->begin, hil->end);
+
+  memset(&result, 0, sizeof(Breakdown));
+
+  result.reqID = hil->reqID;
+  result.type = hil->id;
+  result.arrivedAt = begin;
+  result.total = end - begin;
+
+  points.push_back(begin);
+  points.push_back(end);
+
+  for (auto &iter : spans) {
+    if (iter->begin > begin && iter->begin < end) {
+      points.push_back(iter->begin);
+    }
+    if (iter->end > begin && iter->end < end) {
+      points.push_back(iter->end);
+    }
+  }
+
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+
+  for (uint64_t i = 0; i + 1 < points.size(); i++) {
+    uint64_t b = points[i];
+    uint64_t e = points[i + 1];
+    int part = -1;
+
+    for (auto &iter : spans) {
+      if (iter->begin <= b && e <= iter->end) {
+        part = std::max(part, getPart(iter->id));
+      }
+    }
+
+    if (part < 0) {
+      part = PART_FIRMWARE;
+    }
+
+    result.part[part] += e - b;
+
+    if (part == PART_PAL_WAIT) {
+      result.gc += getOverlap(gcWindows, b, e);
+    }
+  }
+}
+
+void printRow(const char *name, std::vector<Breakdown> &list, uint64_t begin) {
+  double sum[PART_NUM + 2] = {0};
+  uint64_t count = list.size() - begin;
+
+  for (uint64_t i = begin; i < list.size(); i++) {
+    sum[0] += list[i].total;
+
+    for (int p = 0; p < PART_NUM; p++) {
+      sum[p + 1] += list[i].part[p];
+    }
+
+    sum[PART_NUM + 1] += list[i].gc;
+  }
+
+  printf("  %-8s %9" PRIu64 " %10.2f", name, count, sum[0] / count / 1e6);
+
+  for (int p = 0; p < PART_NUM; p++) {
+    printf(" %10.2f", sum[p + 1] / count / 1e6);
+
+    if (p == PART_PAL_WAIT) {
+      printf(" %10.2f", sum[PART_NUM + 1] / count / 1e6);
+    }
+  }
+
+  printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<TraceRecord> records;
+  std::unordered_map<uint64_t, std::vector<const TraceRecord *>> spans;
+  std::vector<const TraceRecord *> hilRecords;
+  std::vector<Window> gcWindows;
+  std::vector<Breakdown> results[TRACE_HIL_TRIM + 1];
+  std::string csvPath;
+  int i;
+
+  for (i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "-c") == 0) {
+      csvPath = argv[i + 1];
+    }
+    else {
+      break;
+    }
+  }
+
+  if (argc - i != 1) {
+    usage(argv[0]);
+
+    return 1;
+  }
+
+  std::ifstream in(argv[i], std::ios::binary);
+
+  if (!in.is_open()) {
+    std::cerr << "Failed to open request trace " << argv[i] << std::endl;
+
+    return 1;
+  }
+
+  if (!readRequestTrace(in, records)) {
+    std::cerr << "Failed to read " << argv[i]
+              << ": not a request trace or truncated" << std::endl;
+
+    return 1;
+  }
+
+  for (auto &iter : records) {
+    if (iter.id == TRACE_FTL_GC) {
+      gcWindows.push_back({iter.begin, iter.end});
+    }
+    else if (iter.id <= TRACE_HIL_TRIM) {
+      hilRecords.push_back(&iter);
+    }
+    else if (iter.reqID != 0) {
+      spans[iter.reqID].push_back(&iter);
+    }
+  }
+
+  mergeWindows(gcWindows);
+
+  for (auto &iter : hilRecords) {
+    Breakdown result;
+
+    breakdown(result, iter, spans[iter->reqID], gcWindows);
+    results[iter->id].push_back(result);
+  }
+
+  if (csvPath.length() > 0) {
+    std::ofstream csv(csvPath);
+
+    if (!csv.is_open()) {
+      std::cerr << "Failed to open CSV file " << csvPath << std::endl;
+
+      return 1;
+    }
+
+    csv << "id,type,arrived,total";
+
+    for (int p = 0; p < PART_NUM; p++) {
+      csv << "," << partName[p];
+
+      if (p == PART_PAL_WAIT) {
+        csv << ",gc";
+      }
+    }
+
+    csv << "\n";
+
+    for (auto &list : results) {
+      for (auto &iter : list) {
+        csv << iter.reqID << "," << getTraceName((TRACE_ID)iter.type) << ","
+            << iter.arrivedAt << "," << iter.total;
+
+        for (int p = 0; p < PART_NUM; p++) {
+          csv << "," << iter.part[p];
+
+          if (p == PART_PAL_WAIT) {
+            csv << "," << iter.gc;
+          }
+        }
+
+        csv << "\n";
+      }
+    }
+  }
+
+  // Each row is mean of requests at or above given percentile of latency
+  for (auto &list : results) {
+    const char *name[] = {"all", ">=p50", ">=p99", ">=p99.9", "max"};
+    const double ratio[] = {0., 0.5, 0.99, 0.999, 1.};
+
+    if (list.size() == 0) {
+      continue;
+    }
+
+    std::sort(list.begin(), list.end(),
+              [](const Breakdown &a, const Breakdown &b) -> bool {
+                return a.total < b.total;
+              });
+
+    printf("%s: %zu requests, mean latency in us\n",
+           getTraceName((TRACE_ID)list.front().type), list.size());
+    printf("  %-8s %9s %10s", "group", "count", "total");
+
+    for (int p = 0; p < PART_NUM; p++) {
+      printf(" %10s", partName[p]);
+
+      if (p == PART_PAL_WAIT) {
+        printf(" %10s", "(gc)");
+      }
+    }
+
+    printf("\n");
+
+    for (int r = 0; r < 5; r++) {
+      uint64_t begin = (uint64_t)(ratio[r] * list.size());
+
+      begin = std::min(begin, (uint64_t)list.size() - 1);
+
+      printRow(name[r], list, begin);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,487 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "hil/hil.hh"
+#include "igl/request_generator.hh"
+#include "sim/engine.hh"
+
+using namespace SimpleSSD;
+
+typedef struct {
+  std::string name;
+  std::string configPath;
+  std::string jobPath;
+
+  // Results
+  double setupTime;  //!< Host time spent on building SSD (including fill)
+  double hostTime;   //!< Host time spent on running workload
+  uint64_t simTime;
+  uint64_t eventCount;
+  uint64_t requestCount;
+  uint64_t peakRSS;  //!< In KB, zero if not available
+} PerfCase;
+
+const char csvHeader[] =
+    "name,setup_sec,host_sec,sim_sec,events,requests,iops_per_host_sec,"
+    "peak_rss_kb";
+
+// Differences of host time smaller than this are noise, not regression
+const double minTimeDiff = 0.1;
+
+void usage(const char *name) {
+  std::cerr
+      << "Usage: " << name << " [options] [suite file]\n"
+      << "Run end-to-end benchmark suite (default: bench/suite.txt), and "
+         "compare\nsimulator speed and memory usage with baseline.\n\n"
+      << "Options:\n"
+      << "  -r <dir>    Root of source tree, paths in suite file are "
+         "relative to it\n"
+      << "              (default: .)\n"
+      << "  -f <name>   Run only cases whose name contains <name>\n"
+      << "  -b <file>   Compare with baseline CSV written by -o, exit with "
+         "2 when\n"
+      << "              host time or peak RSS of any case exceeds baseline "
+         "times\n"
+      << "              tolerance\n"
+      << "  -x <ratio>  Tolerance of -b (default: 1.5)\n"
+      << "  -o <file>   Write results as CSV\n";
+}
+
+std::string getBaseName(std::string path) {
+  auto slash = path.find_last_of("/\\");
+  auto dot = path.find_last_of('.');
+
+  if (slash == std::string::npos) {
+    slash = 0;
+  }
+  else {
+    slash++;
+  }
+
+  if (dot == std::string::npos || dot < slash) {
+    dot = path.length();
+  }
+
+  return path.substr(slash, dot - slash);
+}
+
+bool loadSuite(std::string path, std::string root,
+               std::vector<PerfCase> &list) {
+  std::ifstream file(path);
+  std::string line;
+
+  if (!file.is_open()) {
+    return false;
+  }
+
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    PerfCase item;
+
+    if (!(iss >> item.configPath) || item.configPath[0] == '#') {
+      continue;
+    }
+
+    if (!(iss >> item.jobPath)) {
+      std::cerr << "Missing job file in " << path << ": " << line
+                << std::endl;
+
+      return false;
+    }
+
+    item.name = getBaseName(item.configPath) + "/" + getBaseName(item.jobPath);
+    item.configPath = root + "/" + item.configPath;
+    item.jobPath = root + "/" + item.jobPath;
+
+    list.push_back(item);
+  }
+
+  return true;
+}
+
+bool loadBaseline(std::string path,
+                  std::unordered_map<std::string, PerfCase> &baseline) {
+  std::ifstream file(path);
+  std::string line;
+  bool header = false;
+
+  if (!file.is_open()) {
+    return false;
+  }
+
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string token[8];
+    PerfCase item;
+    int i = 0;
+
+    if (line.length() == 0 || line[0] == '#') {
+      continue;
+    }
+
+    // First line other than comment is header
+    if (!header) {
+      if (line != csvHeader) {
+        return false;
+      }
+
+      header = true;
+
+      continue;
+    }
+
+    while (i < 8 && std::getline(iss, token[i], ',')) {
+      i++;
+    }
+
+    if (i != 8) {
+      return false;
+    }
+
+    item.name = token[0];
+    item.setupTime = strtod(token[1].c_str(), nullptr);
+    item.hostTime = strtod(token[2].c_str(), nullptr);
+    item.simTime = (uint64_t)(strtod(token[3].c_str(), nullptr) * 1e12);
+    item.eventCount = strtoull(token[4].c_str(), nullptr, 10);
+    item.requestCount = strtoull(token[5].c_str(), nullptr, 10);
+    item.peakRSS = strtoull(token[7].c_str(), nullptr, 10);
+
+    baseline[item.name] = item;
+  }
+
+  return true;
+}
+
+/**
+ * Peak RSS is process wide. On Linux, writing 5 to /proc/self/clear_refs
+ * resets it (VmHWM) to current RSS, so each case gets its own peak once
+ * memory freed by previous case is returned to system.
+ */
+void resetPeakRSS() {
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+
+#ifdef __linux__
+  std::ofstream file("/proc/self/clear_refs");
+
+  if (file.is_open()) {
+    file << "5" << std::endl;
+  }
+#endif
+}
+
+uint64_t getPeakRSS() {
+  uint64_t value = 0;
+
+#ifdef __linux__
+  std::ifstream file("/proc/self/status");
+  std::string line;
+
+  while (std::getline(file, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      value = strtoull(line.c_str() + 6, nullptr, 10);
+
+      break;
+    }
+  }
+#endif
+
+  return value;
+}
+
+bool runCase(PerfCase &item) {
+  std::vector<IGL::JobParam> jobs;
+  std::vector<IGL::RequestGenerator *> generators;
+  IGL::IOStatistics total;
+  uint32_t running = 0;
+
+  if (!IGL::loadJobFile(item.jobPath, jobs)) {
+    std::cerr << "Failed to load job file " << item.jobPath << std::endl;
+
+    return false;
+  }
+
+  resetPeakRSS();
+
+  auto setup = std::chrono::steady_clock::now();
+
+  Context context;
+  EventEngine engine;
+  ConfigReader conf = initSimpleSSDEngine(&context, &engine, nullptr,
+                                          &std::cerr, item.configPath);
+
+  HIL::HIL *pHIL = new HIL::HIL(conf);
+  IGL::BlockIO *pIO = new IGL::BlockIO(pHIL);
+
+  for (auto &job : jobs) {
+    generators.push_back(new IGL::RequestGenerator(*pIO, job));
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed = begin - setup;
+
+  item.setupTime = elapsed.count();
+
+  running = generators.size();
+
+  for (auto &iter : generators) {
+    iter->begin([&engine, &running]() {
+      if (--running == 0) {
+        engine.stop();
+      }
+    });
+  }
+
+  if (running > 0) {
+    engine.run();
+  }
+
+  elapsed = std::chrono::steady_clock::now() - begin;
+
+  item.hostTime = elapsed.count();
+  item.simTime = engine.getCurrentTick();
+  item.eventCount = engine.getEventCount();
+  item.peakRSS = getPeakRSS();
+
+  for (auto &iter : generators) {
+    total.merge(iter->getStatistics());
+  }
+
+  item.requestCount = total.getCount();
+
+  releaseSimpleSSDEngine();
+
+  for (auto &iter : generators) {
+    delete iter;
+  }
+
+  delete pIO;
+  delete pHIL;
+
+  setContext(nullptr);
+
+  return true;
+}
+
+bool exceeds(double value, double base, double tolerance, double minDiff) {
+  return value > base * tolerance && value - base > minDiff;
+}
+
+// Ratio to baseline, marked with ! when it exceeds tolerance
+std::string compare(double value, double base, bool regressed) {
+  std::ostringstream oss;
+
+  if (base > 0.) {
+    oss << std::fixed << std::setprecision(2) << value / base << "x";
+  }
+  else {
+    oss << "-";
+  }
+
+  if (regressed) {
+    oss << "!";
+  }
+
+  return oss.str();
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<PerfCase> list;
+  std::unordered_map<std::string, PerfCase> baseline;
+  std::string suitePath = "bench/suite.txt";
+  std::string root = ".";
+  std::string filter;
+  std::string baselinePath;
+  std::string outPath;
+  std::ofstream outFile;
+  double tolerance = 1.5;
+  uint32_t regressions = 0;
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+
+    if (opt[0] != '-' || opt[1] == 0 || opt[2] != 0) {
+      break;
+    }
+
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+
+      return 1;
+    }
+
+    const char *arg = argv[++i];
+
+    switch (opt[1]) {
+      case 'r':
+        root = arg;
+        break;
+      case 'f':
+        filter = arg;
+        break;
+      case 'b':
+        baselinePath = arg;
+        break;
+      case 'x':
+        tolerance = strtod(arg, nullptr);
+        break;
+      case 'o':
+        outPath = arg;
+        break;
+      default:
+        usage(argv[0]);
+
+        return 1;
+    }
+  }
+
+  if (argc - i > 1) {
+    usage(argv[0]);
+
+    return 1;
+  }
+
+  if (argc - i == 1) {
+    suitePath = argv[i];
+  }
+  else {
+    suitePath = root + "/" + suitePath;
+  }
+
+  if (!loadSuite(suitePath, root, list)) {
+    std::cerr << "Failed to load suite file " << suitePath << std::endl;
+
+    return 1;
+  }
+
+  if (baselinePath.length() > 0 && !loadBaseline(baselinePath, baseline)) {
+    std::cerr << "Failed to load baseline " << baselinePath << std::endl;
+
+    return 1;
+  }
+
+  if (outPath.length() > 0) {
+    outFile.open(outPath);
+
+    if (!outFile.is_open()) {
+      std::cerr << "Failed to open output file " << outPath << std::endl;
+
+      return 1;
+    }
+
+    outFile << csvHeader << std::endl;
+  }
+
+  std::cout << std::left << std::setw(28) << "Case" << std::right
+            << std::setw(9) << "setup(s)" << std::setw(9) << "run(s)"
+            << std::setw(10) << "events" << std::setw(12) << "IOPS/host-s"
+            << std::setw(10) << "RSS(MB)";
+
+  if (baseline.size() > 0) {
+    std::cout << std::setw(9) << "setup" << std::setw(9) << "run"
+              << std::setw(9) << "RSS";
+  }
+
+  std::cout << std::endl;
+
+  for (auto &item : list) {
+    if (filter.length() > 0 &&
+        item.name.find(filter) == std::string::npos) {
+      continue;
+    }
+
+    if (!runCase(item)) {
+      return 1;
+    }
+
+    double iops = item.requestCount / item.hostTime;
+
+    std::cout << std::left << std::setw(28) << item.name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(9)
+              << item.setupTime << std::setw(9) << item.hostTime
+              << std::setw(10) << item.eventCount << std::setw(12)
+              << std::setprecision(0) << iops << std::setw(10)
+              << item.peakRSS / 1024;
+
+    auto iter = baseline.find(item.name);
+
+    if (iter != baseline.end()) {
+      auto &base = iter->second;
+      bool setup = exceeds(item.setupTime, base.setupTime, tolerance,
+                           minTimeDiff);
+      bool run =
+          exceeds(item.hostTime, base.hostTime, tolerance, minTimeDiff);
+      bool rss = exceeds((double)item.peakRSS, (double)base.peakRSS,
+                         tolerance, 0.);
+
+      std::cout << std::setw(9)
+                << compare(item.setupTime, base.setupTime, setup)
+                << std::setw(9) << compare(item.hostTime, base.hostTime, run)
+                << std::setw(9)
+                << compare((double)item.peakRSS, (double)base.peakRSS, rss);
+
+      if (setup || run || rss) {
+        regressions++;
+      }
+
+      // Same workload on same model should produce same events
+      if (item.eventCount != base.eventCount) {
+        std::cout << "  (events changed from " << base.eventCount << ")";
+      }
+    }
+    else if (baseline.size() > 0) {
+      std::cout << "  (no baseline)";
+    }
+
+    std::cout << std::endl;
+
+    if (outFile.is_open()) {
+      outFile << item.name << "," << item.setupTime << "," << item.hostTime
+              << "," << item.simTime / 1e12 << "," << item.eventCount << ","
+              << item.requestCount << "," << iops << "," << item.peakRSS
+              << std::endl;
+    }
+  }
+
+  if (regressions > 0) {
+    std::cout << regressions << " case(s) exceeded " << std::setprecision(2)
+              << tolerance
+              << "x of baseline" << std::endl;
+
+    return 2;
+  }
+
+  return 0;
+}
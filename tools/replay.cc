@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "hil/hil.hh"
+#include "igl/stat_sampler.hh"
+#include "igl/trace_replayer.hh"
+#include "sim/engine.hh"
+#include "sim/log.hh"
+#include "sim/profile.hh"
+#include "sim/request_trace.hh"
+
+using namespace SimpleSSD;
+
+void usage(const char *name) {
+  std::cerr
+      << "Usage: " << name << " [options] <config file> <trace file>\n"
+      << "Replay block trace directly on HIL of SimpleSSD.\n\n"
+      << "Options:\n"
+      << "  -f <format>  Trace format: blkparse (default), msr, spc\n"
+      << "  -m <mode>    Issue model: open (default, use timestamp), "
+         "closed\n"
+      << "  -q <depth>   Maximum outstanding requests (default: 32)\n"
+      << "  -t <scale>   Multiply inter-arrival time of open-loop (default: "
+         "1.0)\n"
+      << "  -n <count>   Replay only first <count> requests\n"
+      << "  -a <action>  blkparse action to replay (default: D)\n"
+      << "  -s <file>    Write statistics of SimpleSSD to file\n"
+      << "  -S <file>    Write all statistics periodically, CSV if <file> "
+         "ends with .csv\n"
+      << "               (binary otherwise, convert with "
+         "simplessd-statdecode)\n"
+      << "  -i <us>      Interval of -S in simulated microseconds (default: "
+         "1000)\n"
+      << "  -H <file>    Write latency histogram of host and HIL to file\n"
+      << "  -l <file>    Write debug log to file\n"
+      << "  -d <list>    Components of debug log, comma separated (default: "
+         "all)\n"
+      << "  -b <file>    Write debug log in binary format, decode with "
+         "simplessd-logdecode\n"
+      << "  -T <file>    Write request lifecycle trace, analyze with "
+         "simplessd-breakdown\n"
+      << "  -P <file>    Write host time profile of each layer to file\n"
+      << "  -R <file>    Restore SSD state from checkpoint before replay\n"
+      << "  -C <file>    Write checkpoint of SSD state after replay\n";
+}
+
+int main(int argc, char *argv[]) {
+  IGL::ReplayParam param;
+  std::string configPath;
+  std::string tracePath;
+  std::string statPath;
+  std::string seriesPath;
+  std::string histPath;
+  std::string logPath;
+  std::string binLogPath;
+  std::string reqTracePath;
+  std::string profilePath;
+  std::string memoryPath;
+  std::string restorePath;
+  std::string checkpointPath;
+  std::ofstream logFile;
+  std::ofstream binLogFile;
+  std::ofstream reqTraceFile;
+  std::ofstream profileFile;
+  std::ofstream seriesFile;
+  uint64_t sampleInterval = 1000;
+  bool seriesCSV = false;
+  uint64_t logMask = ~0ull;
+  std::vector<ConfigOverride> overrides;
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+
+    if (opt[0] != '-' || opt[1] == 0 || opt[2] != 0) {
+      break;
+    }
+
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+
+      return 1;
+    }
+
+    const char *arg = argv[++i];
+
+    switch (opt[1]) {
+      case 'f':
+        if (strcmp(arg, "blkparse") == 0) {
+          param.format = IGL::TRACE_BLKPARSE;
+        }
+        else if (strcmp(arg, "msr") == 0) {
+          param.format = IGL::TRACE_MSR;
+        }
+        else if (strcmp(arg, "spc") == 0) {
+          param.format = IGL::TRACE_SPC;
+        }
+        else {
+          std::cerr << "Unknown trace format " << arg << std::endl;
+
+          return 1;
+        }
+
+        break;
+      case 'm':
+        if (strcmp(arg, "open") == 0) {
+          param.mode = IGL::ISSUE_OPEN_LOOP;
+        }
+        else if (strcmp(arg, "closed") == 0) {
+          param.mode = IGL::ISSUE_CLOSED_LOOP;
+        }
+        else {
+          std::cerr << "Unknown issue model " << arg << std::endl;
+
+          return 1;
+        }
+
+        break;
+      case 'q':
+        param.queueDepth = (uint32_t)strtoul(arg, nullptr, 10);
+        break;
+      case 't':
+        param.timeScale = strtod(arg, nullptr);
+        break;
+      case 'n':
+        param.maxCount = strtoull(arg, nullptr, 10);
+        break;
+      case 'a':
+        param.blkparseAction = arg[0];
+        break;
+      case 's':
+        statPath = arg;
+        break;
+      case 'S':
+        seriesPath = arg;
+        break;
+      case 'i':
+        sampleInterval = strtoull(arg, nullptr, 10);
+
+        if (sampleInterval == 0) {
+          std::cerr << "Sampling interval should be larger than zero"
+                    << std::endl;
+
+          return 1;
+        }
+
+        break;
+      case 'H':
+        histPath = arg;
+        break;
+      case 'l':
+        logPath = arg;
+        break;
+      case 'd':
+        if (!parseLogMask(arg, logMask)) {
+          std::cerr << "Unknown debug log component in " << arg << std::endl;
+
+          return 1;
+        }
+
+        break;
+      case 'b':
+        binLogPath = arg;
+        break;
+      case 'T':
+        reqTracePath = arg;
+        break;
+      case 'P':
+        profilePath = arg;
+        break;
+      case 'M':
+        memoryPath = arg;
+        break;
+      case 'R':
+        restorePath = arg;
+        break;
+      case 'C':
+        checkpointPath = arg;
+        break;
+      default:
+        usage(argv[0]);
+
+        return 1;
+    }
+  }
+
+  if (argc - i != 2) {
+    usage(argv[0]);
+
+    return 1;
+  }
+
+  configPath = argv[i];
+  tracePath = argv[i + 1];
+
+  if (logPath.length() > 0) {
+    logFile.open(logPath);
+
+    if (!logFile.is_open()) {
+      std::cerr << "Failed to open log file " << logPath << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (binLogPath.length() > 0) {
+    binLogFile.open(binLogPath, std::ios::binary);
+
+    if (!binLogFile.is_open()) {
+      std::cerr << "Failed to open binary log file " << binLogPath
+                << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (reqTracePath.length() > 0) {
+    reqTraceFile.open(reqTracePath, std::ios::binary);
+
+    if (!reqTraceFile.is_open()) {
+      std::cerr << "Failed to open request trace file " << reqTracePath
+                << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (profilePath.length() > 0) {
+    profileFile.open(profilePath);
+
+    if (!profileFile.is_open()) {
+      std::cerr << "Failed to open profile file " << profilePath << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (seriesPath.length() > 0) {
+    seriesCSV = seriesPath.length() >= 4 &&
+                seriesPath.compare(seriesPath.length() - 4, 4, ".csv") == 0;
+    seriesFile.open(seriesPath, seriesCSV ? std::ios::out : std::ios::binary);
+
+    if (!seriesFile.is_open()) {
+      std::cerr << "Failed to open statistics series file " << seriesPath
+                << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (restorePath.length() > 0) {
+    // Drive is preconditioned by checkpoint, skip filling at initialization
+    overrides.push_back({"ftl", "FillRatio", "0"});
+    overrides.push_back({"ftl", "InvalidPageRatio", "0"});
+  }
+
+  EventEngine engine;
+  ConfigReader conf = initSimpleSSDEngine(
+      nullptr, &engine, logFile.is_open() ? &logFile : nullptr, &std::cerr,
+      configPath, overrides);
+
+  if (binLogFile.is_open()) {
+    initBinaryLog(&binLogFile);
+  }
+
+  setLogMask(logMask);
+
+  if (profileFile.is_open()) {
+    initProfiler(&profileFile);
+  }
+
+  HIL::HIL *pHIL = new HIL::HIL(conf);
+  IGL::BlockIO *pIO = new IGL::BlockIO(pHIL);
+
+  if (restorePath.length() > 0) {
+    std::ifstream in(restorePath, std::ios::binary);
+    uint64_t tick;
+
+    if (!in.is_open() || !readCheckpointHeader(in, tick)) {
+      std::cerr << "Failed to read checkpoint " << restorePath << std::endl;
+
+      return 1;
+    }
+
+    engine.setCurrentTick(tick);
+    pHIL->loadState(in);
+  }
+
+  // Start after HIL is built, so initialization is not traced
+  if (reqTraceFile.is_open()) {
+    initRequestTrace(&reqTraceFile);
+  }
+
+  IGL::TraceReplayer *pReplayer =
+      new IGL::TraceReplayer(*pIO, param, tracePath);
+
+  IGL::StatSampler *pSampler = nullptr;
+
+  if (seriesFile.is_open()) {
+    // Interval is in micro-second, and tick is in pico-second
+    pSampler = new IGL::StatSampler(*pIO, seriesFile, !seriesCSV,
+                                    sampleInterval * 1000000);
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+
+  if (pSampler) {
+    pSampler->begin();
+  }
+
+  pReplayer->begin([&engine]() { engine.stop(); });
+  engine.run();
+
+  if (pSampler) {
+    pSampler->end();
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  std::cout << "Replayed " << pReplayer->getIssuedCount() << " requests in "
+            << elapsed.count() << " s (host), "
+            << engine.getCurrentTick() / 1000000000000. << " s (simulated), "
+            << engine.getEventCount() << " events" << std::endl;
+
+  pReplayer->getStatistics().print(std::cout);
+
+  if (checkpointPath.length() > 0) {
+    std::ofstream out(checkpointPath, std::ios::binary);
+
+    if (!out.is_open()) {
+      std::cerr << "Failed to open checkpoint file " << checkpointPath
+                << std::endl;
+    }
+    else {
+      writeCheckpointHeader(out, engine.getCurrentTick());
+      pHIL->saveState(out);
+    }
+  }
+
+  if (histPath.length() > 0) {
+    std::ofstream histFile(histPath);
+
+    if (!histFile.is_open()) {
+      std::cerr << "Failed to open histogram file " << histPath << std::endl;
+    }
+    else {
+      pReplayer->getStatistics().printHistogram(histFile, "host.");
+      pHIL->printHistogram(histFile, "hil.");
+    }
+  }
+
+  if (statPath.length() > 0) {
+    std::ofstream statFile(statPath);
+
+    if (!statFile.is_open()) {
+      std::cerr << "Failed to open statistic file " << statPath << std::endl;
+    }
+    else {
+      pIO->printStats(statFile);
+    }
+  }
+
+  if (memoryPath.length() > 0) {
+    std::ofstream memoryFile(memoryPath);
+
+    if (!memoryFile.is_open()) {
+      std::cerr << "Failed to open memory usage file " << memoryPath
+                << std::endl;
+    }
+    else {
+      pIO->printMemoryUsage(memoryFile);
+    }
+  }
+
+  releaseSimpleSSDEngine();
+
+  delete pReplayer;
+  delete pSampler;
+  delete pIO;
+  delete pHIL;
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include "igl/stat_sampler.hh"
+
+using namespace SimpleSSD;
+
+void usage(const char *name) {
+  std::cerr << "Usage: " << name << " <binary series file> [output file]\n"
+            << "Convert binary statistics time series of SimpleSSD to CSV.\n";
+}
+
+int main(int argc, char *argv[]) {
+  std::ofstream outFile;
+  std::ostream *out = &std::cout;
+
+  if (argc != 2 && argc != 3) {
+    usage(argv[0]);
+
+    return 1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+
+  if (!in.is_open()) {
+    std::cerr << "Failed to open binary series file " << argv[1] << std::endl;
+
+    return 1;
+  }
+
+  if (argc == 3) {
+    outFile.open(argv[2]);
+
+    if (!outFile.is_open()) {
+      std::cerr << "Failed to open output file " << argv[2] << std::endl;
+
+      return 1;
+    }
+
+    out = &outFile;
+  }
+
+  if (!IGL::decodeStatSeries(in, *out)) {
+    std::cerr << "Failed to decode " << argv[1]
+              << ": not a statistics series or truncated" << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
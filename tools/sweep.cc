@@ -0,0 +1,563 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "hil/hil.hh"
+#include "igl/request_generator.hh"
+#include "igl/trace_replayer.hh"
+#include "sim/engine.hh"
+#include "sim/log.hh"
+#include "util/thread_pool.hh"
+
+using namespace SimpleSSD;
+
+typedef struct {
+  std::vector<ConfigOverride> overrides;
+
+  // Results
+  double setupTime;  //!< Host time spent on building SSD (including fill)
+  double hostTime;   //!< Host time spent on running workload
+  uint64_t simTime;
+  uint64_t eventCount;
+  std::vector<Stats> list;
+  std::vector<double> values;
+} SweepPoint;
+
+typedef struct {
+  std::string configPath;
+  std::string workloadPath;
+  std::string logDir;
+
+  bool useTrace;
+  IGL::ReplayParam replayParam;
+  std::vector<IGL::JobParam> jobs;
+} SweepParam;
+
+void usage(const char *name) {
+  std::cerr
+      << "Usage: " << name
+      << " [options] <config file> <job file | trace file>\n"
+      << "Run workload on every configuration point of parameter sweep, and "
+         "merge\nstatistics of all points into one CSV table.\n\n"
+      << "Options:\n"
+      << "  -g <key>=<v1>,<v2>,...  Add sweep axis. Key is <Section>.<Name>, "
+         "ex)\n"
+      << "                          FTL.OverProvisioningRatio. Points are "
+         "cartesian\n"
+      << "                          product of all axes\n"
+      << "  -p <file>  Add points from file, one point per line as\n"
+      << "             <key>=<value> pairs separated by space\n"
+      << "  -j <count> Number of worker threads (default: number of CPUs)\n"
+      << "  -t <format>  Workload is block trace of given format (blkparse, "
+         "msr,\n"
+      << "               spc), replayed in closed loop\n"
+      << "  -q <depth>   Queue depth of trace replay (default: 32)\n"
+      << "  -o <file>  Write CSV to file (default: stdout)\n"
+      << "  -l <dir>   Write debug log of each point to <dir>/<point>.log\n";
+}
+
+bool parseOverride(std::string str, ConfigOverride &item) {
+  auto dot = str.find('.');
+  auto equal = str.find('=');
+
+  if (dot == std::string::npos || equal == std::string::npos || dot == 0 ||
+      equal < dot + 2) {
+    return false;
+  }
+
+  item.section = str.substr(0, dot);
+  item.name = str.substr(dot + 1, equal - dot - 1);
+  item.value = str.substr(equal + 1);
+
+  // Section names in configuration file are lower case
+  for (auto &iter : item.section) {
+    iter = (char)tolower(iter);
+  }
+
+  return true;
+}
+
+std::string getKey(ConfigOverride &item) {
+  return item.section + "." + item.name;
+}
+
+// Expand grid axes to points, last axis changes fastest
+void expandGrid(std::vector<std::vector<ConfigOverride>> &axes,
+                std::vector<SweepPoint> &points) {
+  std::vector<uint64_t> index(axes.size(), 0);
+
+  if (axes.size() == 0) {
+    return;
+  }
+
+  while (true) {
+    SweepPoint point;
+
+    for (uint64_t i = 0; i < axes.size(); i++) {
+      point.overrides.push_back(axes[i][index[i]]);
+    }
+
+    points.push_back(point);
+
+    uint64_t i = axes.size();
+
+    while (i > 0) {
+      i--;
+
+      if (++index[i] < axes[i].size()) {
+        break;
+      }
+
+      index[i] = 0;
+
+      if (i == 0) {
+        return;
+      }
+    }
+  }
+}
+
+bool loadPointFile(std::string path, std::vector<SweepPoint> &points) {
+  std::ifstream file(path);
+  std::string line;
+
+  if (!file.is_open()) {
+    return false;
+  }
+
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string token;
+    SweepPoint point;
+
+    while (iss >> token) {
+      ConfigOverride item;
+
+      if (token[0] == '#') {
+        break;
+      }
+
+      if (!parseOverride(token, item)) {
+        std::cerr << "Invalid override " << token << " in " << path
+                  << std::endl;
+
+        return false;
+      }
+
+      point.overrides.push_back(item);
+    }
+
+    if (point.overrides.size() > 0) {
+      points.push_back(point);
+    }
+  }
+
+  return true;
+}
+
+void runPoint(SweepParam &param, SweepPoint &point, uint64_t id,
+              std::ostream &err) {
+  std::vector<IGL::RequestGenerator *> generators;
+  IGL::TraceReplayer *pReplayer = nullptr;
+  IGL::IOStatistics total;
+  std::ofstream logFile;
+  uint32_t running = 0;
+
+  if (param.logDir.length() > 0) {
+    logFile.open(param.logDir + "/" + std::to_string(id) + ".log");
+  }
+
+  auto setup = std::chrono::steady_clock::now();
+
+  Context context;
+  EventEngine engine;
+  ConfigReader conf = initSimpleSSDEngine(
+      &context, &engine, logFile.is_open() ? &logFile : nullptr, &err,
+      param.configPath, point.overrides);
+
+  HIL::HIL *pHIL = new HIL::HIL(conf);
+  IGL::BlockIO *pIO = new IGL::BlockIO(pHIL);
+
+  auto begin = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed = begin - setup;
+
+  point.setupTime = elapsed.count();
+
+  if (param.useTrace) {
+    pReplayer =
+        new IGL::TraceReplayer(*pIO, param.replayParam, param.workloadPath);
+
+    running = 1;
+    pReplayer->begin([&engine]() { engine.stop(); });
+  }
+  else {
+    for (auto &job : param.jobs) {
+      generators.push_back(new IGL::RequestGenerator(*pIO, job));
+    }
+
+    running = generators.size();
+
+    for (auto &iter : generators) {
+      iter->begin([&engine, &running]() {
+        if (--running == 0) {
+          engine.stop();
+        }
+      });
+    }
+  }
+
+  if (running > 0) {
+    engine.run();
+  }
+
+  elapsed = std::chrono::steady_clock::now() - begin;
+
+  point.hostTime = elapsed.count();
+  point.simTime = engine.getCurrentTick();
+  point.eventCount = engine.getEventCount();
+
+  if (pReplayer) {
+    total.merge(pReplayer->getStatistics());
+  }
+
+  for (auto &iter : generators) {
+    total.merge(iter->getStatistics());
+  }
+
+  total.getStatList(point.list, "host.");
+  total.getStatValues(point.values);
+  pIO->getStatList(point.list, "");
+  pIO->getStatValues(point.values);
+
+  releaseSimpleSSDEngine();
+
+  delete pReplayer;
+
+  for (auto &iter : generators) {
+    delete iter;
+  }
+
+  delete pIO;
+  delete pHIL;
+
+  setContext(nullptr);
+}
+
+std::string escapeCSV(std::string str) {
+  if (str.find_first_of(",\"\n") == std::string::npos) {
+    return str;
+  }
+
+  std::string ret = "\"";
+
+  for (auto iter : str) {
+    if (iter == '"') {
+      ret.push_back('"');
+    }
+
+    ret.push_back(iter);
+  }
+
+  ret.push_back('"');
+
+  return ret;
+}
+
+// Columns are union of all points, as statistic list depends on
+// configuration (ex. number of CPU cores)
+void writeCSV(std::ostream &os, std::vector<SweepPoint> &points) {
+  std::vector<std::string> keys;
+  std::vector<std::string> columns;
+  std::unordered_map<std::string, uint64_t> keyIndex;
+  std::unordered_map<std::string, uint64_t> columnIndex;
+
+  for (auto &point : points) {
+    for (auto &item : point.overrides) {
+      std::string key = getKey(item);
+
+      if (keyIndex.emplace(key, keys.size()).second) {
+        keys.push_back(key);
+      }
+    }
+
+    for (auto &stat : point.list) {
+      if (columnIndex.emplace(stat.name, columns.size()).second) {
+        columns.push_back(stat.name);
+      }
+    }
+  }
+
+  os << "point";
+
+  for (auto &iter : keys) {
+    os << "," << escapeCSV(iter);
+  }
+
+  os << ",setup_time,host_time,sim_time,event_count";
+
+  for (auto &iter : columns) {
+    os << "," << escapeCSV(iter);
+  }
+
+  os << std::endl;
+
+  for (uint64_t i = 0; i < points.size(); i++) {
+    auto &point = points[i];
+    std::vector<std::string> keyValue(keys.size());
+    std::vector<std::string> columnValue(columns.size());
+
+    for (auto &item : point.overrides) {
+      keyValue[keyIndex[getKey(item)]] = item.value;
+    }
+
+    for (uint64_t j = 0; j < point.list.size() && j < point.values.size();
+         j++) {
+      std::ostringstream oss;
+
+      oss << point.values[j];
+      columnValue[columnIndex[point.list[j].name]] = oss.str();
+    }
+
+    os << i;
+
+    for (auto &iter : keyValue) {
+      os << "," << escapeCSV(iter);
+    }
+
+    os << "," << point.setupTime << "," << point.hostTime << ","
+       << point.simTime / 1000000000000. << "," << point.eventCount;
+
+    for (auto &iter : columnValue) {
+      os << "," << iter;
+    }
+
+    os << std::endl;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  SweepParam param;
+  std::vector<std::vector<ConfigOverride>> axes;
+  std::vector<SweepPoint> points;
+  std::vector<std::string> pointFiles;
+  std::string outPath;
+  uint32_t threads = 0;
+  int i;
+
+  param.useTrace = false;
+  param.replayParam.mode = IGL::ISSUE_CLOSED_LOOP;
+
+  for (i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+
+    if (opt[0] != '-' || opt[1] == 0 || opt[2] != 0) {
+      break;
+    }
+
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+
+      return 1;
+    }
+
+    const char *arg = argv[++i];
+
+    switch (opt[1]) {
+      case 'g': {
+        std::string str(arg);
+        std::vector<ConfigOverride> axis;
+        ConfigOverride item;
+        auto equal = str.find('=');
+        uint64_t begin = equal + 1;
+
+        if (!parseOverride(str, item)) {
+          std::cerr << "Invalid sweep axis " << arg << std::endl;
+
+          return 1;
+        }
+
+        while (begin <= str.length()) {
+          auto end = str.find(',', begin);
+
+          if (end == std::string::npos) {
+            end = str.length();
+          }
+
+          item.value = str.substr(begin, end - begin);
+          axis.push_back(item);
+
+          begin = end + 1;
+        }
+
+        axes.push_back(axis);
+      } break;
+      case 'p':
+        pointFiles.push_back(arg);
+        break;
+      case 'j':
+        threads = (uint32_t)strtoul(arg, nullptr, 10);
+        break;
+      case 't':
+        param.useTrace = true;
+
+        if (strcmp(arg, "blkparse") == 0) {
+          param.replayParam.format = IGL::TRACE_BLKPARSE;
+        }
+        else if (strcmp(arg, "msr") == 0) {
+          param.replayParam.format = IGL::TRACE_MSR;
+        }
+        else if (strcmp(arg, "spc") == 0) {
+          param.replayParam.format = IGL::TRACE_SPC;
+        }
+        else {
+          std::cerr << "Unknown trace format " << arg << std::endl;
+
+          return 1;
+        }
+
+        break;
+      case 'q':
+        param.replayParam.queueDepth = (uint32_t)strtoul(arg, nullptr, 10);
+        break;
+      case 'o':
+        outPath = arg;
+        break;
+      case 'l':
+        param.logDir = arg;
+        break;
+      default:
+        usage(argv[0]);
+
+        return 1;
+    }
+  }
+
+  if (argc - i != 2) {
+    usage(argv[0]);
+
+    return 1;
+  }
+
+  param.configPath = argv[i];
+  param.workloadPath = argv[i + 1];
+
+  expandGrid(axes, points);
+
+  for (auto &iter : pointFiles) {
+    if (!loadPointFile(iter, points)) {
+      std::cerr << "Failed to load point file " << iter << std::endl;
+
+      return 1;
+    }
+  }
+
+  if (points.size() == 0) {
+    // Base configuration only
+    points.push_back(SweepPoint());
+  }
+
+  if (!param.useTrace && !IGL::loadJobFile(param.workloadPath, param.jobs)) {
+    std::cerr << "Failed to load job file " << param.workloadPath
+              << std::endl;
+
+    return 1;
+  }
+
+  // Validate all points before spending time on simulation. Configuration
+  // errors terminate whole process, so catch them here.
+  initLogSystem(nullptr, &std::cerr);
+
+  for (uint64_t j = 0; j < points.size(); j++) {
+    ConfigReader conf;
+
+    if (!conf.init(param.configPath, points[j].overrides)) {
+      std::cerr << "Invalid configuration at point " << j << std::endl;
+
+      return 1;
+    }
+  }
+
+  destroyLogSystem();
+
+  std::mutex errLock;
+  uint64_t finished = 0;
+  auto begin = std::chrono::steady_clock::now();
+
+  {
+    ThreadPool pool(threads);
+
+    std::cerr << "Running " << points.size() << " points on "
+              << pool.getThreadCount() << " threads" << std::endl;
+
+    for (uint64_t j = 0; j < points.size(); j++) {
+      pool.submit([&, j]() {
+        std::ostringstream err;
+
+        runPoint(param, points[j], j, err);
+
+        std::lock_guard<std::mutex> guard(errLock);
+
+        finished++;
+
+        std::cerr << "[" << finished << "/" << points.size() << "] point "
+                  << j << " done in "
+                  << points[j].setupTime + points[j].hostTime << " s"
+                  << std::endl;
+
+        // Warnings of one point are printed together
+        if (err.str().length() > 0) {
+          std::cerr << err.str();
+        }
+      });
+    }
+
+    pool.wait();
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  std::cerr << "Finished " << points.size() << " points in "
+            << elapsed.count() << " s" << std::endl;
+
+  if (outPath.length() > 0) {
+    std::ofstream outFile(outPath);
+
+    if (!outFile.is_open()) {
+      std::cerr << "Failed to open output file " << outPath << std::endl;
+
+      return 1;
+    }
+
+    writeCSV(outFile, points);
+  }
+  else {
+    writeCSV(std::cout, points);
+  }
+
+  return 0;
+}
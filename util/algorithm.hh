@@ -46,6 +46,16 @@ inline uint32_t __builtin_clzl(uint32_t val) {
   return 32;
 }
 
+inline uint32_t __builtin_clzll(uint64_t val) {
+  unsigned long leadingZero = 0;
+
+  if (_BitScanReverse64(&leadingZero, val)) {
+    return 63 - leadingZero;
+  }
+
+  return 64;
+}
+
 inline uint32_t __builtin_ffsl(uint32_t val) {
   unsigned long trailingZero = 0;
 
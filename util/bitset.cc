@@ -215,6 +215,19 @@ Bitset &Bitset::operator=(Bitset &&rhs) noexcept {
   return *this;
 }
 
+// Raw bits only, size is fixed by owner
+void Bitset::saveState(std::ostream &out) {
+  out.write((const char *)data, allocSize);
+}
+
+void Bitset::loadState(std::istream &in) {
+  in.read((char *)data, allocSize);
+
+  if (!in.good()) {
+    panic("Unexpected end of checkpoint");
+  }
+}
+
 Bitset Bitset::operator~() const {
   Bitset ret(*this);
 
@@ -23,6 +23,7 @@
 #define __UTIL_BITSET__
 
 #include <cinttypes>
+#include <iostream>
 #include <vector>
 
 #include "sim/trace.hh"
@@ -56,6 +57,9 @@ class Bitset {
   void flip() noexcept;
   void flip(uint32_t) noexcept;
 
+  void saveState(std::ostream &);
+  void loadState(std::istream &);
+
   bool operator[](uint32_t) noexcept;
   Bitset &operator&=(const Bitset &);
   Bitset &operator|=(const Bitset &);
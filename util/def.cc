@@ -35,6 +35,8 @@ Request::_Request()
       reqSubID(0),
       offset(0),
       length(0),
+      type(REQUEST_READ),
+      arrivedAt(0),
       finishedAt(0),
       context(nullptr) {}
 
@@ -43,6 +45,8 @@ Request::_Request(DMAFunction &f, void *c)
       reqSubID(0),
       offset(0),
       length(0),
+      type(REQUEST_READ),
+      arrivedAt(0),
       finishedAt(0),
       function(f),
       context(c) {}
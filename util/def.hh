@@ -39,6 +39,14 @@ typedef struct _LPNRange {
 
 namespace HIL {
 
+typedef enum : uint8_t {
+  REQUEST_READ,
+  REQUEST_WRITE,
+  REQUEST_FLUSH,
+  REQUEST_TRIM,
+  REQUEST_FORMAT,
+} REQUEST_TYPE;
+
 typedef struct _Request {
   uint64_t reqID;
   uint64_t reqSubID;
@@ -46,6 +54,8 @@ typedef struct _Request {
   uint64_t length;
   LPNRange range;
 
+  REQUEST_TYPE type;
+  uint64_t arrivedAt;
   uint64_t finishedAt;
   DMAFunction function;
   void *context;
@@ -28,6 +28,8 @@
 #include <unistd.h>
 #endif
 
+#include "util/memory.hh"
+
 namespace SimpleSSD {
 
 Disk::Disk() : diskSize(0), sectorSize(0) {}
@@ -182,6 +184,10 @@ uint16_t Disk::erase(uint64_t, uint16_t nlblk) {
   return nlblk;
 }
 
+uint64_t Disk::getMemoryUsage() {
+  return 0;
+}
+
 CoWDisk::CoWDisk() {}
 
 CoWDisk::~CoWDisk() {
@@ -236,6 +242,10 @@ uint16_t CoWDisk::write(uint64_t slba, uint16_t nlblk, uint8_t *buffer) {
   return write;
 }
 
+uint64_t CoWDisk::getMemoryUsage() {
+  return memoryUsage(table) + table.size() * allocationSize(sectorSize);
+}
+
 uint64_t MemDisk::open(std::string, uint64_t size, uint32_t lbaSize) {
   diskSize = size;
   sectorSize = lbaSize;
@@ -311,4 +321,8 @@ uint16_t MemDisk::erase(uint64_t slba, uint16_t nlblk) {
   return erase;
 }
 
+uint64_t MemDisk::getMemoryUsage() {
+  return memoryUsage(table) + table.size() * allocationSize(sectorSize);
+}
+
 }  // namespace SimpleSSD
@@ -49,6 +49,9 @@ class Disk {
   virtual uint16_t read(uint64_t, uint16_t, uint8_t *);
   virtual uint16_t write(uint64_t, uint16_t, uint8_t *);
   virtual uint16_t erase(uint64_t, uint16_t);
+
+  //! Host memory used by disk image (zero when image is a file)
+  virtual uint64_t getMemoryUsage();
 };
 
 class CoWDisk : public Disk {
@@ -64,6 +67,8 @@ class CoWDisk : public Disk {
 
   uint16_t read(uint64_t, uint16_t, uint8_t *) override;
   uint16_t write(uint64_t, uint16_t, uint8_t *) override;
+
+  uint64_t getMemoryUsage() override;
 };
 
 class MemDisk : public Disk {
@@ -81,6 +86,8 @@ class MemDisk : public Disk {
   uint16_t read(uint64_t, uint16_t, uint8_t *) override;
   uint16_t write(uint64_t, uint16_t, uint8_t *) override;
   uint16_t erase(uint64_t, uint16_t) override;
+
+  uint64_t getMemoryUsage() override;
 };
 
 }  // namespace SimpleSSD
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/histogram.hh"
+
+#include <iomanip>
+
+#include "sim/trace.hh"
+#include "util/algorithm.hh"
+
+namespace SimpleSSD {
+
+Histogram::Histogram(uint32_t bits) : subBits(bits) {
+  if (subBits < 1 || subBits > 16) {
+    panic("Invalid sub-bucket bits of histogram");
+  }
+
+  reset();
+}
+
+uint32_t Histogram::getIndex(uint64_t value) {
+  uint32_t msb;
+  uint32_t shift;
+
+  if (value < (1ull << subBits)) {
+    return (uint32_t)value;
+  }
+
+  msb = 63 - __builtin_clzll(value);
+  shift = msb - subBits + 1;
+
+  return (shift << (subBits - 1)) + (uint32_t)(value >> shift);
+}
+
+uint64_t Histogram::getLowerBound(uint32_t index) {
+  uint32_t shift;
+
+  if (index < (1u << subBits)) {
+    return index;
+  }
+
+  shift = (index >> (subBits - 1)) - 1;
+
+  return (uint64_t)(index - (shift << (subBits - 1))) << shift;
+}
+
+uint64_t Histogram::getUpperBound(uint32_t index) {
+  uint32_t shift;
+
+  if (index < (1u << subBits)) {
+    return index;
+  }
+
+  shift = (index >> (subBits - 1)) - 1;
+
+  return getLowerBound(index) + ((1ull << shift) - 1);
+}
+
+void Histogram::add(uint64_t value, uint64_t n) {
+  uint32_t index = getIndex(value);
+
+  if (index >= buckets.size()) {
+    buckets.resize(index + 1, 0);
+  }
+
+  buckets[index] += n;
+  count += n;
+  sum += (double)value * n;
+  minValue = MIN(minValue, value);
+  maxValue = MAX(maxValue, value);
+}
+
+void Histogram::merge(const Histogram &rhs) {
+  if (subBits != rhs.subBits) {
+    panic("Cannot merge histograms with different precision");
+  }
+
+  if (rhs.buckets.size() > buckets.size()) {
+    buckets.resize(rhs.buckets.size(), 0);
+  }
+
+  for (uint32_t i = 0; i < rhs.buckets.size(); i++) {
+    buckets[i] += rhs.buckets[i];
+  }
+
+  count += rhs.count;
+  sum += rhs.sum;
+  minValue = MIN(minValue, rhs.minValue);
+  maxValue = MAX(maxValue, rhs.maxValue);
+}
+
+void Histogram::reset() {
+  buckets.clear();
+
+  count = 0;
+  minValue = UINT64_MAX;
+  maxValue = 0;
+  sum = 0.;
+}
+
+uint64_t Histogram::getCount() {
+  return count;
+}
+
+uint64_t Histogram::getMin() {
+  return count > 0 ? minValue : 0;
+}
+
+uint64_t Histogram::getMax() {
+  return maxValue;
+}
+
+double Histogram::getMean() {
+  return count > 0 ? sum / count : 0.;
+}
+
+/**
+ * Return value at given percentile (0 ~ 100). As values in one bucket are
+ * not distinguishable, upper bound of bucket is returned (never larger than
+ * maximum value recorded).
+ */
+uint64_t Histogram::getPercentile(double percentile) {
+  uint64_t target;
+  uint64_t acc = 0;
+
+  if (count == 0) {
+    return 0;
+  }
+
+  target = (uint64_t)ceil(percentile / 100. * count);
+  target = MAX(target, 1);
+  target = MIN(target, count);
+
+  for (uint32_t i = 0; i < buckets.size(); i++) {
+    acc += buckets[i];
+
+    if (acc >= target) {
+      return MIN(getUpperBound(i), maxValue);
+    }
+  }
+
+  return maxValue;
+}
+
+/**
+ * Print all non-empty buckets as
+ * <lower bound> <upper bound> <count> <cumulative ratio>
+ * Values are divided by unit.
+ */
+void Histogram::print(std::ostream &os, double unit) {
+  uint64_t acc = 0;
+
+  for (uint32_t i = 0; i < buckets.size(); i++) {
+    if (buckets[i] == 0) {
+      continue;
+    }
+
+    acc += buckets[i];
+
+    os << std::setw(16) << getLowerBound(i) / unit << " " << std::setw(16)
+       << getUpperBound(i) / unit << " " << std::setw(12) << buckets[i] << " "
+       << std::setw(10) << (double)acc / count << std::endl;
+  }
+}
+
+void Histogram::saveState(std::ostream &out) {
+  pushValue(out, (uint64_t)subBits);
+  pushVector(out, buckets);
+  pushValue(out, count);
+  pushValue(out, minValue);
+  pushValue(out, maxValue);
+  pushValue(out, sum);
+}
+
+void Histogram::loadState(std::istream &in) {
+  checkValue(in, subBits, "histogram precision");
+  popVector(in, buckets);
+  popValue(in, count);
+  popValue(in, minValue);
+  popValue(in, maxValue);
+  popValue(in, sum);
+}
+
+}  // namespace SimpleSSD
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __UTIL_HISTOGRAM__
+#define __UTIL_HISTOGRAM__
+
+#include <cinttypes>
+#include <iostream>
+#include <vector>
+
+#include "sim/state.hh"
+
+namespace SimpleSSD {
+
+/**
+ * \brief Log-bucketed histogram
+ *
+ * HDR-style histogram of uint64_t values. Values below 2^subBits are counted
+ * exactly. Above that, each power-of-two range is divided into 2^(subBits-1)
+ * linear sub-buckets, so relative error is below 2^-(subBits-1) regardless of
+ * magnitude. Adding a value is O(1) without allocation (except growth of
+ * bucket array for new maximum magnitude).
+ */
+class Histogram : public StateObject {
+ private:
+  uint32_t subBits;
+  std::vector<uint64_t> buckets;
+
+  uint64_t count;
+  uint64_t minValue;
+  uint64_t maxValue;
+  double sum;
+
+  uint32_t getIndex(uint64_t);
+  uint64_t getLowerBound(uint32_t);
+  uint64_t getUpperBound(uint32_t);
+
+ public:
+  Histogram(uint32_t = 8);
+
+  void add(uint64_t, uint64_t = 1);
+  void merge(const Histogram &);
+  void reset();
+
+  uint64_t getCount();
+  uint64_t getMin();
+  uint64_t getMax();
+  double getMean();
+  uint64_t getPercentile(double);
+
+  void print(std::ostream &, double = 1.);
+
+  void saveState(std::ostream &) override;
+  void loadState(std::istream &) override;
+};
+
+}  // namespace SimpleSSD
+
+#endif
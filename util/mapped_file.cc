@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "util/mapped_file.hh"
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SimpleSSD {
+
+MappedFile::MappedFile()
+    : data(nullptr),
+      size(0)
+#ifdef _MSC_VER
+      ,
+      hFile(INVALID_HANDLE_VALUE),
+      hMapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(std::string path) {
+  close();
+
+#ifdef _MSC_VER
+  LARGE_INTEGER fileSize;
+
+  hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if (hFile == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+    close();
+
+    return false;
+  }
+
+  hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  if (hMapping == nullptr) {
+    close();
+
+    return false;
+  }
+
+  data = (uint8_t *)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+  size = fileSize.QuadPart;
+#else
+  struct stat s;
+  int fd = ::open(path.c_str(), O_RDONLY);
+  void *ptr;
+
+  if (fd < 0) {
+    return false;
+  }
+
+  if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode) || s.st_size == 0) {
+    ::close(fd);
+
+    return false;
+  }
+
+  ptr = mmap(nullptr, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // Mapping stays valid after closing descriptor
+  ::close(fd);
+
+  if (ptr == MAP_FAILED) {
+    return false;
+  }
+
+  // Whole file is read front to back
+  madvise(ptr, s.st_size, MADV_SEQUENTIAL);
+
+  data = (uint8_t *)ptr;
+  size = s.st_size;
+#endif
+
+  if (data == nullptr) {
+    close();
+
+    return false;
+  }
+
+  setg((char *)data, (char *)data, (char *)data + size);
+
+  return true;
+}
+
+void MappedFile::close() {
+  setg(nullptr, nullptr, nullptr);
+
+#ifdef _MSC_VER
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (hMapping) {
+    CloseHandle(hMapping);
+  }
+  if (hFile != INVALID_HANDLE_VALUE) {
+    CloseHandle(hFile);
+  }
+
+  hFile = INVALID_HANDLE_VALUE;
+  hMapping = nullptr;
+#else
+  if (data) {
+    munmap(data, size);
+  }
+#endif
+
+  data = nullptr;
+  size = 0;
+}
+
+bool MappedFile::isOpen() {
+  return data != nullptr;
+}
+
+uint64_t MappedFile::getSize() {
+  return size;
+}
+
+}  // namespace SimpleSSD
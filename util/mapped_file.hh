@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __UTIL_MAPPED_FILE__
+#define __UTIL_MAPPED_FILE__
+
+#include <cinttypes>
+#include <streambuf>
+#include <string>
+
+namespace SimpleSSD {
+
+/**
+ * \brief Read-only memory mapped file
+ *
+ * Maps whole file at open and exposes it as std::streambuf, so StateObject
+ * can read from it with std::istream without copying file into buffer
+ * first. Pages are loaded by OS as they are read.
+ */
+class MappedFile : public std::streambuf {
+ private:
+  uint8_t *data;
+  uint64_t size;
+
+#ifdef _MSC_VER
+  void *hFile;
+  void *hMapping;
+#endif
+
+ public:
+  MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  ~MappedFile();
+
+  bool open(std::string);
+  void close();
+
+  bool isOpen();
+  uint64_t getSize();
+};
+
+}  // namespace SimpleSSD
+
+#endif
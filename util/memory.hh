@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __UTIL_MEMORY__
+#define __UTIL_MEMORY__
+
+#include <cinttypes>
+#include <deque>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace SimpleSSD {
+
+/*
+ * Estimates of heap usage, used by StatObject::getMemoryUsage. Node layouts
+ * follow libstdc++ on 64-bit host, and allocation overhead follows glibc
+ * malloc. These do not walk containers, so they are cheap enough to be
+ * sampled periodically.
+ */
+
+//! Size of heap chunk for allocation of given size (8 bytes header, 16 bytes
+//! aligned, 32 bytes minimum)
+inline uint64_t allocationSize(uint64_t size) {
+  if (size == 0) {
+    return 0;
+  }
+
+  size = (size + sizeof(uint64_t) + 15) & ~(uint64_t)15;
+
+  return size < 32 ? 32 : size;
+}
+
+template <class T>
+inline uint64_t memoryUsage(const std::vector<T> &v) {
+  return allocationSize(v.capacity() * sizeof(T));
+}
+
+template <class T>
+inline uint64_t memoryUsage(const std::list<T> &l) {
+  // Doubly linked node
+  return l.size() * allocationSize(sizeof(T) + 2 * sizeof(void *));
+}
+
+template <class T>
+inline uint64_t memoryUsage(const std::deque<T> &d) {
+  // 512 bytes chunks and map of chunk pointers
+  const uint64_t perChunk = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+  const uint64_t chunks = d.size() / perChunk + 1;
+
+  return chunks * allocationSize(perChunk * sizeof(T)) +
+         allocationSize((chunks + 2) * sizeof(void *));
+}
+
+template <class K, class V, class C, class A>
+inline uint64_t memoryUsage(const std::map<K, V, C, A> &m) {
+  // Red-black tree node: color and three pointers
+  return m.size() *
+         allocationSize(sizeof(typename std::map<K, V, C, A>::value_type) +
+                        4 * sizeof(void *));
+}
+
+template <class K, class V, class H, class E, class A>
+inline uint64_t memoryUsage(const std::unordered_map<K, V, H, E, A> &m) {
+  // Bucket array and singly linked node
+  return allocationSize(m.bucket_count() * sizeof(void *)) +
+         m.size() * allocationSize(
+                        sizeof(typename std::unordered_map<K, V, H, E,
+                                                           A>::value_type) +
+                        sizeof(void *));
+}
+
+}  // namespace SimpleSSD
+
+#endif
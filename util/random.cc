@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/random.hh"
+
+#include "sim/context.hh"
+
+namespace SimpleSSD {
+
+static inline uint64_t rotl(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+Random::Random(uint64_t seed) {
+  this->seed(seed);
+}
+
+void Random::seed(uint64_t seed) {
+  // splitmix64, never gives all zero state
+  for (int i = 0; i < 4; i++) {
+    uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    s[i] = z ^ (z >> 31);
+  }
+}
+
+uint64_t Random::operator()() {
+  uint64_t result = rotl(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+
+  return result;
+}
+
+uint64_t Random::next(uint64_t bound) {
+  // Reject values below 2^64 % bound to remove modulo bias
+  uint64_t threshold = (0 - bound) % bound;
+  uint64_t r;
+
+  do {
+    r = (*this)();
+  } while (r < threshold);
+
+  return r % bound;
+}
+
+void Random::jump() {
+  static const uint64_t JUMP[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                  0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+  uint64_t t[4] = {0, 0, 0, 0};
+
+  for (int i = 0; i < 4; i++) {
+    for (int b = 0; b < 64; b++) {
+      if (JUMP[i] & (1ull << b)) {
+        t[0] ^= s[0];
+        t[1] ^= s[1];
+        t[2] ^= s[2];
+        t[3] ^= s[3];
+      }
+
+      (*this)();
+    }
+  }
+
+  s[0] = t[0];
+  s[1] = t[1];
+  s[2] = t[2];
+  s[3] = t[3];
+}
+
+void initRandom(uint64_t seed) {
+  getContext()->randomSeed = seed;
+}
+
+Random getRandomStream(RANDOM_STREAM stream) {
+  Random gen(getContext()->randomSeed);
+
+  // Stream n starts (n + 1) * 2^128 steps after the seed
+  for (uint32_t i = 0; i <= stream; i++) {
+    gen.jump();
+  }
+
+  return gen;
+}
+
+}  // namespace SimpleSSD
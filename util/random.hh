@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __UTIL_RANDOM__
+#define __UTIL_RANDOM__
+
+#include <cinttypes>
+#include <limits>
+
+namespace SimpleSSD {
+
+/**
+ * \brief Random number streams of simulation engine
+ *
+ * Each component draws from its own stream, so adding draws in one component
+ * does not change random numbers of others.
+ */
+typedef enum : uint32_t {
+  RANDOM_FTL_FILL,   //!< Initial filling of FTL
+  RANDOM_FTL_GC,     //!< GC victim sampling of FTL
+  RANDOM_ICL_CACHE,  //!< Random eviction of cache
+} RANDOM_STREAM;
+
+/**
+ * \brief xoshiro256** pseudo random number generator
+ *
+ * Small and fast generator for simulation internals. State is four 64bit
+ * words seeded by splitmix64, and the object is trivially copyable, so it can
+ * be saved to checkpoint with StateObject::pushValue. Satisfies
+ * UniformRandomBitGenerator, so it works with std distributions.
+ */
+class Random {
+ private:
+  uint64_t s[4];
+
+ public:
+  typedef uint64_t result_type;
+
+  Random(uint64_t = 0);
+
+  void seed(uint64_t);
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  uint64_t operator()();
+
+  //! Returns uniform integer in [0, bound), bound should not be zero
+  uint64_t next(uint64_t);
+
+  //! Advance 2^128 steps, to make non-overlapping sequence
+  void jump();
+};
+
+void initRandom(uint64_t);
+
+//! Returns generator of given stream, seeded by initRandom() of this context
+Random getRandomStream(RANDOM_STREAM);
+
+}  // namespace SimpleSSD
+
+#endif
@@ -20,6 +20,9 @@
 #include "util/simplessd.hh"
 
 #include "sim/log.hh"
+#include "sim/profile.hh"
+#include "sim/request_trace.hh"
+#include "util/random.hh"
 
 using namespace SimpleSSD;
 
@@ -35,6 +38,27 @@ ConfigReader initSimpleSSDEngine(Simulator *sim, std::ostream *info,
   }
 
   initCPU(conf);
+  initRandom(conf.readUint(CONFIG_SIM, SIM_RANDOM_SEED));
+
+  return conf;
+}
+
+ConfigReader initSimpleSSDEngine(Context *ctx, Simulator *sim,
+                                 std::ostream *info, std::ostream *err,
+                                 std::string config,
+                                 const std::vector<ConfigOverride> &list) {
+  ConfigReader conf;
+
+  setContext(ctx);
+  setSimulator(sim);
+  initLogSystem(info, err);
+
+  if (!conf.init(config, list)) {
+    panic("Failed to open configuration file %s", config.c_str());
+  }
+
+  initCPU(conf);
+  initRandom(conf.readUint(CONFIG_SIM, SIM_RANDOM_SEED));
 
   return conf;
 }
@@ -43,4 +67,7 @@ void releaseSimpleSSDEngine() {
   printCPULastStat();
 
   deInitCPU();
+  destroyProfiler();
+  destroyRequestTrace();
+  destroyLogSystem();
 }
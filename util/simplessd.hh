@@ -23,14 +23,21 @@
 #define __UTIL_SIMPLESSD__
 
 #include "sim/config_reader.hh"
+#include "sim/context.hh"
 #include "sim/cpu.hh"
 #include "sim/simulator.hh"
+#include "sim/state.hh"
 #include "sim/statistics.hh"
 #include "sim/trace.hh"
 
 SimpleSSD::ConfigReader initSimpleSSDEngine(SimpleSSD::Simulator *,
                                             std::ostream *, std::ostream *,
                                             std::string);
+SimpleSSD::ConfigReader initSimpleSSDEngine(
+    SimpleSSD::Context *, SimpleSSD::Simulator *, std::ostream *,
+    std::ostream *, std::string,
+    const std::vector<SimpleSSD::ConfigOverride> & =
+        std::vector<SimpleSSD::ConfigOverride>());
 void releaseSimpleSSDEngine();
 
 #endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/thread_pool.hh"
+
+namespace SimpleSSD {
+
+ThreadPool::ThreadPool(uint32_t count)
+    : queued(0), pending(0), next(0), stopping(false) {
+  if (count == 0) {
+    count = std::thread::hardware_concurrency();
+  }
+  if (count == 0) {
+    count = 1;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    queues.push_back(new WorkQueue());
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    workers.emplace_back([this, i]() { work(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+
+    stopping = true;
+  }
+
+  taskReady.notify_all();
+
+  for (auto &iter : workers) {
+    iter.join();
+  }
+
+  for (auto &iter : queues) {
+    delete iter;
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  WorkQueue *target;
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+
+    target = queues[next];
+    next = (next + 1) % queues.size();
+
+    // Take per-queue lock while holding pool lock, so worker woken up below
+    // always sees the task
+    std::lock_guard<std::mutex> queueGuard(target->lock);
+
+    target->queue.push_back(std::move(task));
+    queued++;
+    pending++;
+  }
+
+  taskReady.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> guard(lock);
+
+  allDone.wait(guard, [this]() { return pending == 0; });
+}
+
+uint32_t ThreadPool::getThreadCount() {
+  return (uint32_t)workers.size();
+}
+
+bool ThreadPool::take(uint32_t id, Task &task) {
+  uint32_t count = (uint32_t)queues.size();
+
+  // Own queue first (LIFO), then steal from others (FIFO)
+  for (uint32_t i = 0; i < count; i++) {
+    WorkQueue *queue = queues[(id + i) % count];
+    std::lock_guard<std::mutex> guard(queue->lock);
+
+    if (queue->queue.size() > 0) {
+      if (i == 0) {
+        task = std::move(queue->queue.back());
+        queue->queue.pop_back();
+      }
+      else {
+        task = std::move(queue->queue.front());
+        queue->queue.pop_front();
+      }
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::work(uint32_t id) {
+  Task task;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+
+      taskReady.wait(guard, [this]() { return stopping || queued > 0; });
+
+      if (queued == 0) {
+        // Stopping and nothing left
+        break;
+      }
+
+      queued--;
+    }
+
+    // One task is reserved for this worker, so take() always succeeds
+    while (!take(id, task)) {
+      std::this_thread::yield();
+    }
+
+    task();
+    task = nullptr;
+
+    {
+      std::lock_guard<std::mutex> guard(lock);
+
+      pending--;
+
+      if (pending == 0) {
+        allDone.notify_all();
+      }
+    }
+  }
+}
+
+}  // namespace SimpleSSD
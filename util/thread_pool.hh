@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2017 CAMELab
+ *
+ * This file is part of SimpleSSD.
+ *
+ * SimpleSSD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimpleSSD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimpleSSD.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __UTIL_THREAD_POOL__
+#define __UTIL_THREAD_POOL__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SimpleSSD {
+
+/**
+ * \brief Work stealing thread pool
+ *
+ * Each worker owns a task deque. Tasks are distributed to workers in round
+ * robin order. A worker takes tasks from back of its own deque, and steals
+ * from front of other deques when its own deque is empty, so long tasks
+ * landing on one worker do not leave other workers idle.
+ *
+ * Tasks are expected to be coarse grained (one simulation each), so each
+ * deque is protected by a mutex instead of lock-free structure.
+ */
+class ThreadPool {
+ private:
+  typedef std::function<void()> Task;
+
+  typedef struct {
+    std::mutex lock;
+    std::deque<Task> queue;
+  } WorkQueue;
+
+  std::vector<std::thread> workers;
+  std::vector<WorkQueue *> queues;
+
+  std::mutex lock;
+  std::condition_variable taskReady;
+  std::condition_variable allDone;
+
+  uint64_t queued;   //!< Tasks not yet taken by worker
+  uint64_t pending;  //!< Tasks not yet finished
+  uint32_t next;
+  bool stopping;
+
+  bool take(uint32_t, Task &);
+  void work(uint32_t);
+
+ public:
+  ThreadPool(uint32_t = 0);
+  ~ThreadPool();
+
+  void submit(Task);
+  void wait();
+
+  uint32_t getThreadCount();
+};
+
+}  // namespace SimpleSSD
+
+#endif